@@ -0,0 +1,100 @@
+#include "app/cube_timer.hpp"
+
+#include "diag/trace.hpp"
+#include "power/timebase.hpp"
+
+namespace tilt {
+
+void CubeTimer::start(uint32_t duration_ms) {
+    cancel();
+    duration_ms_ = duration_ms;
+    // Every span goes through the timebase, so a countdown runs on real
+    // seconds however far the ROSC that drives the timer is off.
+    deadline_ = make_timeout_time_us(timebase::ticks_from_us(uint64_t{duration_ms} * 1000));
+    second_ticks_ = static_cast<int64_t>(timebase::ticks_from_us(1'000'000));
+    // The first alarm lands on the first whole-second boundary of the
+    // remaining time; the callback then reschedules itself every second
+    // relative to its previous target, so ticks never accumulate drift.
+    const uint32_t first_ms = duration_ms % 1000 != 0 ? duration_ms % 1000 : 1000;
+    ticks_left_ = (duration_ms + 999) / 1000;
+    fired_ = false;
+    tick_pending_ = true;
+    state_ = State::kRunning;
+    alarm_ = add_alarm_in_us(timebase::ticks_from_us(uint64_t{first_ms} * 1000),
+                             &CubeTimer::alarm_callback, this, true);
+    notify();
+}
+
+void CubeTimer::cancel() {
+    if (alarm_ > 0) {
+        cancel_alarm(alarm_);
+        alarm_ = 0;
+    }
+    fired_ = false;
+    tick_pending_ = false;
+    state_ = State::kIdle;
+}
+
+void CubeTimer::pause() {
+    if (state_ != State::kRunning) {
+        return;
+    }
+    const uint32_t left = remaining_ms();
+    cancel();
+    paused_ms_ = left;
+    state_ = State::kPaused;
+}
+
+void CubeTimer::resume() {
+    if (state_ != State::kPaused) {
+        return;
+    }
+    const uint32_t duration = duration_ms_;
+    start(paused_ms_);
+    duration_ms_ = duration;
+}
+
+CubeTimer::Event CubeTimer::poll() {
+    if (state_ != State::kRunning) {
+        return Event::kNone;
+    }
+    if (fired_) {
+        alarm_ = 0;
+        tick_pending_ = false;
+        state_ = State::kExpired;
+        return Event::kExpired;
+    }
+    if (tick_pending_) {
+        tick_pending_ = false;
+        return Event::kTick;
+    }
+    return Event::kNone;
+}
+
+uint32_t CubeTimer::remaining_ms() const {
+    if (state_ == State::kPaused) {
+        return paused_ms_;
+    }
+    if (state_ != State::kRunning) {
+        return 0;
+    }
+    const int64_t left = absolute_time_diff_us(get_absolute_time(), deadline_);
+    return left > 0 ? static_cast<uint32_t>(timebase::us_from_ticks(left) / 1000) : 0;
+}
+
+int64_t CubeTimer::alarm_callback(alarm_id_t, void* ctx) {
+    auto* self = static_cast<CubeTimer*>(ctx);
+    const uint32_t left = self->ticks_left_ - 1;
+    self->ticks_left_ = left;
+    trace::record(trace::Event::kIsrCountdown, static_cast<uint16_t>(left));
+    if (left == 0) {
+        self->fired_ = true;
+        self->notify();
+        return 0;
+    }
+    self->tick_pending_ = true;
+    self->notify();
+    return self->second_ticks_;
+}
+
+}  // namespace tilt
@@ -0,0 +1,65 @@
+// Countdown state machine driven by the RP2040 hardware alarm.
+#pragma once
+
+#include <cstdint>
+
+#include "hardware/timer.h"
+
+namespace tilt {
+
+class CubeTimer {
+public:
+    enum class State : uint8_t { kIdle, kRunning, kPaused, kExpired };
+    enum class Event : uint8_t { kNone, kTick, kExpired };
+    /// Called, from the alarm IRQ or start(), whenever poll() has an event.
+    using Notify = void (*)(void* ctx);
+
+    void set_notify(Notify fn, void* ctx) {
+        notify_ctx_ = ctx;
+        notify_fn_ = fn;
+    }
+
+    /// Starts (or restarts) a countdown of `duration_ms`. An immediate kTick
+    /// is reported so the display can draw the starting value.
+    void start(uint32_t duration_ms);
+    void cancel();
+    /// Freezes a running countdown; resume() continues from the same
+    /// remaining time with an immediate kTick, as start() does.
+    void pause();
+    void resume();
+
+    /// Advances the state machine from thread context. Reports kTick each time
+    /// the remaining whole seconds change and kExpired once at the end.
+    Event poll();
+
+    /// True if poll() has an event to report; safe to call with IRQs masked.
+    bool pending() const { return state_ == State::kRunning && (fired_ || tick_pending_); }
+
+    State state() const { return state_; }
+    uint32_t duration_ms() const { return duration_ms_; }
+    uint32_t remaining_ms() const;
+    /// Remaining time rounded up, as a countdown display shows it.
+    uint32_t remaining_s() const { return (remaining_ms() + 999) / 1000; }
+
+private:
+    static int64_t alarm_callback(alarm_id_t id, void* ctx);
+    void notify() const {
+        if (notify_fn_ != nullptr) {
+            notify_fn_(notify_ctx_);
+        }
+    }
+
+    State state_ = State::kIdle;
+    uint32_t duration_ms_ = 0;
+    uint32_t paused_ms_ = 0;
+    absolute_time_t deadline_{};
+    int64_t second_ticks_ = 1'000'000;
+    alarm_id_t alarm_ = 0;
+    volatile uint32_t ticks_left_ = 0;
+    volatile bool tick_pending_ = false;
+    volatile bool fired_ = false;
+    Notify notify_fn_ = nullptr;
+    void* notify_ctx_ = nullptr;
+};
+
+}  // namespace tilt
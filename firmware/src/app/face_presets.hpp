@@ -0,0 +1,22 @@
+// Default face-to-duration mapping, baked into the built-in config blob.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "orientation/face.hpp"
+
+namespace tilt {
+
+/// Countdown length for each resting face; 0 marks the idle face that
+/// stops the timer. +Z up is the display-up "parked" position.
+inline constexpr std::array<uint32_t, kFaceCount> kFaceDurationsMs = {
+    5 * 60'000,   // +X
+    10 * 60'000,  // -X
+    15 * 60'000,  // +Y
+    25 * 60'000,  // -Y
+    0,            // +Z
+    45 * 60'000,  // -Z
+};
+
+}  // namespace tilt
@@ -0,0 +1,47 @@
+#include "app/session_tracker.hpp"
+
+#include "power/timebase.hpp"
+
+namespace tilt {
+
+void SessionTracker::begin(Face face, uint32_t planned_ms, uint16_t battery_mv, bool in_motion) {
+    started_ = get_absolute_time();
+    draft_ = SessionRecord{};
+    draft_.start_s =
+        static_cast<uint32_t>(timebase::us_from_ticks(to_us_since_boot(started_)) / 1'000'000);
+    draft_.planned_ms = planned_ms;
+    draft_.battery_mv = battery_mv;
+    draft_.face = static_cast<uint8_t>(face);
+    active_ = true;
+    moving_ = in_motion;
+    lifted_ = false;
+}
+
+void SessionTracker::note_motion(bool in_motion) {
+    if (!active_ || in_motion == moving_) {
+        return;
+    }
+    moving_ = in_motion;
+    if (in_motion) {
+        lifted_ = true;
+    } else if (lifted_) {
+        lifted_ = false;
+        if (draft_.interruptions != 0xFF) {
+            ++draft_.interruptions;
+        }
+    }
+}
+
+bool SessionTracker::end(SessionOutcome outcome, SessionRecord& out) {
+    if (!active_) {
+        return false;
+    }
+    active_ = false;
+    const int64_t elapsed = absolute_time_diff_us(started_, get_absolute_time());
+    draft_.actual_ms = static_cast<uint32_t>(timebase::us_from_ticks(elapsed) / 1000);
+    draft_.outcome = outcome;
+    out = draft_;
+    return true;
+}
+
+}  // namespace tilt
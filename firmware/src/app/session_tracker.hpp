@@ -0,0 +1,35 @@
+// Builds a SessionRecord over the life of one countdown.
+#pragma once
+
+#include <cstdint>
+
+#include "orientation/face.hpp"
+#include "pico/time.h"
+#include "storage/session_record.hpp"
+
+namespace tilt {
+
+/// Core 0 only. An interruption is a pick-up that settles again without
+/// ending the session; the motion that starts or ends a session (the flip
+/// itself) is not counted.
+class SessionTracker {
+public:
+    void begin(Face face, uint32_t planned_ms, uint16_t battery_mv, bool in_motion);
+
+    /// Feed the current motion state; cheap enough to call every loop.
+    void note_motion(bool in_motion);
+
+    /// Closes the session into `out`. Returns false if none was open.
+    bool end(SessionOutcome outcome, SessionRecord& out);
+
+    bool active() const { return active_; }
+
+private:
+    SessionRecord draft_{};
+    absolute_time_t started_{};
+    bool active_ = false;
+    bool moving_ = false;
+    bool lifted_ = false;
+};
+
+}  // namespace tilt
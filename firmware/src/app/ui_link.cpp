@@ -0,0 +1,33 @@
+#include "app/ui_link.hpp"
+
+#include "hardware/sync.h"
+#include "pico/multicore.h"
+
+namespace tilt {
+
+namespace {
+constexpr uint32_t kDoorbell = 0x55494C4B;  // "UILK"
+}  // namespace
+
+bool UiLink::post(const UiEvent& event) {
+    if (!ring_.push(event)) {
+        ++dropped_;
+        return false;
+    }
+    // The FIFO write raises an event on core 1 and wakes it from WFE.
+    if (multicore_fifo_wready()) {
+        multicore_fifo_push_blocking(kDoorbell);
+    }
+    return true;
+}
+
+void UiLink::wait() {
+    multicore_fifo_drain();
+    // The event register latches any SEV that lands between this check and
+    // the WFE, so a doorbell can never be lost.
+    if (ring_.empty()) {
+        __wfe();
+    }
+}
+
+}  // namespace tilt
@@ -0,0 +1,64 @@
+// Core 0 -> core 1 message channel for the UI pipeline.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "orientation/face.hpp"
+#include "power/power_governor.hpp"
+#include "util/spsc_ring.hpp"
+
+namespace tilt {
+
+/// UI state snapshot. Each event carries absolute values, so the renderer
+/// may coalesce a backlog and a dropped tick only costs a skipped frame.
+struct UiEvent {
+    enum class Kind : uint8_t {
+        kIdle,      // no countdown running
+        kStarted,   // a face change started a countdown
+        kRunning,   // countdown ticked
+        kExpired,   // countdown reached zero
+        kPaused,    // a double tap froze the countdown
+        kPower,     // the battery governor changed level; no state change
+    };
+
+    Kind kind;
+    Face face;
+    uint32_t remaining_s;
+    PowerLevel power = PowerLevel::kFull;  // kPower only
+};
+
+/// SPSC ring plus an SIO-FIFO doorbell. The producer (core 0) never blocks:
+/// if the FIFO is full a doorbell is already pending, so it is skipped.
+class UiLink {
+public:
+    static constexpr unsigned kDepth = 16;
+
+    /// Core 0. Returns false if core 1 is kDepth events behind.
+    bool post(const UiEvent& event);
+
+    /// Core 1.
+    bool receive(UiEvent& event) { return ring_.pop(event); }
+
+    /// Core 1: sleeps until a doorbell (or any SEV) arrives, unless events
+    /// are already queued.
+    void wait();
+
+    /// Core 1: everything received so far is drawn and pushed to the panel.
+    void mark_settled() { settled_.store(ring_.consumed(), std::memory_order_release); }
+
+    /// Core 0: true once core 1 has marked every posted event settled, i.e.
+    /// it is about to sleep and will not touch the bus or clk_sys-bound work.
+    bool settled() const {
+        return settled_.load(std::memory_order_acquire) == ring_.produced();
+    }
+
+    uint32_t dropped() const { return dropped_; }
+
+private:
+    SpscRing<UiEvent, kDepth> ring_;
+    std::atomic<uint32_t> settled_{0};
+    uint32_t dropped_ = 0;
+};
+
+}  // namespace tilt
@@ -0,0 +1,27 @@
+// Built-in buzzer patterns.
+#pragma once
+
+#include "audio/melody.hpp"
+
+namespace tilt::melodies {
+
+namespace detail {
+
+inline constexpr Note kStartNotes[] = {{2000, 40}, {0, 30}, {2600, 60}};
+inline constexpr Note kCancelNotes[] = {{2600, 40}, {0, 30}, {2000, 60}};
+inline constexpr Note kAlarmNotes[] = {
+    {2700, 120}, {0, 80}, {2700, 120}, {0, 80}, {2700, 120}, {0, 480},
+    {2700, 120}, {0, 80}, {2700, 120}, {0, 80}, {2700, 120}, {0, 480},
+};
+
+inline constexpr auto kStartWords = compile_melody(kStartNotes);
+inline constexpr auto kCancelWords = compile_melody(kCancelNotes);
+inline constexpr auto kAlarmWords = compile_melody(kAlarmNotes);
+
+}  // namespace detail
+
+inline constexpr Melody kStart = make_melody(detail::kStartWords);
+inline constexpr Melody kCancel = make_melody(detail::kCancelWords);
+inline constexpr Melody kAlarm = make_melody(detail::kAlarmWords);
+
+}  // namespace tilt::melodies
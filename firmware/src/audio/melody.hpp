@@ -0,0 +1,53 @@
+// Notes compiled at build time into the word stream the tone PIO program eats.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tilt {
+
+/// State-machine clock the tables are compiled for; PioBuzzer derives its
+/// clock divider from this.
+inline constexpr uint32_t kToneSmHz = 1'000'000;
+
+struct Note {
+    uint16_t hz;  // 0 = rest
+    uint16_t ms;
+};
+
+/// A compiled melody: three FIFO words per note, stored in flash.
+struct Melody {
+    const uint32_t* words;
+    uint32_t word_count;
+};
+
+/// Inverse of the program's period of 2x + 7 cycles.
+constexpr uint32_t tone_half_period(uint32_t hz) {
+    return (kToneSmHz / hz - 7) / 2;
+}
+
+template <size_t N>
+constexpr std::array<uint32_t, 3 * N> compile_melody(const Note (&notes)[N]) {
+    // Rests still run the loop (with the pin held low) at a 1 kHz period.
+    constexpr uint32_t kRestHz = 1000;
+    std::array<uint32_t, 3 * N> words{};
+    for (size_t i = 0; i < N; ++i) {
+        const uint32_t hz = notes[i].hz != 0 ? notes[i].hz : kRestHz;
+        uint32_t periods = hz * notes[i].ms / 1000;
+        if (periods == 0) {
+            periods = 1;
+        }
+        words[3 * i + 0] = tone_half_period(hz);
+        words[3 * i + 1] = periods - 1;
+        words[3 * i + 2] = notes[i].hz != 0 ? 1u : 0u;
+    }
+    return words;
+}
+
+template <size_t N>
+constexpr Melody make_melody(const std::array<uint32_t, N>& words) {
+    return Melody{words.data(), static_cast<uint32_t>(N)};
+}
+
+}  // namespace tilt
@@ -0,0 +1,121 @@
+#include "audio/pio_buzzer.hpp"
+
+#include "audio/tone.pio.h"
+#include "diag/trace.hpp"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+namespace tilt {
+
+PioBuzzer* PioBuzzer::instance_ = nullptr;
+
+bool PioBuzzer::init() {
+    if (!pio_can_add_program(pio_, &tone_program)) {
+        return false;
+    }
+    const int sm = pio_claim_unused_sm(pio_, false);
+    const int chan = dma_claim_unused_channel(false);
+    if (sm < 0 || chan < 0) {
+        return false;
+    }
+    sm_ = static_cast<unsigned>(sm);
+    dma_chan_ = static_cast<unsigned>(chan);
+    offset_ = pio_add_program(pio_, &tone_program);
+
+    const float clkdiv = static_cast<float>(clock_get_hz(clk_sys)) / kToneSmHz;
+    tone_program_init(pio_, sm_, offset_, pin_, clkdiv);
+    pio_sm_set_enabled(pio_, sm_, true);
+
+    instance_ = this;
+    dma_channel_set_irq1_enabled(dma_chan_, true);
+    irq_add_shared_handler(DMA_IRQ_1, &PioBuzzer::dma_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    return true;
+}
+
+bool PioBuzzer::play(const Melody& melody) {
+    if (melody.word_count == 0) {
+        return false;
+    }
+    const uint32_t irq = save_and_disable_interrupts();
+    if (count_ == kQueueDepth) {
+        restore_interrupts(irq);
+        return false;
+    }
+    queue_[(head_ + count_) % kQueueDepth] = melody;
+    count_ = count_ + 1;
+    if (!streaming_) {
+        start(queue_[head_]);
+    }
+    restore_interrupts(irq);
+    return true;
+}
+
+void PioBuzzer::stop() {
+    const uint32_t irq = save_and_disable_interrupts();
+    count_ = 0;
+    streaming_ = false;
+    dma_channel_abort(dma_chan_);
+    dma_channel_acknowledge_irq1(dma_chan_);
+    pio_sm_set_enabled(pio_, sm_, false);
+    pio_sm_clear_fifos(pio_, sm_);
+    pio_sm_restart(pio_, sm_);
+    pio_sm_exec(pio_, sm_, pio_encode_mov(pio_pins, pio_null));
+    pio_sm_exec(pio_, sm_, pio_encode_jmp(offset_));
+    pio_sm_set_enabled(pio_, sm_, true);
+    restore_interrupts(irq);
+}
+
+void PioBuzzer::set_volume(uint8_t step) {
+    constexpr uint8_t kMaxStep = GPIO_DRIVE_STRENGTH_12MA;
+    const uint8_t clamped = step < kMaxStep ? step : kMaxStep;
+    gpio_set_drive_strength(pin_, static_cast<gpio_drive_strength>(clamped));
+}
+
+bool PioBuzzer::active() const {
+    if (streaming_ || !pio_sm_is_tx_fifo_empty(pio_, sm_)) {
+        return true;
+    }
+    // FIFO drained: still busy until the SM has finished the last note and
+    // stalled on the next PULL.
+    return !(pio_->fdebug & (1u << (PIO_FDEBUG_TXSTALL_LSB + sm_)));
+}
+
+void PioBuzzer::start(const Melody& melody) {
+    trace::record(trace::Event::kToneStart, static_cast<uint16_t>(melody.word_count));
+    streaming_ = true;
+    dma_channel_config c = dma_channel_get_default_config(dma_chan_);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio_, sm_, true));
+    dma_channel_configure(dma_chan_, &c, &pio_->txf[sm_], melody.words, melody.word_count, true);
+    // The SM was stalled on PULL; the DMA refills the FIFO within a few
+    // cycles, so a stall reported after this point means the melody ended.
+    pio_->fdebug = 1u << (PIO_FDEBUG_TXSTALL_LSB + sm_);
+}
+
+void PioBuzzer::on_dma_done() {
+    head_ = static_cast<uint8_t>((head_ + 1) % kQueueDepth);
+    count_ = count_ - 1;
+    if (count_ > 0) {
+        start(queue_[head_]);
+    } else {
+        streaming_ = false;
+    }
+}
+
+void PioBuzzer::dma_irq_handler() {
+    trace::record(trace::Event::kIsrDma1);
+    PioBuzzer* self = instance_;
+    if (self != nullptr && dma_channel_get_irq1_status(self->dma_chan_)) {
+        dma_channel_acknowledge_irq1(self->dma_chan_);
+        self->on_dma_done();
+    }
+}
+
+}  // namespace tilt
@@ -0,0 +1,61 @@
+// BZ1 melody engine: PIO tone generator fed by DMA from flash.
+#pragma once
+
+#include <cstdint>
+
+#include "audio/melody.hpp"
+#include "hardware/pio.h"
+
+namespace tilt {
+
+/// Plays compiled melodies with no CPU involvement between notes.
+///
+/// A DMA channel streams a melody's words from flash into the tone state
+/// machine's joined 8-deep TX FIFO, paced by its DREQ. The CPU only runs at
+/// melody boundaries, when the DMA completion IRQ starts the next queued
+/// melody. PIO runs from clk_sys, so pitch is only exact while clk_sys is
+/// undivided; the power policy keeps the divider at 1 while active().
+class PioBuzzer {
+public:
+    static constexpr unsigned kQueueDepth = 4;
+
+    PioBuzzer(PIO pio, unsigned pin) : pio_(pio), pin_(pin) {}
+
+    /// Loads the program, claims a state machine and a DMA channel, and
+    /// installs the completion handler on the calling core.
+    [[nodiscard]] bool init();
+
+    /// Queues `melody` behind whatever is playing. Returns false if full.
+    bool play(const Melody& melody);
+
+    /// Drops the queue and silences the pin immediately.
+    void stop();
+
+    /// Pad drive step 0..3 (2, 4, 8, 12 mA; 1 is the reset default). BZ1
+    /// hangs off 220R, which would draw ~15 mA, so the pad's drive limit
+    /// sets the swing and with it the loudness. Thread context only.
+    void set_volume(uint8_t step);
+
+    /// True until the last note of the last queued melody has finished.
+    bool active() const;
+
+private:
+    static void dma_irq_handler();
+    void start(const Melody& melody);
+    void on_dma_done();
+
+    PIO pio_;
+    unsigned pin_;
+    unsigned sm_ = 0;
+    unsigned offset_ = 0;
+    unsigned dma_chan_ = 0;
+
+    Melody queue_[kQueueDepth] = {};
+    volatile uint8_t head_ = 0;
+    volatile uint8_t count_ = 0;
+    volatile bool streaming_ = false;
+
+    static PioBuzzer* instance_;
+};
+
+}  // namespace tilt
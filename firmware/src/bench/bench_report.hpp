@@ -0,0 +1,61 @@
+// Per-benchmark cycle statistics and their key=value report lines.
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include "bench/cycle_counter.hpp"
+
+namespace tilt::bench {
+
+/// Collects one benchmark's timed intervals. Each interval may cover
+/// several operations (a batch of samples, a run of blits); min and max
+/// are per operation within an interval, the mean is over all of them.
+class Stat {
+public:
+    void add(uint32_t cycles, uint32_t ops = 1) {
+        total_ += cycles;
+        ops_ += ops;
+        const uint32_t per_op = cycles / ops;
+        if (per_op < min_) {
+            min_ = per_op;
+        }
+        if (per_op > max_) {
+            max_ = per_op;
+        }
+    }
+
+    uint32_t ops() const { return ops_; }
+    uint64_t total() const { return total_; }
+    uint32_t min() const { return ops_ != 0 ? min_ : 0; }
+    uint32_t max() const { return max_; }
+    /// Mean cycles per operation, x100.
+    uint32_t mean_x100() const {
+        return ops_ != 0 ? static_cast<uint32_t>(total_ * 100 / ops_) : 0;
+    }
+
+private:
+    uint64_t total_ = 0;
+    uint32_t ops_ = 0;
+    uint32_t min_ = CycleCounter::kMask;
+    uint32_t max_ = 0;
+};
+
+/// Prints `bench=<name> unit=<op> n=.. mean=.. min=.. max=..`, all in
+/// clk_sys cycles per `unit`, then `extra` (may be empty) and a newline.
+/// tools/bench_check.py keys on bench and compares mean.
+inline void print_result(const char* name, const char* unit, const Stat& stat,
+                         const char* extra = "") {
+    const uint32_t mean = stat.mean_x100();
+    printf("bench=%s unit=%s n=%lu mean=%lu.%02lu min=%lu max=%lu%s%s\n", name, unit,
+           static_cast<unsigned long>(stat.ops()), static_cast<unsigned long>(mean / 100),
+           static_cast<unsigned long>(mean % 100), static_cast<unsigned long>(stat.min()),
+           static_cast<unsigned long>(stat.max()), extra[0] != '\0' ? " " : "", extra);
+}
+
+/// For benchmarks that need hardware which did not answer.
+inline void print_skipped(const char* name, const char* reason) {
+    printf("bench=%s status=skipped reason=%s\n", name, reason);
+}
+
+}  // namespace tilt::bench
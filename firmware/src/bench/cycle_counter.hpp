@@ -0,0 +1,43 @@
+// SysTick-based cycle counter for on-target measurements.
+#pragma once
+
+#include <cstdint>
+
+#include "hardware/structs/systick.h"
+
+namespace tilt::bench {
+
+/// The M0+ has no DWT cycle counter, so SysTick runs free on the processor
+/// clock as a 24-bit down-counter. Intervals must stay below 2^24 cycles
+/// (~2.5 s on the 6.5 MHz ROSC); longer work is measured in slices.
+class CycleCounter {
+public:
+    static constexpr uint32_t kMask = 0x00FF'FFFF;
+
+    static void start() {
+        systick_hw->csr = 0;
+        systick_hw->rvr = kMask;
+        systick_hw->cvr = 0;
+        systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+    }
+
+    static uint32_t now() { return systick_hw->cvr; }
+
+    /// Cycles from `then` to now, modulo 2^24.
+    static uint32_t since(uint32_t then) { return (then - now()) & kMask; }
+};
+
+/// Cost of a since(now()) pair, subtracted from every measurement.
+inline uint32_t measure_overhead() {
+    uint32_t best = CycleCounter::kMask;
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t t0 = CycleCounter::now();
+        const uint32_t c = CycleCounter::since(t0);
+        if (c < best) {
+            best = c;
+        }
+    }
+    return best;
+}
+
+}  // namespace tilt::bench
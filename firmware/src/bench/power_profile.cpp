@@ -0,0 +1,279 @@
+// Scripted power-profiling sequence for measuring the supply with a probe.
+//
+// Built as a separate executable (see README). Steps every subsystem through
+// a fixed list of phases, one steady state each, and marks them on
+// kProfileMarkerPin: a phase starts with (index + 1) narrow pulses, then the
+// marker stays high for as long as the phase holds, so a current probe
+// trace can be cut into phases from the marker channel alone. Set-up
+// traffic happens before the marker rises. Measured phase times go out on
+// stdio, one `key=value` line per phase, between cycles with the marker
+// low; nothing prints while a phase holds.
+
+#include <cstdio>
+
+#include "audio/melody.hpp"
+#include "audio/pio_buzzer.hpp"
+#include "board.hpp"
+#include "display/framebuffer.hpp"
+#include "display/ssd1306.hpp"
+#include "drivers/i2c_bus.hpp"
+#include "drivers/i2c_dma.hpp"
+#include "drivers/lis3dh.hpp"
+#include "drivers/lis3dh_regs.hpp"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "led/led_effects.hpp"
+#include "pico/stdlib.h"
+#include "power/power_manager.hpp"
+
+namespace {
+
+using tilt::lis3dh::Odr;
+
+constexpr const tilt::board::BoardConfig& kBoard = tilt::board::kBoard;
+static_assert(tilt::board::has(kBoard.profile_marker_pin),
+              "the power profile marks phases on the spare test point");
+
+constexpr uint32_t kHoldMs = 3000;
+constexpr uint32_t kPulseUs = 50;
+
+// 2 kHz continuous for a whole phase.
+constexpr auto kToneWords = tilt::compile_melody({tilt::Note{2000, kHoldMs}});
+constexpr tilt::Melody kTone = tilt::make_melody(kToneWords);
+
+constexpr uint8_t kOledOff[] = {0xAE, 0x8D, 0x10};  // display off, charge pump off
+constexpr uint8_t kOledOn[] = {0x8D, 0x14, 0xAF};   // charge pump on, display on
+constexpr uint8_t kCmdContrast = 0x81;
+
+struct Rig {
+    tilt::Lis3dh& accel;
+    tilt::Ssd1306& oled;
+    tilt::Framebuffer& frame;
+    tilt::PioBuzzer& buzzer;
+    tilt::LedEffects& led;
+    tilt::PowerManager& power;
+    bool oled_ok;
+    bool buzzer_ok;
+    volatile bool expired;
+};
+
+enum class Load : uint8_t {
+    kIdle,     // core 0 waits for the phase alarm in the phase's PowerState
+    kI2cBusy,  // back-to-back sample reads for the whole phase
+};
+
+struct Phase {
+    const char* name;
+    void (*enter)(Rig& rig);
+    tilt::PowerState idle;
+    Load load;
+};
+
+void accel_odr(Rig& rig, Odr odr, bool low_power) {
+    (void)rig.accel.write_reg(tilt::lis3dh::reg::kCtrlReg1, tilt::lis3dh::ctrl1(odr, low_power));
+}
+
+void oled_commands(Rig& rig, const uint8_t* cmds, size_t len) {
+    if (rig.oled_ok) {
+        (void)rig.oled.send_commands(cmds, len);
+    }
+}
+
+void oled_fill(Rig& rig, uint8_t pattern, uint8_t contrast) {
+    if (!rig.oled_ok) {
+        return;
+    }
+    const uint8_t cmds[] = {kCmdContrast, contrast};
+    (void)rig.oled.send_commands(cmds, sizeof(cmds));
+    rig.frame.fill(pattern);
+    if (rig.oled.flush(rig.frame, nullptr, nullptr)) {
+        while (rig.oled.flushing()) {
+            tight_loop_contents();
+        }
+    }
+}
+
+// Every phase starts from this and turns on only what it measures.
+void all_off(Rig& rig) {
+    rig.led.off();
+    if (rig.buzzer_ok) {
+        rig.buzzer.stop();
+    }
+    accel_odr(rig, Odr::kPowerDown, false);
+    oled_commands(rig, kOledOff, sizeof(kOledOff));
+}
+
+void oled_on(Rig& rig, uint8_t pattern, uint8_t contrast) {
+    oled_commands(rig, kOledOn, sizeof(kOledOn));
+    oled_fill(rig, pattern, contrast);
+}
+
+const Phase kPhases[] = {
+    {"idle_run", [](Rig& r) { all_off(r); }, tilt::PowerState::kRun, Load::kIdle},
+    {"idle_sleep", [](Rig& r) { all_off(r); }, tilt::PowerState::kSleep, Load::kIdle},
+    {"accel_10hz_lp",
+     [](Rig& r) {
+         all_off(r);
+         accel_odr(r, Odr::k10Hz, true);
+     },
+     tilt::PowerState::kSleep, Load::kIdle},
+    {"accel_50hz",
+     [](Rig& r) {
+         all_off(r);
+         accel_odr(r, Odr::k50Hz, false);
+     },
+     tilt::PowerState::kSleep, Load::kIdle},
+    {"accel_200hz",
+     [](Rig& r) {
+         all_off(r);
+         accel_odr(r, Odr::k200Hz, false);
+     },
+     tilt::PowerState::kSleep, Load::kIdle},
+    {"i2c_busy",
+     [](Rig& r) {
+         all_off(r);
+         accel_odr(r, Odr::k200Hz, false);
+     },
+     tilt::PowerState::kRun, Load::kI2cBusy},
+    {"oled_black",
+     [](Rig& r) {
+         all_off(r);
+         oled_on(r, 0x00, 0xCF);
+     },
+     tilt::PowerState::kSleep, Load::kIdle},
+    {"oled_white",
+     [](Rig& r) {
+         all_off(r);
+         oled_on(r, 0xFF, 0xFF);
+     },
+     tilt::PowerState::kSleep, Load::kIdle},
+    {"oled_white_dim",
+     [](Rig& r) {
+         all_off(r);
+         oled_on(r, 0xFF, 0x10);
+     },
+     tilt::PowerState::kSleep, Load::kIdle},
+    {"led_breathe",
+     [](Rig& r) {
+         all_off(r);
+         r.led.play(tilt::LedEffect::kBreathe, 1000);
+     },
+     tilt::PowerState::kSleep, Load::kIdle},
+    // The buzzer keeps clk_sys undivided, as in the product firmware.
+    {"buzzer_tone",
+     [](Rig& r) {
+         all_off(r);
+         if (r.buzzer_ok) {
+             r.buzzer.play(kTone);
+         }
+     },
+     tilt::PowerState::kRun, Load::kIdle},
+    {"all_on",
+     [](Rig& r) {
+         all_off(r);
+         accel_odr(r, Odr::k200Hz, false);
+         oled_on(r, 0xFF, 0xFF);
+         r.led.play(tilt::LedEffect::kBreathe, 1000);
+         if (r.buzzer_ok) {
+             r.buzzer.play(kTone);
+         }
+     },
+     tilt::PowerState::kRun, Load::kIdle},
+};
+
+constexpr unsigned kPhaseCount = sizeof(kPhases) / sizeof(kPhases[0]);
+
+int64_t on_phase_alarm(alarm_id_t, void* ctx) {
+    static_cast<Rig*>(ctx)->expired = true;
+    return 0;
+}
+
+bool phase_over(void* ctx) {
+    return static_cast<Rig*>(ctx)->expired;
+}
+
+void marker_pulses(unsigned count) {
+    for (unsigned i = 0; i < count; ++i) {
+        gpio_put(kBoard.profile_marker_pin, true);
+        busy_wait_us_32(kPulseUs);
+        gpio_put(kBoard.profile_marker_pin, false);
+        busy_wait_us_32(kPulseUs);
+    }
+}
+
+void hold(Rig& rig, const Phase& phase) {
+    rig.expired = false;
+    add_alarm_in_ms(kHoldMs, &on_phase_alarm, &rig, true);
+    uint8_t raw[6];
+    while (!rig.expired) {
+        if (phase.load == Load::kI2cBusy) {
+            (void)rig.accel.read_regs(tilt::lis3dh::reg::kOutXL, raw, sizeof(raw));
+        } else {
+            rig.power.idle(phase.idle, &phase_over, &rig);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    stdio_init_all();
+    i2c_init(i2c0, kBoard.i2c_baud_hz);
+    gpio_set_function(kBoard.i2c_sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(kBoard.i2c_scl_pin, GPIO_FUNC_I2C);
+    gpio_init(kBoard.profile_marker_pin);
+    gpio_set_dir(kBoard.profile_marker_pin, GPIO_OUT);
+    gpio_put(kBoard.profile_marker_pin, false);
+
+    static tilt::I2cDma i2c_dma(i2c0);
+    static tilt::I2cBus bus(i2c_dma);
+    static tilt::Lis3dh accel(bus, kBoard.accel_address);
+    static tilt::Ssd1306 oled(bus, kBoard.oled_address);
+    static tilt::Framebuffer frame;
+    static tilt::PioBuzzer buzzer(pio0, kBoard.buzzer_pin);
+    static tilt::LedEffects led(kBoard.led_pin);
+    static tilt::PowerManager power;
+    if (!i2c_dma.init()) {
+        return 1;
+    }
+    if (led.init()) {
+        power.add_clock_hook(&tilt::LedEffects::on_clock_change, &led);
+    }
+    power.init({kBoard.accel_int1_pin, GPIO_IRQ_EDGE_RISE},
+               {kBoard.accel_int2_pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL});
+    const bool oled_ok = oled.init();
+    const bool buzzer_ok = buzzer.init();
+    static Rig rig{accel, oled, frame, buzzer, led, power, oled_ok, buzzer_ok, false};
+    const bool accel_ok = accel.probe();
+
+    sleep_ms(2000);
+    printf("profile=start phases=%u hold_ms=%lu accel=%d oled=%d buzzer=%d\n", kPhaseCount,
+           static_cast<unsigned long>(kHoldMs), accel_ok, oled_ok, buzzer_ok);
+
+    uint64_t start_us[kPhaseCount] = {};
+    uint64_t end_us[kPhaseCount] = {};
+    for (unsigned cycle = 0;; ++cycle) {
+        for (unsigned i = 0; i < kPhaseCount; ++i) {
+            const Phase& phase = kPhases[i];
+            phase.enter(rig);
+            marker_pulses(i + 1);
+            gpio_put(kBoard.profile_marker_pin, true);
+            start_us[i] = time_us_64();
+            hold(rig, phase);
+            end_us[i] = time_us_64();
+            gpio_put(kBoard.profile_marker_pin, false);
+        }
+        all_off(rig);
+        for (unsigned i = 0; i < kPhaseCount; ++i) {
+            printf("cycle=%u phase=%u name=%s start_us=%llu dur_us=%llu\n", cycle, i,
+                   kPhases[i].name, static_cast<unsigned long long>(start_us[i]),
+                   static_cast<unsigned long long>(end_us[i] - start_us[i]));
+        }
+        const auto stats = power.stats();
+        for (unsigned s = 0; s < tilt::kPowerStateCount; ++s) {
+            printf("cycle=%u state=%u residency_us=%llu entries=%lu\n", cycle, s,
+                   static_cast<unsigned long long>(stats.residency_us[s]),
+                   static_cast<unsigned long>(stats.entries[s]));
+        }
+    }
+}
@@ -0,0 +1,442 @@
+// On-target cycle costs of the firmware's hot paths.
+//
+// Built as a separate executable (see README). Runs each benchmark once and
+// prints one `key=value` line per result on stdio (UART or USB, whichever
+// the target links), framed by a `suite=` header and a `suite=end` trailer
+// so tools/bench_check.py can compare a capture against a baseline. CPU
+// benchmarks use synthetic inputs; the bus benchmarks (FIFO drain, OLED
+// flush) time the real transfers from submit to completion callback and
+// report `status=skipped` when the device does not answer. The boot
+// benchmarks replay the product's first stage (bus, dark panel, cached
+// frame) and time it from reset.
+
+#include <cstdio>
+
+#include "bench/bench_report.hpp"
+#include "bench/cycle_counter.hpp"
+#include "board.hpp"
+#include "diag/trace.hpp"
+#include "display/countdown_view.hpp"
+#include "display/fonts.hpp"
+#include "display/framebuffer.hpp"
+#include "display/glyph.hpp"
+#include "display/ssd1306.hpp"
+#include "drivers/i2c_bus.hpp"
+#include "drivers/i2c_dma.hpp"
+#include "drivers/lis3dh.hpp"
+#include "drivers/lis3dh_fifo.hpp"
+#include "drivers/lis3dh_regs.hpp"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "orientation/mount.hpp"
+#include "orientation/orientation_engine.hpp"
+#include "orientation/tilt_classifier.hpp"
+#include "pico/stdlib.h"
+#include "sched/event_loop.hpp"
+#include "storage/frame_cache.hpp"
+#include "storage/session_log.hpp"
+#include "util/constexpr_math.hpp"
+
+namespace {
+
+using tilt::bench::CycleCounter;
+using tilt::bench::Stat;
+
+constexpr const tilt::board::BoardConfig& kBoard = tilt::board::kBoard;
+
+constexpr unsigned kVersion = 1;
+
+constexpr unsigned kBatches = 512;
+constexpr unsigned kBatchSize = tilt::AccelBatch::kCapacity;
+constexpr unsigned kDrains = 16;
+constexpr unsigned kFlushes = 8;
+constexpr unsigned kBlits = 256;
+constexpr unsigned kTicks = 600;
+constexpr unsigned kLogRounds = 32;
+constexpr unsigned kDispatches = 1024;
+constexpr unsigned kTraceRecords = 1024;
+
+// Reset to the first whole frame on DS1.
+constexpr uint32_t kFirstPixelBudgetUs = 50'000;
+
+// 1 g on each axis in raw left-justified counts (12-bit, 1 mg/LSB).
+constexpr int16_t kOneG = 1000 << 4;
+
+uint32_t g_overhead = 0;
+unsigned g_benches = 0;
+
+struct Rng {
+    uint32_t state = 0x1234'5678;
+    int16_t noise(int16_t span) {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<int16_t>(static_cast<int32_t>(state >> 16) % span - span / 2);
+    }
+};
+
+uint32_t elapsed(uint32_t t0) {
+    return CycleCounter::since(t0) - g_overhead;
+}
+
+void report(const char* name, const char* unit, const Stat& stat, const char* extra = "") {
+    tilt::bench::print_result(name, unit, stat, extra);
+    ++g_benches;
+}
+
+void report_skipped(const char* name, const char* reason) {
+    tilt::bench::print_skipped(name, reason);
+    ++g_benches;
+}
+
+// Rests on each face for a few batches, then tumbles through the next one:
+// runs of in-cone samples exercise the dwell path, the tumble the rejects.
+void fill_batch(unsigned n, Rng& rng, tilt::AccelSample* out) {
+    const unsigned face = (n / 8) % tilt::kFaceCount;
+    const bool tumbling = (n % 8) == 7;
+    for (unsigned i = 0; i < kBatchSize; ++i) {
+        int16_t axes[3] = {rng.noise(1600), rng.noise(1600), rng.noise(1600)};
+        const int16_t g = tumbling ? static_cast<int16_t>(kOneG / 2) : kOneG;
+        axes[face / 2] = static_cast<int16_t>((face & 1) ? -g : g);
+        out[i] = tilt::AccelSample{axes[0], axes[1], axes[2]};
+    }
+}
+
+// A calibrated unit whose sensor sits 5 degrees off about Y.
+constexpr tilt::Mount tilted_mount(double deg) {
+    const double r = tilt::cmath::radians(deg);
+    const auto q14 = [](double v) {
+        return static_cast<int16_t>(v * tilt::Mount::kOne + (v < 0 ? -0.5 : 0.5));
+    };
+    const int16_t c = q14(tilt::cmath::cos(r));
+    const int16_t s = q14(tilt::cmath::cos(tilt::cmath::kPi / 2 - r));
+    return tilt::Mount{{c, 0, s, 0, tilt::Mount::kOne, 0, static_cast<int16_t>(-s), 0, c}};
+}
+
+void bench_classifier(const char* name, const tilt::Mount& mount) {
+    static tilt::AccelSample batch[kBatchSize];
+    tilt::TiltClassifier classifier(
+        tilt::make_tilt_config(30.0, 20, tilt::OrientationEngine::kSampleRateHz));
+    classifier.set_mount(mount);
+    classifier.reset(tilt::Face::kXPos);
+    Rng rng;
+    Stat stat;
+    unsigned changes = 0;
+    for (unsigned n = 0; n < kBatches; ++n) {
+        fill_batch(n, rng, batch);
+        const uint32_t t0 = CycleCounter::now();
+        changes += classifier.update(batch, kBatchSize);
+        stat.add(elapsed(t0), kBatchSize);
+    }
+    char extra[24];
+    snprintf(extra, sizeof(extra), "changes=%u", changes);
+    report(name, "sample", stat, extra);
+}
+
+struct DrainWait {
+    volatile bool done;
+    volatile bool ok;
+    volatile uint8_t count;
+};
+
+void on_drained(const tilt::AccelBatch& batch, bool ok, void* ctx) {
+    auto* w = static_cast<DrainWait*>(ctx);
+    w->count = batch.count;
+    w->ok = ok;
+    w->done = true;
+}
+
+// Stream mode at the run ODR; each drain waits for about 3/4 of a FIFO so
+// the burst length matches what the watermark delivers in the product.
+void bench_fifo_drain(tilt::Lis3dh& accel, tilt::Lis3dhFifo& fifo) {
+    using namespace tilt::lis3dh;
+    constexpr uint8_t kLevel = 24;
+    constexpr uint32_t kFillMs = kLevel * 1000 / tilt::OrientationEngine::kSampleRateHz + 1;
+    if (!accel.probe() || !accel.write_reg(reg::kCtrlReg1, ctrl1(Odr::k200Hz, false)) ||
+        !accel.write_reg(reg::kCtrlReg4, kCtrl4Bdu | kCtrl4Fs2g) ||
+        !fifo.enable(tilt::FifoMode::kStream, kLevel)) {
+        report_skipped("fifo_drain", "no_accel");
+        return;
+    }
+    Stat stat;
+    unsigned samples = 0;
+    for (unsigned i = 0; i < kDrains; ++i) {
+        sleep_ms(kFillMs);
+        DrainWait wait{false, false, 0};
+        const uint32_t t0 = CycleCounter::now();
+        if (!fifo.start_drain(&on_drained, &wait)) {
+            break;
+        }
+        while (!wait.done) {
+            tight_loop_contents();
+        }
+        const uint32_t cycles = elapsed(t0);
+        if (!wait.ok) {
+            break;
+        }
+        stat.add(cycles);
+        samples += wait.count;
+    }
+    (void)fifo.disable();
+    (void)accel.write_reg(reg::kCtrlReg1, ctrl1(Odr::kPowerDown, false));
+    if (stat.ops() != kDrains) {
+        report_skipped("fifo_drain", "bus_error");
+        return;
+    }
+    char extra[24];
+    snprintf(extra, sizeof(extra), "samples=%u", samples);
+    report("fifo_drain", "batch", stat, extra);
+}
+
+// Times one flush of whatever is dirty, from submit to the bus callback.
+bool timed_flush(tilt::Ssd1306& oled, tilt::Framebuffer& frame, Stat& stat) {
+    const uint32_t t0 = CycleCounter::now();
+    if (!oled.flush(frame, nullptr, nullptr)) {
+        return false;
+    }
+    while (oled.flushing()) {
+        tight_loop_contents();
+    }
+    stat.add(elapsed(t0));
+    return true;
+}
+
+// Full: every page dirty. Partial: an ordinary countdown tick, which
+// redraws a single seconds digit.
+void bench_oled(tilt::Ssd1306& oled, tilt::Framebuffer& frame, bool oled_ok) {
+    if (!oled_ok) {
+        report_skipped("oled_full", "no_oled");
+        report_skipped("oled_partial", "no_oled");
+        return;
+    }
+    Stat full;
+    for (unsigned i = 0; i < kFlushes; ++i) {
+        frame.fill(i & 1 ? 0xFF : 0x00);
+        frame.mark_all_dirty();
+        if (!timed_flush(oled, frame, full)) {
+            break;
+        }
+    }
+    const uint32_t full_bytes = oled.last_flush_bytes();
+
+    frame.clear();
+    tilt::CountdownView view;
+    view.render(frame, 25 * 60);
+    Stat first;
+    (void)timed_flush(oled, frame, first);
+    Stat partial;
+    for (unsigned i = 1; i <= kFlushes; ++i) {
+        view.render(frame, 25 * 60 - i);
+        if (!timed_flush(oled, frame, partial)) {
+            break;
+        }
+    }
+    const uint32_t partial_bytes = oled.last_flush_bytes();
+
+    char extra[24];
+    snprintf(extra, sizeof(extra), "bytes=%lu", static_cast<unsigned long>(full_bytes));
+    report("oled_full", "flush", full, extra);
+    snprintf(extra, sizeof(extra), "bytes=%lu", static_cast<unsigned long>(partial_bytes));
+    report("oled_partial", "flush", partial, extra);
+}
+
+void bench_glyphs(tilt::Framebuffer& frame) {
+    Stat blit;
+    for (unsigned i = 0; i < kBlits; i += 8) {
+        const uint32_t t0 = CycleCounter::now();
+        for (unsigned j = 0; j < 8; ++j) {
+            const tilt::Glyph& glyph = tilt::fonts::kDigits[(i + j) % 10];
+            tilt::blit(frame, glyph, 1, (j % 5) * glyph.width);
+        }
+        blit.add(elapsed(t0), 8);
+    }
+    report("glyph_blit", "glyph", blit);
+
+    // One minute of countdown ticks, including the minute rollovers.
+    frame.clear();
+    tilt::CountdownView view;
+    view.render(frame, kTicks);
+    Stat tick;
+    for (unsigned s = kTicks; s-- > 0;) {
+        const uint32_t t0 = CycleCounter::now();
+        view.render(frame, s);
+        tick.add(elapsed(t0));
+    }
+    report("countdown_render", "tick", tick);
+}
+
+// append() only; service() would write the real log sector, so the batch
+// is discarded between rounds instead.
+void bench_log_append() {
+    static tilt::SessionLog log;
+    tilt::SessionRecord record{};
+    record.planned_ms = 25 * 60 * 1000;
+    record.actual_ms = record.planned_ms;
+    Stat stat;
+    for (unsigned round = 0; round < kLogRounds; ++round) {
+        log = tilt::SessionLog{};
+        for (unsigned i = 0; i < tilt::SessionLog::kSlotsPerPage; ++i) {
+            record.start_s = round * 60 + i;
+            const uint32_t t0 = CycleCounter::now();
+            const bool queued = log.append(record);
+            stat.add(elapsed(t0));
+            (void)queued;
+        }
+    }
+    report("log_append", "record", stat);
+}
+
+void noop_task(void*) {}
+
+// post() from thread context, then one run_once() that finds and runs it.
+void bench_dispatch() {
+    static tilt::EventLoop loop;
+    if (!loop.init()) {
+        report_skipped("sched_dispatch", "no_alarm");
+        return;
+    }
+    const tilt::TaskId task = loop.add_task("noop", &noop_task, nullptr);
+    Stat post;
+    Stat dispatch;
+    for (unsigned i = 0; i < kDispatches; ++i) {
+        uint32_t t0 = CycleCounter::now();
+        loop.post(task);
+        post.add(elapsed(t0));
+        t0 = CycleCounter::now();
+        (void)loop.run_once();
+        dispatch.add(elapsed(t0));
+    }
+    report("sched_post", "post", post);
+    report("sched_dispatch", "dispatch", dispatch);
+}
+
+// Eight back-to-back records per interval, as a burst of ISRs would log.
+void bench_trace() {
+#if TILT_TRACE
+    Stat stat;
+    for (unsigned i = 0; i < kTraceRecords; i += 8) {
+        const uint32_t t0 = CycleCounter::now();
+        for (unsigned j = 0; j < 8; ++j) {
+            tilt::trace::record(tilt::trace::Event::kMark, static_cast<uint16_t>(i + j));
+        }
+        stat.add(elapsed(t0), 8);
+    }
+    report("trace_record", "record", stat);
+#else
+    report_skipped("trace_record", "disabled");
+#endif
+}
+
+// Microseconds since reset (the timer starts with the clocks, before
+// main) at each step of main.cpp's first boot stage.
+struct BootTimes {
+    uint64_t main_us;
+    uint64_t bus_us;
+    uint64_t panel_us;
+    uint64_t pixel_us;
+    bool cached;
+};
+
+// UiPipeline::boot() step by step: dark init, then the cached idle screen
+// (or a drawn one), then display on.
+bool boot_first_frame(tilt::Ssd1306& oled, tilt::Framebuffer& frame, BootTimes& boot) {
+    const bool ok = oled.init_dark();
+    boot.panel_us = time_us_64();
+    if (!ok) {
+        return false;
+    }
+    const uint8_t* cached = tilt::frame_cache::load();
+    boot.cached = cached != nullptr;
+    if (boot.cached) {
+        frame.load(cached);
+    } else {
+        tilt::CountdownView view;
+        view.render(frame, 0);
+        view.set_status_icon(frame, &tilt::fonts::kPause);
+    }
+    if (oled.flush(frame, nullptr, nullptr)) {
+        while (oled.flushing()) {
+            tight_loop_contents();
+        }
+    }
+    const bool lit = oled.display_on();
+    boot.pixel_us = time_us_64();
+    return lit;
+}
+
+// One-shot spans, so n=1; reported in cycles like every other result,
+// with the wall time alongside.
+void report_span(const char* name, uint64_t from_us, uint64_t to_us, const char* extra) {
+    const uint64_t us = to_us - from_us;
+    Stat stat;
+    stat.add(static_cast<uint32_t>(us * (clock_get_hz(clk_sys) / 1000) / 1000));
+    char line[64];
+    snprintf(line, sizeof(line), "us=%lu%s%s", static_cast<unsigned long>(us),
+             extra[0] != '\0' ? " " : "", extra);
+    report(name, "boot", stat, line);
+}
+
+void bench_boot(const BootTimes& boot, bool oled_ok) {
+    report_span("boot_to_main", 0, boot.main_us, "");
+    report_span("boot_bus", boot.main_us, boot.bus_us, "");
+    if (!oled_ok) {
+        report_skipped("boot_panel", "no_oled");
+        report_skipped("boot_first_pixel", "no_oled");
+        return;
+    }
+    report_span("boot_panel", boot.bus_us, boot.panel_us, "");
+    char extra[48];
+    snprintf(extra, sizeof(extra), "cached=%u budget_us=%lu met=%u", boot.cached ? 1u : 0u,
+             static_cast<unsigned long>(kFirstPixelBudgetUs),
+             boot.pixel_us <= kFirstPixelBudgetUs ? 1u : 0u);
+    report_span("boot_first_pixel", 0, boot.pixel_us, extra);
+}
+
+}  // namespace
+
+int main() {
+    // Boot stage 1 first, exactly as main.cpp orders it; stdio (slow over
+    // USB) only afterwards, and the results are printed with the rest.
+    BootTimes boot{};
+    boot.main_us = time_us_64();
+    tilt::trace::init();
+    i2c_init(i2c0, kBoard.i2c_baud_hz);
+    gpio_set_function(kBoard.i2c_sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(kBoard.i2c_scl_pin, GPIO_FUNC_I2C);
+
+    static tilt::I2cDma i2c_dma(i2c0);
+    static tilt::I2cBus bus(i2c_dma);
+    static tilt::Lis3dh accel(bus, kBoard.accel_address);
+    static tilt::Lis3dhFifo fifo(accel);
+    static tilt::Ssd1306 oled(bus, kBoard.oled_address);
+    static tilt::Framebuffer frame;
+    const bool bus_ok = i2c_dma.init();
+    boot.bus_us = time_us_64();
+    const bool oled_ok = bus_ok && boot_first_frame(oled, frame, boot);
+    stdio_init_all();
+    sleep_ms(2000);
+
+    CycleCounter::start();
+    g_overhead = tilt::bench::measure_overhead();
+    printf("suite=tilt_bench version=%u clk_sys_hz=%lu overhead=%lu\n", kVersion,
+           static_cast<unsigned long>(clock_get_hz(clk_sys)),
+           static_cast<unsigned long>(g_overhead));
+
+    bench_boot(boot, oled_ok);
+    bench_classifier("tilt_classifier", tilt::kIdentityMount);
+    bench_classifier("tilt_classifier_mounted", tilted_mount(5.0));
+    if (bus_ok) {
+        bench_fifo_drain(accel, fifo);
+    } else {
+        report_skipped("fifo_drain", "no_dma");
+    }
+    bench_oled(oled, frame, oled_ok);
+    bench_glyphs(frame);
+    bench_log_append();
+    bench_dispatch();
+    bench_trace();
+
+    printf("suite=end benches=%u\n", g_benches);
+    for (;;) {
+        tight_loop_contents();
+    }
+}
@@ -0,0 +1,25 @@
+// The board revision this build targets (TILT_BOARD_REV).
+#pragma once
+
+#include "board/board_config.hpp"
+#include "features.hpp"
+
+#if TILT_BOARD_REV == 10
+#include "board/rev1_0.hpp"
+#else
+#error "unknown TILT_BOARD_REV; generate its config with tools/board_gen.py"
+#endif
+
+namespace tilt::board {
+
+/// Everything pin- or bus-related reads this. The generated rev 1.0 config
+/// includes the rework the firmware relies on (see the README): U2 INT1 and
+/// INT2 on GPIO6/GPIO7, the profiling marker on GPIO17, and the 1M / 330k
+/// +BATT divider on ADC0, whose ratio puts 13.3 V at full scale. A new
+/// revision is a new generated header and one more case here.
+inline constexpr const BoardConfig& kBoard =
+#if TILT_BOARD_REV == 10
+    kRev1_0;
+#endif
+
+}  // namespace tilt::board
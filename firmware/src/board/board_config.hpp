@@ -0,0 +1,56 @@
+// The shape of a board revision: which U1 GPIO each net lands on.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt::board {
+
+/// A pin the revision leaves unconnected.
+inline constexpr unsigned kNoPin = 0xFF;
+
+/// +BATT through a resistor divider to one of the ADC pins. The ADC
+/// reference is the 3.3 V rail, so readings are only meaningful while U3
+/// is still regulating.
+struct BatterySense {
+    unsigned pin = kNoPin;
+    unsigned adc_input = 0;
+    uint32_t divider_top_ohms = 0;
+    uint32_t divider_bottom_ohms = 0;
+    uint32_t reference_mv = 3'300;
+};
+
+/// Everything the firmware needs to know about one board revision, as a
+/// literal type. Revisions are generated from the schematic netlist by
+/// tools/board_gen.py (board/rev*.hpp) and board.hpp picks one. Drivers
+/// take their pins as constructor arguments and keep them as members, so
+/// the config only removes the literals; what it does decide at compile
+/// time is presence: code behind `if constexpr (has(...))` drops out of a
+/// revision without the part.
+struct BoardConfig {
+    const char* name;
+
+    // Shared I2C bus: U2 (LIS3DH) and DS1 (OLED).
+    unsigned i2c_sda_pin;
+    unsigned i2c_scl_pin;
+    uint32_t i2c_baud_hz;
+    uint8_t accel_address;  // 0x18 with U2 SDO tied to GND, 0x19 to +3.3V
+    uint8_t oled_address;
+
+    // LIS3DH interrupt outputs.
+    unsigned accel_int1_pin;
+    unsigned accel_int2_pin;
+
+    unsigned buzzer_pin;  // BZ1 through its series resistor
+    unsigned led_pin;     // D1 through its series resistor
+
+    // Spare test point for the power-profiling build's phase marker.
+    unsigned profile_marker_pin;
+
+    BatterySense battery;
+};
+
+inline constexpr bool has(unsigned pin) {
+    return pin != kNoPin;
+}
+
+}  // namespace tilt::board
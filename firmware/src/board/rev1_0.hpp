@@ -0,0 +1,32 @@
+// Board config for rev 1.0, generated from hardware/411-pre.net. Do not edit; rerun
+//   tools/board_gen.py hardware/411-pre.net --set=accel_int1_pin=6 --set=accel_int2_pin=7
+//       --set=profile_marker_pin=17 --set=battery.pin=26 --set=battery.adc_input=0
+//       --set=battery.divider_top_ohms=1000000 --set=battery.divider_bottom_ohms=330000
+// Netlist tool: transcribed by hand from Tilt-Timer Shematic.pdf
+#pragma once
+
+#include "board/board_config.hpp"
+
+namespace tilt::board {
+
+inline constexpr BoardConfig kRev1_0 = {
+    .name = "rev 1.0",
+    .i2c_sda_pin = 4,
+    .i2c_scl_pin = 5,
+    .i2c_baud_hz = 400'000,
+    .accel_address = 0x18,
+    .oled_address = 0x3C,
+    .accel_int1_pin = 6,
+    .accel_int2_pin = 7,
+    .buzzer_pin = 15,
+    .led_pin = 16,
+    .profile_marker_pin = 17,
+    .battery = {
+        .pin = 26,
+        .adc_input = 0,
+        .divider_top_ohms = 1'000'000,
+        .divider_bottom_ohms = 330'000,
+    },
+};
+
+}  // namespace tilt::board
@@ -0,0 +1,39 @@
+#include "diag/trace.hpp"
+
+#if TILT_TRACE
+
+#include <cstdio>
+
+namespace tilt::trace {
+
+namespace {
+constexpr unsigned kDumpLineBytes = 32;
+}  // namespace
+
+Buffer buffer;
+
+void init() {
+    buffer.version = Buffer::kVersion;
+    buffer.record_bytes = sizeof(Record);
+    buffer.cores = kCores;
+    buffer.depth = kDepth;
+    // Last, so a dump taken mid-init never shows a half-stamped header.
+    buffer.magic = Buffer::kMagic;
+}
+
+void dump() {
+    const auto* bytes = reinterpret_cast<const volatile uint8_t*>(&buffer);
+    printf("trace=begin version=%u bytes=%u\n", Buffer::kVersion,
+           static_cast<unsigned>(sizeof(Buffer)));
+    for (size_t i = 0; i < sizeof(Buffer); i += kDumpLineBytes) {
+        for (size_t j = i; j < i + kDumpLineBytes && j < sizeof(Buffer); ++j) {
+            printf("%02x", bytes[j]);
+        }
+        printf("\n");
+    }
+    printf("trace=end\n");
+}
+
+}  // namespace tilt::trace
+
+#endif
@@ -0,0 +1,118 @@
+// Per-core binary event trace in RAM, for reconstructing timelines offline.
+#pragma once
+
+#include <cstdint>
+
+#include "features.hpp"
+
+#if TILT_TRACE
+#if TILT_HOST
+#error "TILT_TRACE needs the RP2040 timer and SIO"
+#endif
+#include "hardware/structs/sio.h"
+#include "hardware/structs/timer.h"
+#include "hardware/sync.h"
+#endif
+
+namespace tilt::trace {
+
+/// Event ids; the values are the wire format, so never renumber one.
+/// tools/trace_decode.py reads the names from this enum. Begin/end pairs
+/// are named *Start/*End, *Start/*Done and *Enter/*Exit.
+enum class Event : uint8_t {
+    kNone = 0,
+    // Interrupt entry.
+    kIsrI2c = 1,
+    kIsrDma0 = 2,       // battery burst (shared handler)
+    kIsrDma1 = 3,       // buzzer melody boundary
+    kIsrGpio = 4,       // arg: GPIO number
+    kIsrAlarm = 5,      // event loop deadline
+    kIsrCountdown = 6,  // CubeTimer second; arg: seconds left
+    // Bus.
+    kI2cStart = 16,  // arg: address | priority << 8
+    kI2cDone = 17,   // arg: 1 = ok
+    // Orientation.
+    kTiltBatch = 32,  // arg: samples classified
+    kTiltFace = 33,   // arg: new Face
+    kGesture = 34,    // arg: Gesture
+    // Core 1 UI.
+    kRenderStart = 48,  // arg: UiEvent::Kind
+    kRenderEnd = 49,
+    kFlushStart = 50,
+    kFlushDone = 51,  // arg: 1 = ok
+    kToneStart = 52,  // arg: melody word count
+    // Core 0 scheduling and power.
+    kTaskStart = 64,  // arg: TaskId
+    kTaskEnd = 65,    // arg: TaskId
+    kSleepEnter = 80,  // arg: PowerState
+    kSleepExit = 81,   // arg: PowerState
+    // Free for ad-hoc instrumentation while debugging.
+    kMark = 255,
+};
+
+/// Eight bytes: a 1 MHz timestamp from the system timer, which both cores
+/// read, so the two rings merge into one timeline; then the argument,
+/// event id and core packed into one word so recording is two stores.
+struct Record {
+    uint32_t time_us;
+    uint32_t info;  // arg | event << 16 | core << 24
+};
+
+inline constexpr unsigned kCores = 2;
+inline constexpr uint32_t kDepth = TILT_TRACE_DEPTH;
+static_assert(kDepth >= 2 && (kDepth & (kDepth - 1)) == 0, "depth must be a power of two");
+
+/// The whole trace image, self-describing so a raw dump of any RAM range
+/// that contains it can be decoded. heads[] count records ever written;
+/// each ring holds the newest kDepth of them.
+struct Buffer {
+    static constexpr uint32_t kMagic = 0x4352'5454;  // "TTRC"
+    static constexpr uint16_t kVersion = 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint8_t record_bytes;
+    uint8_t cores;
+    uint32_t depth;
+    volatile uint32_t heads[kCores];
+    Record records[kCores][kDepth];
+};
+
+#if TILT_TRACE
+
+extern Buffer buffer;
+
+/// Stamps the header. Records written before this are kept.
+void init();
+
+/// Prints the image as hex between `trace=begin` and `trace=end` lines on
+/// stdio. Both cores keep recording meanwhile, so the oldest records of a
+/// busy ring may be overwritten mid-dump; the decoder drops what no longer
+/// fits the head.
+void dump();
+
+/// Appends one record to the calling core's ring, overwriting the oldest.
+/// Each core's ring is written by that core's thread code and ISRs, so the
+/// slot claim masks interrupts for a handful of instructions instead of
+/// needing an atomic increment the M0+ does not have.
+inline void record(Event event, uint16_t arg = 0) {
+    const uint32_t core = sio_hw->cpuid;
+    const uint32_t info = arg | uint32_t{static_cast<uint8_t>(event)} << 16 | core << 24;
+    const uint32_t irq = save_and_disable_interrupts();
+    const uint32_t head = buffer.heads[core];
+    buffer.heads[core] = head + 1;
+    Record& r = buffer.records[core][head & (kDepth - 1)];
+    r.time_us = timer_hw->timerawl;
+    r.info = info;
+    restore_interrupts(irq);
+}
+
+#else
+
+inline void init() {}
+inline void dump() {}
+inline void record(Event, uint16_t = 0) {}
+
+#endif
+
+}  // namespace tilt::trace
@@ -0,0 +1,61 @@
+#include "display/countdown_view.hpp"
+
+#include "display/fonts.hpp"
+
+namespace tilt {
+
+namespace {
+
+constexpr unsigned kTotalWidth = 4 * fonts::kDigitWidth + fonts::kColonWidth;
+constexpr unsigned kLeft = (Framebuffer::kWidth - kTotalWidth) / 2;
+
+constexpr unsigned digit_x(unsigned i) {
+    return kLeft + i * fonts::kDigitWidth + (i >= 2 ? fonts::kColonWidth : 0);
+}
+
+constexpr unsigned kIconX = Framebuffer::kWidth - 8;
+
+}  // namespace
+
+void CountdownView::render(Framebuffer& fb, uint32_t remaining_s) {
+    uint32_t minutes = remaining_s / 60;
+    uint32_t seconds = remaining_s % 60;
+    if (minutes > 99) {
+        minutes = 99;
+        seconds = 59;
+    }
+    const uint8_t digits[4] = {uint8_t(minutes / 10), uint8_t(minutes % 10),
+                               uint8_t(seconds / 10), uint8_t(seconds % 10)};
+    for (unsigned i = 0; i < 4; ++i) {
+        if (digits[i] != shown_[i]) {
+            blit(fb, fonts::kDigits[digits[i]], kDigitPage, digit_x(i));
+            shown_[i] = digits[i];
+        }
+    }
+    if (!colon_shown_) {
+        blit(fb, fonts::kColon, kDigitPage, digit_x(2) - fonts::kColonWidth);
+        colon_shown_ = true;
+    }
+}
+
+void CountdownView::set_status_icon(Framebuffer& fb, const Glyph* icon) {
+    if (icon == icon_) {
+        return;
+    }
+    if (icon != nullptr) {
+        blit(fb, *icon, kStatusPage, kIconX);
+    } else {
+        blank(fb, 8, 1, kStatusPage, kIconX);
+    }
+    icon_ = icon;
+}
+
+void CountdownView::invalidate() {
+    for (uint8_t& d : shown_) {
+        d = kNone;
+    }
+    colon_shown_ = false;
+    icon_ = nullptr;
+}
+
+}  // namespace tilt
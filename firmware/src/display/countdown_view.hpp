@@ -0,0 +1,34 @@
+// MM:SS countdown screen built from the compile-time digit atlas.
+#pragma once
+
+#include <cstdint>
+
+#include "display/framebuffer.hpp"
+#include "display/glyph.hpp"
+
+namespace tilt {
+
+/// Draws the remaining time centred on DS1. Remembers what it last drew so
+/// an ordinary one-second tick only blits the seconds digit(s) it changed.
+class CountdownView {
+public:
+    static constexpr unsigned kDigitPage = 1;
+    static constexpr unsigned kStatusPage = 7;
+
+    void render(Framebuffer& fb, uint32_t remaining_s);
+
+    /// Draws (or, with nullptr, clears) the status icon at the bottom right.
+    void set_status_icon(Framebuffer& fb, const Glyph* icon);
+
+    /// Forgets the cached state, e.g. after the framebuffer was cleared.
+    void invalidate();
+
+private:
+    static constexpr uint8_t kNone = 0xFF;
+
+    uint8_t shown_[4] = {kNone, kNone, kNone, kNone};
+    bool colon_shown_ = false;
+    const Glyph* icon_ = nullptr;
+};
+
+}  // namespace tilt
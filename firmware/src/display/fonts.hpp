@@ -0,0 +1,167 @@
+// Fonts and icons generated at compile time into page-packed flash tables.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "display/glyph.hpp"
+
+namespace tilt::fonts {
+
+namespace detail {
+
+/// Packs a '#'/'.' ASCII-art bitmap, H rows of W characters, into pages.
+template <size_t W, size_t H>
+constexpr std::array<uint8_t, W*(H / 8)> pack_art(const char* const (&rows)[H]) {
+    static_assert(H % 8 == 0, "glyph height must be page aligned");
+    std::array<uint8_t, W*(H / 8)> out{};
+    for (size_t y = 0; y < H; ++y) {
+        for (size_t x = 0; x < W; ++x) {
+            if (rows[y][x] == '#') {
+                out[(y / 8) * W + x] |= static_cast<uint8_t>(1u << (y % 8));
+            }
+        }
+    }
+    return out;
+}
+
+// Seven-segment geometry for the countdown digits.
+inline constexpr unsigned kDigitWidth = 24;
+inline constexpr unsigned kDigitHeight = 48;
+inline constexpr unsigned kSegment = 4;    // stroke thickness
+inline constexpr unsigned kMarginX = 2;    // blank columns either side
+
+// Segment bits a..g in the usual order (a top, clockwise, g middle).
+inline constexpr uint8_t kSegmentMasks[10] = {0x3F, 0x06, 0x5B, 0x4F, 0x66,
+                                              0x6D, 0x7D, 0x07, 0x7F, 0x6F};
+
+constexpr bool in(unsigned v, unsigned lo, unsigned hi) { return v >= lo && v < hi; }
+
+constexpr bool segment_pixel(uint8_t mask, unsigned x, unsigned y) {
+    constexpr unsigned l = kMarginX;
+    constexpr unsigned r = kDigitWidth - kMarginX;
+    constexpr unsigned mid = kDigitHeight / 2;
+    constexpr unsigned t = kSegment;
+    const bool h = in(x, l + 1, r - 1);
+    const bool left = in(x, l, l + t);
+    const bool right = in(x, r - t, r);
+    const bool upper = in(y, 2, mid - 1);
+    const bool lower = in(y, mid + 1, kDigitHeight - 2);
+    return ((mask & 0x01) && h && in(y, 0, t)) ||                       // a
+           ((mask & 0x02) && right && upper) ||                         // b
+           ((mask & 0x04) && right && lower) ||                         // c
+           ((mask & 0x08) && h && in(y, kDigitHeight - t, kDigitHeight)) ||  // d
+           ((mask & 0x10) && left && lower) ||                          // e
+           ((mask & 0x20) && left && upper) ||                          // f
+           ((mask & 0x40) && h && in(y, mid - t / 2, mid + t / 2));     // g
+}
+
+constexpr std::array<uint8_t, kDigitWidth*(kDigitHeight / 8)> render_digit(unsigned digit) {
+    std::array<uint8_t, kDigitWidth*(kDigitHeight / 8)> out{};
+    for (unsigned y = 0; y < kDigitHeight; ++y) {
+        for (unsigned x = 0; x < kDigitWidth; ++x) {
+            if (segment_pixel(kSegmentMasks[digit], x, y)) {
+                out[(y / 8) * kDigitWidth + x] |= static_cast<uint8_t>(1u << (y % 8));
+            }
+        }
+    }
+    return out;
+}
+
+template <size_t... I>
+constexpr auto render_digits(std::index_sequence<I...>) {
+    return std::array<std::array<uint8_t, kDigitWidth*(kDigitHeight / 8)>, sizeof...(I)>{
+        render_digit(I)...};
+}
+
+inline constexpr auto kDigitBitmaps = render_digits(std::make_index_sequence<10>{});
+
+inline constexpr unsigned kColonWidth = 8;
+
+constexpr std::array<uint8_t, kColonWidth*(kDigitHeight / 8)> render_colon() {
+    std::array<uint8_t, kColonWidth*(kDigitHeight / 8)> out{};
+    for (unsigned y = 0; y < kDigitHeight; ++y) {
+        for (unsigned x = 0; x < kColonWidth; ++x) {
+            const bool dot = in(x, 2, 6) && (in(y, 14, 20) || in(y, 28, 34));
+            if (dot) {
+                out[(y / 8) * kColonWidth + x] |= static_cast<uint8_t>(1u << (y % 8));
+            }
+        }
+    }
+    return out;
+}
+
+inline constexpr auto kColonBitmap = render_colon();
+
+inline constexpr const char* kBellArt[8] = {
+    "...##...",
+    "..####..",
+    ".######.",
+    ".######.",
+    ".######.",
+    "########",
+    "........",
+    "...##...",
+};
+
+inline constexpr const char* kPauseArt[8] = {
+    "........",
+    ".##..##.",
+    ".##..##.",
+    ".##..##.",
+    ".##..##.",
+    ".##..##.",
+    ".##..##.",
+    "........",
+};
+
+inline constexpr const char* kBatteryArt[8] = {
+    "........",
+    "######..",
+    "#....#..",
+    "#....##.",
+    "#....##.",
+    "#....#..",
+    "######..",
+    "........",
+};
+
+inline constexpr const char* kCheckArt[8] = {
+    "........",
+    ".......#",
+    "......##",
+    "#....##.",
+    "##..##..",
+    ".####...",
+    "..##....",
+    "........",
+};
+
+inline constexpr auto kBellBitmap = pack_art<8, 8>(kBellArt);
+inline constexpr auto kPauseBitmap = pack_art<8, 8>(kPauseArt);
+inline constexpr auto kBatteryBitmap = pack_art<8, 8>(kBatteryArt);
+inline constexpr auto kCheckBitmap = pack_art<8, 8>(kCheckArt);
+
+}  // namespace detail
+
+inline constexpr unsigned kDigitWidth = detail::kDigitWidth;
+inline constexpr unsigned kDigitPages = detail::kDigitHeight / 8;
+inline constexpr unsigned kColonWidth = detail::kColonWidth;
+
+inline constexpr std::array<Glyph, 10> kDigits = [] {
+    std::array<Glyph, 10> glyphs{};
+    for (unsigned i = 0; i < glyphs.size(); ++i) {
+        glyphs[i] = make_glyph(detail::kDigitBitmaps[i], kDigitWidth);
+    }
+    return glyphs;
+}();
+
+inline constexpr Glyph kColon = make_glyph(detail::kColonBitmap, kColonWidth);
+inline constexpr Glyph kBell = make_glyph(detail::kBellBitmap, 8);
+inline constexpr Glyph kPause = make_glyph(detail::kPauseBitmap, 8);
+inline constexpr Glyph kBattery = make_glyph(detail::kBatteryBitmap, 8);
+inline constexpr Glyph kCheck = make_glyph(detail::kCheckBitmap, 8);
+
+}  // namespace tilt::fonts
@@ -0,0 +1,101 @@
+#include "display/framebuffer.hpp"
+
+#include <cstring>
+
+namespace tilt {
+
+Framebuffer::Framebuffer() : pages_{} {
+    mark_all_dirty();
+}
+
+void Framebuffer::load(const uint8_t* pixels) {
+    std::memcpy(pages_, pixels, kBytes);
+    mark_all_dirty();
+}
+
+void Framebuffer::fill(uint8_t pattern) {
+    for (unsigned page = 0; page < kPages; ++page) {
+        fill_span(page, 0, kWidth, pattern);
+    }
+}
+
+void Framebuffer::set_pixel(unsigned x, unsigned y, bool on) {
+    if (x >= kWidth || y >= kHeight) {
+        return;
+    }
+    const unsigned page = y / 8;
+    const uint8_t bit = static_cast<uint8_t>(1u << (y % 8));
+    const uint8_t cell = pages_[page][x];
+    write_byte(page, x, on ? uint8_t(cell | bit) : uint8_t(cell & ~bit));
+}
+
+void Framebuffer::write_span(unsigned page, unsigned col, const uint8_t* src, size_t len) {
+    if (page >= kPages || col >= kWidth) {
+        return;
+    }
+    if (len > kWidth - col) {
+        len = kWidth - col;
+    }
+    uint8_t* dst = &pages_[page][col];
+    unsigned first = kWidth;
+    unsigned last = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (dst[i] != src[i]) {
+            dst[i] = src[i];
+            if (first == kWidth) {
+                first = col + i;
+            }
+            last = col + i;
+        }
+    }
+    if (first != kWidth) {
+        mark_dirty(page, first, last);
+    }
+}
+
+void Framebuffer::fill_span(unsigned page, unsigned col, size_t len, uint8_t bits) {
+    if (page >= kPages || col >= kWidth) {
+        return;
+    }
+    if (len > kWidth - col) {
+        len = kWidth - col;
+    }
+    uint8_t* dst = &pages_[page][col];
+    unsigned first = kWidth;
+    unsigned last = 0;
+    for (size_t i = 0; i < len; ++i) {
+        if (dst[i] != bits) {
+            dst[i] = bits;
+            if (first == kWidth) {
+                first = col + i;
+            }
+            last = col + i;
+        }
+    }
+    if (first != kWidth) {
+        mark_dirty(page, first, last);
+    }
+}
+
+bool Framebuffer::any_dirty() const {
+    for (const DirtySpan& d : dirty_) {
+        if (!d.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Framebuffer::DirtySpan Framebuffer::take_dirty(unsigned page) {
+    const DirtySpan d = dirty_[page];
+    dirty_[page] = kClean;
+    return d;
+}
+
+void Framebuffer::mark_all_dirty() {
+    for (DirtySpan& d : dirty_) {
+        d = DirtySpan{0, kWidth - 1};
+    }
+}
+
+}  // namespace tilt
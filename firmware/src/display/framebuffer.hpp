@@ -0,0 +1,81 @@
+// 128x64 monochrome framebuffer in SSD1306 page layout with dirty tracking.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tilt {
+
+/// Page-major pixel store: byte [page][col] holds pixels col, page*8..page*8+7
+/// with bit 0 at the top, exactly as the panel's GDDRAM expects.
+///
+/// Every write compares against the current contents and widens the page's
+/// dirty column window only if a byte actually changed, so a flush pushes
+/// just the columns that differ from what the panel is showing.
+class Framebuffer {
+public:
+    static constexpr unsigned kWidth = 128;
+    static constexpr unsigned kHeight = 64;
+    static constexpr unsigned kPages = kHeight / 8;
+    static constexpr unsigned kBytes = kPages * kWidth;
+
+    /// Inclusive column range; empty when first > last.
+    struct DirtySpan {
+        uint8_t first;
+        uint8_t last;
+
+        bool empty() const { return first > last; }
+        unsigned width() const { return empty() ? 0u : unsigned(last - first + 1); }
+    };
+
+    Framebuffer();
+
+    void clear() { fill(0x00); }
+    void fill(uint8_t pattern);
+
+    void set_pixel(unsigned x, unsigned y, bool on);
+
+    /// Replaces the whole frame with kBytes of page-layout pixels (as
+    /// page_data(0) returns them) and marks it all dirty.
+    void load(const uint8_t* pixels);
+
+    void write_byte(unsigned page, unsigned col, uint8_t bits) {
+        uint8_t& cell = pages_[page][col];
+        if (cell != bits) {
+            cell = bits;
+            mark_dirty(page, col, col);
+        }
+    }
+
+    /// Copies `len` page bytes starting at `col`, clipped to the right edge.
+    void write_span(unsigned page, unsigned col, const uint8_t* src, size_t len);
+    void fill_span(unsigned page, unsigned col, size_t len, uint8_t bits);
+
+    /// Pages are contiguous, so page_data(0) is the whole frame.
+    const uint8_t* page_data(unsigned page) const { return pages_[page]; }
+
+    DirtySpan dirty(unsigned page) const { return dirty_[page]; }
+    bool any_dirty() const;
+    /// Returns the page's dirty window and resets it.
+    DirtySpan take_dirty(unsigned page);
+    /// Forces the next flush to push the whole frame (e.g. after panel reset).
+    void mark_all_dirty();
+
+    void mark_dirty(unsigned page, unsigned first, unsigned last) {
+        DirtySpan& d = dirty_[page];
+        if (d.empty()) {
+            d = DirtySpan{static_cast<uint8_t>(first), static_cast<uint8_t>(last)};
+            return;
+        }
+        if (first < d.first) d.first = static_cast<uint8_t>(first);
+        if (last > d.last) d.last = static_cast<uint8_t>(last);
+    }
+
+private:
+    static constexpr DirtySpan kClean{0xFF, 0x00};
+
+    uint8_t pages_[kPages][kWidth];
+    DirtySpan dirty_[kPages];
+};
+
+}  // namespace tilt
@@ -0,0 +1,41 @@
+// Page-aligned glyph bitmaps and the blit that copies them into a Framebuffer.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "display/framebuffer.hpp"
+
+namespace tilt {
+
+/// A bitmap pre-packed in framebuffer layout: `pages` rows of `width`
+/// column bytes, page-major. Glyph data lives in flash and is read via XIP.
+struct Glyph {
+    uint8_t width;
+    uint8_t pages;
+    const uint8_t* data;
+};
+
+template <size_t N>
+constexpr Glyph make_glyph(const std::array<uint8_t, N>& packed, uint8_t width) {
+    return Glyph{width, static_cast<uint8_t>(N / width), packed.data()};
+}
+
+/// Copies `glyph` with its top-left at (`x`, `page * 8`). One span copy per
+/// page; there is no per-pixel work because glyphs never straddle pages.
+inline void blit(Framebuffer& fb, const Glyph& glyph, unsigned page, unsigned x) {
+    const uint8_t* src = glyph.data;
+    for (unsigned p = 0; p < glyph.pages; ++p, src += glyph.width) {
+        fb.write_span(page + p, x, src, glyph.width);
+    }
+}
+
+/// Clears the area a glyph of `width` x `pages` would occupy.
+inline void blank(Framebuffer& fb, unsigned width, unsigned pages, unsigned page, unsigned x) {
+    for (unsigned p = 0; p < pages; ++p) {
+        fb.fill_span(page + p, x, width, 0x00);
+    }
+}
+
+}  // namespace tilt
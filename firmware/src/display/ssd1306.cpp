@@ -0,0 +1,172 @@
+#include "display/ssd1306.hpp"
+
+#include <cstring>
+
+namespace tilt {
+
+namespace {
+
+// Control bytes: Co (continuation) in bit 7, D/C# in bit 6.
+constexpr uint8_t kControlCommandStream = 0x00;
+constexpr uint8_t kControlCommandSingle = 0x80;
+constexpr uint8_t kControlDataStream = 0x40;
+
+constexpr uint8_t kCmdColumnAddress = 0x21;
+constexpr uint8_t kCmdPageAddress = 0x22;
+constexpr uint8_t kCmdDisplayOn = 0xAF;
+
+constexpr uint8_t kInitSequence[] = {
+    0xAE,        // display off
+    0xD5, 0x80,  // clock divide / oscillator
+    0xA8, 0x3F,  // multiplex 64
+    0xD3, 0x00,  // display offset
+    0x40,        // start line 0
+    0x8D, 0x14,  // charge pump on
+    0x20, 0x00,  // horizontal addressing
+    0xA1,        // segment remap
+    0xC8,        // COM scan descending
+    0xDA, 0x12,  // COM pins: alternative, no remap
+    0x81, 0xCF,  // contrast
+    0xD9, 0xF1,  // pre-charge
+    0xDB, 0x40,  // VCOMH deselect
+    0xA4,        // resume from RAM
+    0xA6,        // normal (non-inverted)
+    0xAF,        // display on
+};
+
+}  // namespace
+
+Ssd1306::Ssd1306(I2cBus& bus, uint8_t address) : bus_(bus), address_(address) {
+    txn_.address = address;
+    txn_.priority = I2cPriority::kBulk;
+    txn_.header = header_;
+    txn_.callback = &Ssd1306::on_chunk_done;
+    txn_.ctx = this;
+}
+
+bool Ssd1306::init() {
+    return sync_wait(init_async());
+}
+
+CoTask Ssd1306::init_async() {
+    co_return co_await command_async(kInitSequence, sizeof(kInitSequence));
+}
+
+bool Ssd1306::init_dark() {
+    static_assert(kInitSequence[sizeof(kInitSequence) - 1] == kCmdDisplayOn);
+    return send_commands(kInitSequence, sizeof(kInitSequence) - 1);
+}
+
+bool Ssd1306::display_on() {
+    return send_commands(&kCmdDisplayOn, 1);
+}
+
+I2cAwait Ssd1306::command_async(const uint8_t* cmds, size_t len) {
+    static constexpr uint8_t kControl = kControlCommandStream;
+    return I2cAwait(bus_, address_, I2cPriority::kControl, &kControl, 1, cmds, len);
+}
+
+bool Ssd1306::send_commands(const uint8_t* cmds, size_t len) {
+    const uint8_t control = kControlCommandStream;
+    I2cTransaction txn;
+    txn.address = address_;
+    txn.priority = I2cPriority::kControl;
+    txn.header = &control;
+    txn.header_len = 1;
+    txn.write = cmds;
+    txn.write_len = len;
+    return bus_.transfer_blocking(txn);
+}
+
+bool Ssd1306::flush(Framebuffer& fb, FlushCallback cb, void* ctx) {
+    if (flushing_ || !fb.any_dirty()) {
+        return false;
+    }
+    // The swap: at most 1 KB of memcpy, against ~25 ms to send that much.
+    for (unsigned page = 0; page < Framebuffer::kPages; ++page) {
+        const Framebuffer::DirtySpan span = fb.take_dirty(page);
+        spans_[page] = span;
+        if (!span.empty()) {
+            memcpy(&front_[page][span.first], fb.page_data(page) + span.first, span.width());
+        }
+    }
+    cb_ = cb;
+    ctx_ = ctx;
+    page_ = 0;
+    col_ = 0;
+    bytes_ = 0;
+    flushing_ = true;
+    if (!next_dirty_page() || !submit_next_chunk()) {
+        finish(false);
+        return false;
+    }
+    return true;
+}
+
+bool Ssd1306::next_dirty_page() {
+    while (page_ < Framebuffer::kPages && spans_[page_].empty()) {
+        ++page_;
+    }
+    return page_ < Framebuffer::kPages;
+}
+
+bool Ssd1306::submit_next_chunk() {
+    const Framebuffer::DirtySpan span = spans_[page_];
+    if (col_ < span.first) {
+        col_ = span.first;
+    }
+
+    size_t hdr = 0;
+    if (col_ == span.first) {
+        // New window: column range, then a single-page range.
+        const uint8_t window[] = {kCmdColumnAddress, span.first, span.last,
+                                  kCmdPageAddress, uint8_t(page_), uint8_t(page_)};
+        for (uint8_t cmd : window) {
+            header_[hdr++] = kControlCommandSingle;
+            header_[hdr++] = cmd;
+        }
+    }
+    header_[hdr++] = kControlDataStream;
+
+    unsigned len = span.last - col_ + 1;
+    if (len > kChunkBytes) {
+        len = kChunkBytes;
+    }
+    txn_.header_len = hdr;
+    txn_.write = &front_[page_][col_];
+    txn_.write_len = len;
+    bytes_ += len;
+
+    col_ += len;
+    if (col_ > span.last) {
+        ++page_;
+        col_ = 0;
+    }
+    return bus_.submit(txn_);
+}
+
+void Ssd1306::on_chunk_done(I2cTransaction&, bool ok, void* ctx) {
+    auto* self = static_cast<Ssd1306*>(ctx);
+    if (!ok) {
+        self->finish(false);
+        return;
+    }
+    if (!self->next_dirty_page()) {
+        self->finish(true);
+    } else if (!self->submit_next_chunk()) {
+        self->finish(false);
+    }
+}
+
+void Ssd1306::finish(bool ok) {
+    if (!ok) {
+        failed_.store(true, std::memory_order_release);
+    }
+    last_flush_bytes_ = bytes_;
+    flushing_ = false;
+    if (cb_ != nullptr) {
+        cb_(ok, ctx_);
+    }
+}
+
+}  // namespace tilt
@@ -0,0 +1,91 @@
+// SSD1306-class 128x64 OLED (DS1) on the shared I2C bus.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "display/framebuffer.hpp"
+#include "drivers/i2c_await.hpp"
+#include "drivers/i2c_bus.hpp"
+#include "sched/co_task.hpp"
+
+namespace tilt {
+
+/// Pushes framebuffer changes to DS1 as page/column windows.
+///
+/// A flush walks the dirty pages; for each one it opens a column window with
+/// chained command bytes (Co=1) and streams the dirty bytes in bulk-priority
+/// chunks of kChunkBytes, so sensor transactions can interleave between them.
+/// The whole sequence is driven from bus completion callbacks.
+///
+/// The driver keeps its own front copy of the frame. Starting a flush copies
+/// just the dirty spans into it and the DMA reads from there, so the caller's
+/// framebuffer is the back buffer: it can be redrawn at once, and each flush
+/// shows one whole frame rather than whatever was drawn mid-transfer.
+class Ssd1306 {
+public:
+    /// Called from the bus IRQ when a flush has finished.
+    using FlushCallback = void (*)(bool ok, void* ctx);
+
+    /// Payload bytes per bulk transaction: ~0.8 ms of bus time at 400 kHz.
+    static constexpr unsigned kChunkBytes = 32;
+
+    Ssd1306(I2cBus& bus, uint8_t address);
+
+    /// Sends the power-up command sequence (blocking).
+    [[nodiscard]] bool init();
+    CoTask init_async();
+
+    /// init() without the final display-on, so a first frame can replace
+    /// GDDRAM's power-up noise before anything lights; display_on() ends it.
+    [[nodiscard]] bool init_dark();
+    [[nodiscard]] bool display_on();
+
+    [[nodiscard]] bool send_commands(const uint8_t* cmds, size_t len);
+    /// Awaitable form of send_commands(); `cmds` must outlive the await.
+    I2cAwait command_async(const uint8_t* cmds, size_t len);
+
+    /// Starts pushing every dirty window of `fb` as it is now. `fb` is free
+    /// to change as soon as this returns; those changes mark it dirty again
+    /// for the next flush. Returns false if a flush is already running or
+    /// nothing is dirty.
+    bool flush(Framebuffer& fb, FlushCallback cb, void* ctx);
+
+    bool flushing() const { return flushing_; }
+
+    /// True once for each failed flush. DS1 is then in an unknown state, so
+    /// the caller marks its framebuffer all dirty. The failure is reported
+    /// from the bus IRQ on core 0, while the framebuffer belongs to the
+    /// flushing core, so the driver leaves that to the caller.
+    bool take_failed() { return failed_.exchange(false, std::memory_order_acq_rel); }
+
+    /// Payload bytes moved by the last completed flush, for benchmarks.
+    uint32_t last_flush_bytes() const { return last_flush_bytes_; }
+
+private:
+    static void on_chunk_done(I2cTransaction& txn, bool ok, void* ctx);
+    bool next_dirty_page();
+    // Requires next_dirty_page() to have returned true.
+    bool submit_next_chunk();
+    void finish(bool ok);
+
+    I2cBus& bus_;
+    uint8_t address_;
+    I2cTransaction txn_;
+    uint8_t header_[13] = {};
+
+    // What DS1 shows once the current flush completes; only the dirty
+    // spans are ever copied in, and only while no flush is running.
+    uint8_t front_[Framebuffer::kPages][Framebuffer::kWidth] = {};
+    Framebuffer::DirtySpan spans_[Framebuffer::kPages] = {};
+    unsigned page_ = 0;
+    unsigned col_ = 0;
+    uint32_t bytes_ = 0;
+    uint32_t last_flush_bytes_ = 0;
+    volatile bool flushing_ = false;
+    std::atomic<bool> failed_{false};
+    FlushCallback cb_ = nullptr;
+    void* ctx_ = nullptr;
+};
+
+}  // namespace tilt
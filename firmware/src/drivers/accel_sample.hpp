@@ -0,0 +1,15 @@
+// Raw LIS3DH sample type, shared by the driver and the code that consumes it.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt {
+
+/// One accelerometer sample, left-justified 16-bit counts as read from OUT_x.
+struct AccelSample {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+};
+
+}  // namespace tilt
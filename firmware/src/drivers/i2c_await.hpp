@@ -0,0 +1,87 @@
+// Awaitable I2C transactions for CoTask driver sequences.
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "drivers/i2c_bus.hpp"
+
+namespace tilt {
+
+/// One bus transaction as a co_await expression yielding the success flag.
+///
+/// The awaiter carries its own I2cTransaction and up to kInlineBytes of
+/// write data, so `co_await I2cAwait(bus, addr, prio, {reg, value})` needs
+/// no buffer that outlives the statement. It lives in the awaiting
+/// coroutine's frame, which never moves, so the transaction can point into
+/// it. The bus keeps scheduling other traffic while the coroutine waits.
+class I2cAwait {
+public:
+    static constexpr size_t kInlineBytes = 4;
+
+    /// Writes `bytes` (copied) and optionally reads `read_len` into `read`.
+    I2cAwait(I2cBus& bus, uint8_t address, I2cPriority priority,
+             std::initializer_list<uint8_t> bytes, uint8_t* read = nullptr, size_t read_len = 0)
+        : bus_(bus) {
+        size_t n = 0;
+        for (uint8_t b : bytes) {
+            if (n < kInlineBytes) {
+                inline_[n++] = b;
+            }
+        }
+        txn_.address = address;
+        txn_.priority = priority;
+        txn_.write_len = n;
+        txn_.read = read;
+        txn_.read_len = read_len;
+    }
+
+    /// Wraps caller-owned buffers, e.g. a control-byte header plus a
+    /// command table in flash.
+    I2cAwait(I2cBus& bus, uint8_t address, I2cPriority priority, const uint8_t* header,
+             size_t header_len, const uint8_t* write, size_t write_len)
+        : bus_(bus), external_(write) {
+        txn_.address = address;
+        txn_.priority = priority;
+        txn_.header = header;
+        txn_.header_len = header_len;
+        txn_.write_len = write_len;
+    }
+
+    I2cAwait(const I2cAwait&) = delete;
+    I2cAwait& operator=(const I2cAwait&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        // Fixed up here rather than in the constructor: this is the
+        // address the awaiter will keep until it resumes.
+        handle_ = h;
+        txn_.write = external_ != nullptr ? external_ : inline_;
+        txn_.callback = &I2cAwait::on_done;
+        txn_.ctx = this;
+        // After a successful submit the callback may already have resumed
+        // (and finished) the coroutine; nothing here may touch `this`.
+        return bus_.submit(txn_);
+    }
+
+    bool await_resume() const noexcept { return ok_; }
+
+private:
+    static void on_done(I2cTransaction&, bool ok, void* ctx) {
+        auto* self = static_cast<I2cAwait*>(ctx);
+        self->ok_ = ok;
+        self->handle_.resume();
+    }
+
+    I2cBus& bus_;
+    I2cTransaction txn_;
+    std::coroutine_handle<> handle_;
+    const uint8_t* external_ = nullptr;
+    uint8_t inline_[kInlineBytes] = {};
+    bool ok_ = false;
+};
+
+}  // namespace tilt
@@ -0,0 +1,157 @@
+#include "drivers/i2c_bus.hpp"
+
+#include "diag/trace.hpp"
+#include "hardware/sync.h"
+
+namespace tilt {
+
+namespace {
+
+struct BlockingWait {
+    volatile bool done = false;
+    volatile bool ok = false;
+};
+
+void on_blocking_done(I2cTransaction&, bool ok, void* ctx) {
+    auto* wait = static_cast<BlockingWait*>(ctx);
+    wait->ok = ok;
+    wait->done = true;
+    __sev();
+}
+
+}  // namespace
+
+I2cBus::I2cBus(I2cDma& dma) : dma_(dma) {
+    critical_section_init(&lock_);
+}
+
+bool I2cBus::submit(I2cTransaction& txn) {
+    const size_t total = txn.header_len + txn.write_len + txn.read_len;
+    if (total == 0 || total > I2cDma::kMaxTransfer ||
+        static_cast<unsigned>(txn.priority) >= kI2cPriorityCount) {
+        return false;
+    }
+    critical_section_enter_blocking(&lock_);
+    if (txn.queued) {
+        critical_section_exit(&lock_);
+        return false;
+    }
+    txn.queued = true;
+    txn.next = nullptr;
+    Queue& q = queues_[static_cast<unsigned>(txn.priority)];
+    if (q.tail != nullptr) {
+        q.tail->next = &txn;
+    } else {
+        q.head = &txn;
+    }
+    q.tail = &txn;
+    I2cTransaction* rejected = nullptr;
+    if (active_ == nullptr) {
+        rejected = start_next_locked();
+    }
+    critical_section_exit(&lock_);
+    fail_all(rejected);
+    return true;
+}
+
+bool I2cBus::transfer_blocking(I2cTransaction& txn) {
+    BlockingWait wait;
+    txn.callback = &on_blocking_done;
+    txn.ctx = &wait;
+    if (!submit(txn)) {
+        return false;
+    }
+    while (!wait.done) {
+        __wfe();
+    }
+    return wait.ok;
+}
+
+bool I2cBus::write_blocking(uint8_t address, const uint8_t* data, size_t len,
+                            I2cPriority priority) {
+    I2cTransaction txn;
+    txn.address = address;
+    txn.priority = priority;
+    txn.write = data;
+    txn.write_len = len;
+    return transfer_blocking(txn);
+}
+
+bool I2cBus::write_read_blocking(uint8_t address, const uint8_t* wr, size_t wr_len, uint8_t* rd,
+                                 size_t rd_len, I2cPriority priority) {
+    I2cTransaction txn;
+    txn.address = address;
+    txn.priority = priority;
+    txn.write = wr;
+    txn.write_len = wr_len;
+    txn.read = rd;
+    txn.read_len = rd_len;
+    return transfer_blocking(txn);
+}
+
+I2cTransaction* I2cBus::pop_next() {
+    for (Queue& q : queues_) {
+        if (I2cTransaction* txn = q.head) {
+            q.head = txn->next;
+            if (q.head == nullptr) {
+                q.tail = nullptr;
+            }
+            txn->next = nullptr;
+            return txn;
+        }
+    }
+    return nullptr;
+}
+
+I2cTransaction* I2cBus::start_next_locked() {
+    I2cTransaction* rejected = nullptr;
+    while (I2cTransaction* txn = pop_next()) {
+        active_ = txn;
+        if (dma_.start(txn->address, txn->header, txn->header_len, txn->write, txn->write_len,
+                       txn->read, txn->read_len, &I2cBus::on_dma_done, this)) {
+            trace::record(trace::Event::kI2cStart,
+                          static_cast<uint16_t>(txn->address |
+                                                static_cast<unsigned>(txn->priority) << 8));
+            break;
+        }
+        // submit() already validated the geometry, so this only happens if
+        // the engine was somehow busy; the caller fails these outside the lock.
+        active_ = nullptr;
+        txn->next = rejected;
+        rejected = txn;
+    }
+    return rejected;
+}
+
+void I2cBus::fail_all(I2cTransaction* list) {
+    while (list != nullptr) {
+        I2cTransaction* txn = list;
+        list = txn->next;
+        complete(*txn, false);
+    }
+}
+
+void I2cBus::complete(I2cTransaction& txn, bool ok) {
+    txn.next = nullptr;
+    txn.queued = false;
+    if (txn.callback != nullptr) {
+        txn.callback(txn, ok, txn.ctx);
+    }
+}
+
+void I2cBus::on_dma_done(bool ok, void* ctx) {
+    auto* self = static_cast<I2cBus*>(ctx);
+    trace::record(trace::Event::kI2cDone, ok);
+    critical_section_enter_blocking(&self->lock_);
+    I2cTransaction* done = self->active_;
+    self->active_ = nullptr;
+    I2cTransaction* rejected = self->start_next_locked();
+    critical_section_exit(&self->lock_);
+
+    if (done != nullptr) {
+        complete(*done, ok);
+    }
+    fail_all(rejected);
+}
+
+}  // namespace tilt
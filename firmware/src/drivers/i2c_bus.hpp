@@ -0,0 +1,90 @@
+// Prioritised, asynchronous transaction scheduler for the shared I2C bus.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "drivers/i2c_dma.hpp"
+#include "pico/critical_section.h"
+
+namespace tilt {
+
+/// Lower value wins. Sensor traffic is latency-critical and short; display
+/// pushes are long and are split by their driver into chunks so that a
+/// queued sensor read never waits for more than one chunk.
+enum class I2cPriority : uint8_t {
+    kSensor = 0,
+    kControl = 1,
+    kBulk = 2,
+};
+
+inline constexpr unsigned kI2cPriorityCount = 3;
+
+/// One queued bus operation. Owned by the caller, which must keep it and its
+/// buffers alive until the callback has run; the bus never copies or allocates.
+struct I2cTransaction {
+    using Callback = void (*)(I2cTransaction& txn, bool ok, void* ctx);
+
+    uint8_t address = 0;
+    I2cPriority priority = I2cPriority::kControl;
+    /// Optional bytes sent ahead of `write` (register address, control byte).
+    const uint8_t* header = nullptr;
+    size_t header_len = 0;
+    const uint8_t* write = nullptr;
+    size_t write_len = 0;
+    uint8_t* read = nullptr;
+    size_t read_len = 0;
+    Callback callback = nullptr;
+    void* ctx = nullptr;
+
+    // Scheduler bookkeeping.
+    I2cTransaction* next = nullptr;
+    volatile bool queued = false;
+};
+
+/// Serialises U2 and DS1 traffic on GPIO4/GPIO5.
+///
+/// Transactions queue per priority level in FIFO order; whenever the DMA
+/// engine goes idle the head of the most urgent non-empty queue starts,
+/// directly from the completion interrupt. Callbacks run in IRQ context
+/// after the next transaction has already been started.
+class I2cBus {
+public:
+    explicit I2cBus(I2cDma& dma);
+
+    /// Queues `txn`. Returns false if it is already queued or malformed.
+    /// Safe to call from either core and from transaction callbacks.
+    bool submit(I2cTransaction& txn);
+
+    /// Submits and sleeps until completion. Thread context only; intended
+    /// for one-off configuration writes, never for the steady-state path.
+    [[nodiscard]] bool transfer_blocking(I2cTransaction& txn);
+
+    [[nodiscard]] bool write_blocking(uint8_t address, const uint8_t* data, size_t len,
+                                      I2cPriority priority = I2cPriority::kControl);
+    [[nodiscard]] bool write_read_blocking(uint8_t address, const uint8_t* wr, size_t wr_len,
+                                           uint8_t* rd, size_t rd_len,
+                                           I2cPriority priority = I2cPriority::kControl);
+
+    bool idle() const { return active_ == nullptr; }
+
+private:
+    struct Queue {
+        I2cTransaction* head = nullptr;
+        I2cTransaction* tail = nullptr;
+    };
+
+    static void on_dma_done(bool ok, void* ctx);
+    static void fail_all(I2cTransaction* list);
+    static void complete(I2cTransaction& txn, bool ok);
+    // Caller holds lock_. Returns transactions the engine refused to start.
+    I2cTransaction* pop_next();
+    I2cTransaction* start_next_locked();
+
+    I2cDma& dma_;
+    critical_section_t lock_;
+    Queue queues_[kI2cPriorityCount];
+    I2cTransaction* volatile active_ = nullptr;
+};
+
+}  // namespace tilt
@@ -0,0 +1,128 @@
+#include "drivers/i2c_dma.hpp"
+
+#include "diag/trace.hpp"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+namespace tilt {
+
+I2cDma* I2cDma::instances_[2] = {nullptr, nullptr};
+
+bool I2cDma::init() {
+    const int tx = dma_claim_unused_channel(false);
+    const int rx = dma_claim_unused_channel(false);
+    if (tx < 0 || rx < 0) {
+        return false;
+    }
+    tx_chan_ = static_cast<unsigned>(tx);
+    rx_chan_ = static_cast<unsigned>(rx);
+
+    i2c_hw_t* hw = i2c_get_hw(i2c_);
+    hw->intr_mask = 0;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+
+    const unsigned index = i2c_hw_index(i2c_);
+    instances_[index] = this;
+    const unsigned irq = index == 0 ? I2C0_IRQ : I2C1_IRQ;
+    irq_set_exclusive_handler(irq, &I2cDma::irq_handler);
+    irq_set_enabled(irq, true);
+    return true;
+}
+
+bool I2cDma::start(uint8_t address, const uint8_t* hdr, size_t hdr_len, const uint8_t* wr,
+                   size_t wr_len, uint8_t* rd, size_t rd_len, DoneCallback cb, void* ctx) {
+    const size_t total = hdr_len + wr_len + rd_len;
+    if (busy_ || total == 0 || total > kMaxTransfer) {
+        return false;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < hdr_len; ++i) {
+        commands_[n++] = hdr[i];
+    }
+    for (size_t i = 0; i < wr_len; ++i) {
+        commands_[n++] = wr[i];
+    }
+    for (size_t i = 0; i < rd_len; ++i) {
+        uint16_t cmd = I2C_IC_DATA_CMD_CMD_BITS;
+        if (i == 0 && n > 0) {
+            cmd |= I2C_IC_DATA_CMD_RESTART_BITS;
+        }
+        commands_[n++] = cmd;
+    }
+    commands_[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    busy_ = true;
+    reading_ = rd_len > 0;
+    cb_ = cb;
+    ctx_ = ctx;
+
+    i2c_hw_t* hw = i2c_get_hw(i2c_);
+    hw->enable = 0;
+    hw->tar = address;
+    hw->enable = I2C_IC_ENABLE_ENABLE_BITS;
+    (void)hw->clr_tx_abrt;
+    (void)hw->clr_stop_det;
+
+    if (reading_) {
+        dma_channel_config rc = dma_channel_get_default_config(rx_chan_);
+        channel_config_set_transfer_data_size(&rc, DMA_SIZE_8);
+        channel_config_set_read_increment(&rc, false);
+        channel_config_set_write_increment(&rc, true);
+        channel_config_set_dreq(&rc, i2c_get_dreq(i2c_, false));
+        dma_channel_configure(rx_chan_, &rc, rd, &hw->data_cmd, rd_len, true);
+    }
+
+    dma_channel_config tc = dma_channel_get_default_config(tx_chan_);
+    channel_config_set_transfer_data_size(&tc, DMA_SIZE_16);
+    channel_config_set_read_increment(&tc, true);
+    channel_config_set_write_increment(&tc, false);
+    channel_config_set_dreq(&tc, i2c_get_dreq(i2c_, true));
+
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    dma_channel_configure(tx_chan_, &tc, &hw->data_cmd, commands_, n, true);
+    return true;
+}
+
+void I2cDma::irq_handler() {
+    trace::record(trace::Event::kIsrI2c);
+    for (I2cDma* self : instances_) {
+        if (self != nullptr && i2c_get_hw(self->i2c_)->intr_stat != 0) {
+            self->handle_irq();
+        }
+    }
+}
+
+void I2cDma::handle_irq() {
+    i2c_hw_t* hw = i2c_get_hw(i2c_);
+    const uint32_t stat = hw->intr_stat;
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        (void)hw->clr_tx_abrt;
+        (void)hw->clr_stop_det;
+        dma_channel_abort(tx_chan_);
+        if (reading_) {
+            dma_channel_abort(rx_chan_);
+        }
+        finish(false);
+        return;
+    }
+    if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        // STOP is only raised after the last byte has landed in the RX FIFO;
+        // the DMA needs at most a few cycles to move it out.
+        while (reading_ && dma_channel_is_busy(rx_chan_)) {
+            tight_loop_contents();
+        }
+        finish(true);
+    }
+}
+
+void I2cDma::finish(bool ok) {
+    i2c_get_hw(i2c_)->intr_mask = 0;
+    busy_ = false;
+    if (cb_ != nullptr) {
+        cb_(ok, ctx_);
+    }
+}
+
+}  // namespace tilt
@@ -0,0 +1,61 @@
+// DMA-driven I2C master transfers on the RP2040 DW_apb_i2c block.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "hardware/i2c.h"
+
+namespace tilt {
+
+/// Runs one I2C transaction at a time with the CPU out of the loop.
+///
+/// The controller is fed through IC_DATA_CMD: the TX DMA channel streams
+/// 16-bit command words (data byte plus CMD/STOP/RESTART flags; the APB
+/// replicates narrow writes across the 32-bit register) and, for reads, the
+/// RX DMA channel drains received bytes straight into the caller's buffer.
+/// Completion is signalled by the controller's STOP_DET/TX_ABRT interrupt,
+/// so a whole burst costs a single CPU wakeup.
+class I2cDma {
+public:
+    /// Called from the I2C IRQ once the transaction has finished; keep it short.
+    using DoneCallback = void (*)(bool ok, void* ctx);
+
+    /// Largest transaction in bytes, all phases combined.
+    static constexpr size_t kMaxTransfer = 260;
+
+    explicit I2cDma(i2c_inst_t* i2c) : i2c_(i2c) {}
+
+    /// Claims two DMA channels and installs the I2C IRQ handler.
+    [[nodiscard]] bool init();
+
+    /// Writes `hdr_len` header bytes followed by `wr_len` payload bytes, then
+    /// (if `rd_len` > 0) issues a repeated start and reads `rd_len` bytes into
+    /// `rd`. The header lets drivers prepend a register address or control
+    /// byte to a buffer they do not own. Both write buffers are copied before
+    /// returning; `rd` must stay valid until the callback runs.
+    [[nodiscard]] bool start(uint8_t address, const uint8_t* hdr, size_t hdr_len,
+                             const uint8_t* wr, size_t wr_len, uint8_t* rd, size_t rd_len,
+                             DoneCallback cb, void* ctx);
+
+    bool busy() const { return busy_; }
+    i2c_inst_t* i2c() const { return i2c_; }
+
+private:
+    static void irq_handler();
+    void handle_irq();
+    void finish(bool ok);
+
+    i2c_inst_t* i2c_;
+    unsigned tx_chan_ = 0;
+    unsigned rx_chan_ = 0;
+    bool reading_ = false;
+    volatile bool busy_ = false;
+    DoneCallback cb_ = nullptr;
+    void* ctx_ = nullptr;
+    uint16_t commands_[kMaxTransfer] = {};
+
+    static I2cDma* instances_[2];
+};
+
+}  // namespace tilt
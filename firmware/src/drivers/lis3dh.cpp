@@ -0,0 +1,61 @@
+#include "drivers/lis3dh.hpp"
+
+#include "drivers/lis3dh_regs.hpp"
+
+namespace tilt {
+
+bool Lis3dh::probe() {
+    uint8_t id = 0;
+    return read_reg(lis3dh::reg::kWhoAmI, id) && id == lis3dh::kWhoAmIValue;
+}
+
+bool Lis3dh::write_reg(uint8_t reg, uint8_t value) {
+    const uint8_t buf[2] = {reg, value};
+    return bus_.write_blocking(address_, buf, sizeof(buf), I2cPriority::kSensor);
+}
+
+bool Lis3dh::read_reg(uint8_t reg, uint8_t& value) {
+    return read_regs(reg, &value, 1);
+}
+
+bool Lis3dh::update_reg(uint8_t reg, uint8_t mask, uint8_t value) {
+    uint8_t current = 0;
+    if (!read_reg(reg, current)) {
+        return false;
+    }
+    return write_reg(reg, static_cast<uint8_t>((current & ~mask) | (value & mask)));
+}
+
+uint8_t Lis3dh::sub_address(uint8_t reg, size_t len) {
+    return len > 1 ? static_cast<uint8_t>(reg | lis3dh::reg::kAutoIncrement) : reg;
+}
+
+bool Lis3dh::read_regs(uint8_t reg, uint8_t* dst, size_t len) {
+    const uint8_t sub = sub_address(reg, len);
+    return bus_.write_read_blocking(address_, &sub, 1, dst, len, I2cPriority::kSensor);
+}
+
+bool Lis3dh::read_sample(AccelSample& sample) {
+    uint8_t raw[6];
+    if (!read_regs(lis3dh::reg::kOutXL, raw, sizeof(raw))) {
+        return false;
+    }
+    sample = decode_sample(raw);
+    return true;
+}
+
+CoTask Lis3dh::probe_async() {
+    uint8_t id = 0;
+    co_return co_await read_regs_async(lis3dh::reg::kWhoAmI, &id, 1) && id == lis3dh::kWhoAmIValue;
+}
+
+CoTask Lis3dh::update_reg_async(uint8_t reg, uint8_t mask, uint8_t value) {
+    uint8_t current = 0;
+    if (!co_await read_regs_async(reg, &current, 1)) {
+        co_return false;
+    }
+    const auto next = static_cast<uint8_t>((current & ~mask) | (value & mask));
+    co_return co_await write_reg_async(reg, next);
+}
+
+}  // namespace tilt
@@ -0,0 +1,58 @@
+// Register-level LIS3DH access over the shared I2C bus.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "drivers/accel_sample.hpp"
+#include "drivers/i2c_await.hpp"
+#include "drivers/i2c_bus.hpp"
+#include "sched/co_task.hpp"
+
+namespace tilt {
+
+/// Register helpers for configuration, blocking or awaitable. Steady-state
+/// reads go through I2cBus transactions directly so they never stall the
+/// caller; multi-step sequences are CoTasks built on the *_async forms.
+class Lis3dh {
+public:
+    Lis3dh(I2cBus& bus, uint8_t address) : bus_(bus), address_(address) {}
+
+    /// Checks WHO_AM_I; returns false if nothing answers at the address.
+    [[nodiscard]] bool probe();
+
+    [[nodiscard]] bool write_reg(uint8_t reg, uint8_t value);
+    [[nodiscard]] bool read_reg(uint8_t reg, uint8_t& value);
+    /// Read-modify-write of the bits selected by `mask`.
+    [[nodiscard]] bool update_reg(uint8_t reg, uint8_t mask, uint8_t value);
+    /// Burst read of consecutive registers starting at `reg`.
+    [[nodiscard]] bool read_regs(uint8_t reg, uint8_t* dst, size_t len);
+
+    [[nodiscard]] bool read_sample(AccelSample& sample);
+
+    I2cAwait write_reg_async(uint8_t reg, uint8_t value) {
+        return I2cAwait(bus_, address_, I2cPriority::kSensor, {reg, value});
+    }
+    I2cAwait read_regs_async(uint8_t reg, uint8_t* dst, size_t len) {
+        return I2cAwait(bus_, address_, I2cPriority::kSensor, {sub_address(reg, len)}, dst, len);
+    }
+    CoTask probe_async();
+    CoTask update_reg_async(uint8_t reg, uint8_t mask, uint8_t value);
+
+    static AccelSample decode_sample(const uint8_t* raw) {
+        return AccelSample{static_cast<int16_t>(raw[0] | (raw[1] << 8)),
+                           static_cast<int16_t>(raw[2] | (raw[3] << 8)),
+                           static_cast<int16_t>(raw[4] | (raw[5] << 8))};
+    }
+
+    I2cBus& bus() const { return bus_; }
+    uint8_t address() const { return address_; }
+
+private:
+    static uint8_t sub_address(uint8_t reg, size_t len);
+
+    I2cBus& bus_;
+    uint8_t address_;
+};
+
+}  // namespace tilt
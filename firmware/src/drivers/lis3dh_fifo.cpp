@@ -0,0 +1,129 @@
+#include "drivers/lis3dh_fifo.hpp"
+
+#include "drivers/lis3dh_regs.hpp"
+
+namespace tilt {
+
+namespace {
+constexpr uint8_t kFifoSrcOverrun = 1u << 6;
+constexpr uint8_t kFifoSrcLevelMask = 0x1F;
+}  // namespace
+
+Lis3dhFifo::Lis3dhFifo(Lis3dh& accel) : accel_(accel) {
+    src_sub_ = lis3dh::reg::kFifoSrc;
+    src_txn_.address = accel.address();
+    src_txn_.priority = I2cPriority::kSensor;
+    src_txn_.write = &src_sub_;
+    src_txn_.write_len = 1;
+    src_txn_.read = &fifo_src_;
+    src_txn_.read_len = 1;
+    src_txn_.callback = &Lis3dhFifo::on_src_done;
+    src_txn_.ctx = this;
+
+    data_sub_ = lis3dh::reg::kOutXL | lis3dh::reg::kAutoIncrement;
+    data_txn_.address = accel.address();
+    data_txn_.priority = I2cPriority::kSensor;
+    data_txn_.write = &data_sub_;
+    data_txn_.write_len = 1;
+    data_txn_.read = raw_;
+    data_txn_.callback = &Lis3dhFifo::on_data_done;
+    data_txn_.ctx = this;
+}
+
+bool Lis3dhFifo::enable(FifoMode mode, uint8_t watermark) {
+    return sync_wait(enable_async(mode, watermark));
+}
+
+CoTask Lis3dhFifo::enable_async(FifoMode mode, uint8_t watermark) {
+    using namespace lis3dh;
+    if (watermark == 0 || watermark >= AccelBatch::kCapacity) {
+        co_return false;
+    }
+    // Passing through bypass resets the FIFO contents and overrun flag.
+    const uint8_t fifo_ctrl = static_cast<uint8_t>((static_cast<uint8_t>(mode) << 6) | watermark);
+    const bool ok = co_await accel_.write_reg_async(reg::kFifoCtrl, 0) &&
+                    co_await accel_.update_reg_async(reg::kCtrlReg5, kCtrl5FifoEnable,
+                                                     kCtrl5FifoEnable) &&
+                    co_await accel_.write_reg_async(reg::kFifoCtrl, fifo_ctrl) &&
+                    co_await accel_.update_reg_async(reg::kCtrlReg3, kCtrl3I1Wtm, kCtrl3I1Wtm);
+    if (ok) {
+        mode_ = mode;
+    }
+    co_return ok;
+}
+
+CoTask Lis3dhFifo::set_watermark_async(uint8_t watermark) {
+    if (!enabled() || watermark == 0 || watermark >= AccelBatch::kCapacity) {
+        co_return false;
+    }
+    const uint8_t fifo_ctrl = static_cast<uint8_t>((static_cast<uint8_t>(mode_) << 6) | watermark);
+    co_return co_await accel_.write_reg_async(lis3dh::reg::kFifoCtrl, fifo_ctrl);
+}
+
+bool Lis3dhFifo::disable() {
+    using namespace lis3dh;
+    mode_ = FifoMode::kBypass;
+    return accel_.update_reg(reg::kCtrlReg3, kCtrl3I1Wtm, 0) &&
+           accel_.write_reg(reg::kFifoCtrl, 0) &&
+           accel_.update_reg(reg::kCtrlReg5, kCtrl5FifoEnable, 0);
+}
+
+bool Lis3dhFifo::start_drain(BatchCallback cb, void* ctx) {
+    if (draining_ || !enabled()) {
+        return false;
+    }
+    cb_ = cb;
+    ctx_ = ctx;
+    draining_ = true;
+    if (!accel_.bus().submit(src_txn_)) {
+        draining_ = false;
+        return false;
+    }
+    return true;
+}
+
+void Lis3dhFifo::on_src_done(I2cTransaction&, bool ok, void* ctx) {
+    auto* self = static_cast<Lis3dhFifo*>(ctx);
+    if (!ok) {
+        self->complete(false);
+        return;
+    }
+    const uint8_t src = self->fifo_src_;
+    // FSS saturates at 31; with the overrun flag set the FIFO holds all 32.
+    unsigned level = src & kFifoSrcLevelMask;
+    if (src & kFifoSrcOverrun) {
+        level = AccelBatch::kCapacity;
+    }
+    self->batch_.overrun = (src & kFifoSrcOverrun) != 0;
+    self->batch_.count = static_cast<uint8_t>(level);
+    if (level == 0) {
+        self->complete(true);
+        return;
+    }
+    self->data_txn_.read_len = level * 6;
+    if (!self->accel_.bus().submit(self->data_txn_)) {
+        self->complete(false);
+    }
+}
+
+void Lis3dhFifo::on_data_done(I2cTransaction&, bool ok, void* ctx) {
+    auto* self = static_cast<Lis3dhFifo*>(ctx);
+    if (ok) {
+        for (unsigned i = 0; i < self->batch_.count; ++i) {
+            self->batch_.samples[i] = Lis3dh::decode_sample(&self->raw_[i * 6]);
+        }
+    }
+    self->complete(ok);
+}
+
+void Lis3dhFifo::complete(bool ok) {
+    if (!ok) {
+        batch_.count = 0;
+    }
+    draining_ = false;
+    if (cb_ != nullptr) {
+        cb_(batch_, ok, ctx_);
+    }
+}
+
+}  // namespace tilt
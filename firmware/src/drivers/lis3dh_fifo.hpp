@@ -0,0 +1,81 @@
+// LIS3DH 32-level FIFO drained in single DMA bursts.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "drivers/i2c_bus.hpp"
+#include "drivers/lis3dh.hpp"
+#include "sched/co_task.hpp"
+
+namespace tilt {
+
+enum class FifoMode : uint8_t {
+    kBypass = 0,
+    kFifo = 1,
+    kStream = 2,
+    kStreamToFifo = 3,
+};
+
+struct AccelBatch {
+    static constexpr unsigned kCapacity = 32;
+
+    std::array<AccelSample, kCapacity> samples;
+    uint8_t count;
+    /// The FIFO filled before it was drained; older samples were lost.
+    bool overrun;
+};
+
+/// Batch reader for the LIS3DH FIFO.
+///
+/// A drain is two DMA transactions: FIFO_SRC to learn the fill level, then
+/// one auto-increment burst over OUT_X_L..OUT_Z_H. With the FIFO enabled
+/// the sub-address wraps from OUT_Z_H back to OUT_X_L, so the burst pops
+/// `level` samples in one go. In watermark mode the sensor raises INT1 when
+/// the level reaches the threshold, which is the cue to call start_drain().
+/// Both transactions run at sensor priority on the shared bus.
+class Lis3dhFifo {
+public:
+    /// Called from the bus IRQ when a drain finishes (or fails, count == 0).
+    using BatchCallback = void (*)(const AccelBatch& batch, bool ok, void* ctx);
+
+    explicit Lis3dhFifo(Lis3dh& accel);
+
+    /// Enables the FIFO and routes its watermark to INT1 (blocking setup).
+    /// `watermark` is in samples, 1..31.
+    [[nodiscard]] bool enable(FifoMode mode, uint8_t watermark);
+    /// The same sequence without holding the caller.
+    CoTask enable_async(FifoMode mode, uint8_t watermark);
+    [[nodiscard]] bool disable();
+
+    /// Moves the watermark of an enabled FIFO in one write, keeping its
+    /// contents. A level already past the new mark raises WTM without an
+    /// edge, so the caller re-checks the line afterwards.
+    CoTask set_watermark_async(uint8_t watermark);
+
+    /// Starts an asynchronous drain of everything currently queued.
+    [[nodiscard]] bool start_drain(BatchCallback cb, void* ctx);
+
+    bool draining() const { return draining_; }
+    bool enabled() const { return mode_ != FifoMode::kBypass; }
+
+private:
+    static void on_src_done(I2cTransaction& txn, bool ok, void* ctx);
+    static void on_data_done(I2cTransaction& txn, bool ok, void* ctx);
+    void complete(bool ok);
+
+    Lis3dh& accel_;
+    I2cTransaction src_txn_;
+    I2cTransaction data_txn_;
+    uint8_t src_sub_ = 0;
+    uint8_t data_sub_ = 0;
+    FifoMode mode_ = FifoMode::kBypass;
+    volatile bool draining_ = false;
+    uint8_t fifo_src_ = 0;
+    BatchCallback cb_ = nullptr;
+    void* ctx_ = nullptr;
+    AccelBatch batch_{};
+    alignas(4) uint8_t raw_[AccelBatch::kCapacity * 6] = {};
+};
+
+}  // namespace tilt
@@ -0,0 +1,122 @@
+// LIS3DH register map and bit fields (ST DocID17530).
+#pragma once
+
+#include <cstdint>
+
+namespace tilt::lis3dh {
+
+namespace reg {
+inline constexpr uint8_t kWhoAmI = 0x0F;
+inline constexpr uint8_t kCtrlReg0 = 0x1E;
+inline constexpr uint8_t kTempCfg = 0x1F;
+inline constexpr uint8_t kCtrlReg1 = 0x20;
+inline constexpr uint8_t kCtrlReg2 = 0x21;
+inline constexpr uint8_t kCtrlReg3 = 0x22;
+inline constexpr uint8_t kCtrlReg4 = 0x23;
+inline constexpr uint8_t kCtrlReg5 = 0x24;
+inline constexpr uint8_t kCtrlReg6 = 0x25;
+inline constexpr uint8_t kReference = 0x26;
+inline constexpr uint8_t kStatus = 0x27;
+inline constexpr uint8_t kOutXL = 0x28;
+inline constexpr uint8_t kFifoCtrl = 0x2E;
+inline constexpr uint8_t kFifoSrc = 0x2F;
+inline constexpr uint8_t kInt1Cfg = 0x30;
+inline constexpr uint8_t kInt1Src = 0x31;
+inline constexpr uint8_t kInt1Ths = 0x32;
+inline constexpr uint8_t kInt1Duration = 0x33;
+inline constexpr uint8_t kInt2Cfg = 0x34;
+inline constexpr uint8_t kInt2Src = 0x35;
+inline constexpr uint8_t kInt2Ths = 0x36;
+inline constexpr uint8_t kInt2Duration = 0x37;
+inline constexpr uint8_t kClickCfg = 0x38;
+inline constexpr uint8_t kClickSrc = 0x39;
+inline constexpr uint8_t kClickThs = 0x3A;
+inline constexpr uint8_t kTimeLimit = 0x3B;
+inline constexpr uint8_t kTimeLatency = 0x3C;
+inline constexpr uint8_t kTimeWindow = 0x3D;
+inline constexpr uint8_t kActThs = 0x3E;
+inline constexpr uint8_t kActDur = 0x3F;
+
+// Setting the MSB of the sub-address enables register auto-increment.
+inline constexpr uint8_t kAutoIncrement = 0x80;
+}  // namespace reg
+
+inline constexpr uint8_t kWhoAmIValue = 0x33;
+
+// CTRL_REG1
+inline constexpr uint8_t kCtrl1LowPower = 1u << 3;
+inline constexpr uint8_t kCtrl1XyzEnable = 0x07;
+
+enum class Odr : uint8_t {
+    kPowerDown = 0x0,
+    k1Hz = 0x1,
+    k10Hz = 0x2,
+    k25Hz = 0x3,
+    k50Hz = 0x4,
+    k100Hz = 0x5,
+    k200Hz = 0x6,
+    k400Hz = 0x7,
+};
+
+constexpr uint8_t ctrl1(Odr odr, bool low_power) {
+    return static_cast<uint8_t>((static_cast<uint8_t>(odr) << 4) |
+                                (low_power ? kCtrl1LowPower : 0) | kCtrl1XyzEnable);
+}
+
+// CTRL_REG2: high-pass filter on the click engine and IA2 only; the 6D
+// engine and the FIFO keep gravity.
+inline constexpr uint8_t kCtrl2HpClick = 1u << 2;
+inline constexpr uint8_t kCtrl2HpIa2 = 1u << 1;
+
+// CTRL_REG3: routing to INT1
+inline constexpr uint8_t kCtrl3I1Click = 1u << 7;
+inline constexpr uint8_t kCtrl3I1Ia1 = 1u << 6;
+inline constexpr uint8_t kCtrl3I1Ia2 = 1u << 5;
+inline constexpr uint8_t kCtrl3I1Wtm = 1u << 2;
+inline constexpr uint8_t kCtrl3I1Overrun = 1u << 1;
+
+// CTRL_REG4
+inline constexpr uint8_t kCtrl4Bdu = 1u << 7;
+inline constexpr uint8_t kCtrl4Fs2g = 0x00;
+inline constexpr uint8_t kCtrl4HighRes = 1u << 3;
+
+// CTRL_REG5
+inline constexpr uint8_t kCtrl5Boot = 1u << 7;
+inline constexpr uint8_t kCtrl5FifoEnable = 1u << 6;
+inline constexpr uint8_t kCtrl5LatchInt1 = 1u << 3;
+inline constexpr uint8_t kCtrl5LatchInt2 = 1u << 1;
+
+// CTRL_REG6: routing to INT2
+inline constexpr uint8_t kCtrl6I2Click = 1u << 7;
+inline constexpr uint8_t kCtrl6I2Ia1 = 1u << 6;
+inline constexpr uint8_t kCtrl6I2Ia2 = 1u << 5;
+inline constexpr uint8_t kCtrl6I2Act = 1u << 3;
+
+// STATUS_REG
+inline constexpr uint8_t kStatusXyzReady = 1u << 3;
+
+// INTx_CFG
+inline constexpr uint8_t kIntCfgAoi = 1u << 7;
+inline constexpr uint8_t kIntCfg6d = 1u << 6;
+inline constexpr uint8_t kIntCfgAllAxes = 0x3F;
+inline constexpr uint8_t kIntCfgHighAxes = 0x2A;  // ZHIE | YHIE | XHIE
+
+// INTx_SRC
+inline constexpr uint8_t kIntSrcActive = 1u << 6;
+inline constexpr uint8_t kIntSrcZHigh = 1u << 5;
+inline constexpr uint8_t kIntSrcZLow = 1u << 4;
+inline constexpr uint8_t kIntSrcYHigh = 1u << 3;
+inline constexpr uint8_t kIntSrcYLow = 1u << 2;
+inline constexpr uint8_t kIntSrcXHigh = 1u << 1;
+inline constexpr uint8_t kIntSrcXLow = 1u << 0;
+
+// CLICK_CFG / CLICK_THS
+inline constexpr uint8_t kClickCfgDoubleAll = 0x2A;  // ZD | YD | XD
+inline constexpr uint8_t kClickThsLatch = 1u << 7;
+
+// CLICK_SRC
+inline constexpr uint8_t kClickSrcActive = 1u << 6;
+inline constexpr uint8_t kClickSrcDouble = 1u << 5;
+inline constexpr uint8_t kClickSrcSingle = 1u << 4;
+
+}  // namespace tilt::lis3dh
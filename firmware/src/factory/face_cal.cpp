@@ -0,0 +1,217 @@
+// Factory calibration: records gravity on each face and stores the mount.
+//
+// Built as a separate executable (see README) and flashed once per unit
+// after final assembly, before the product firmware; the config sector
+// survives the reflash. The operator rests the closed cube on each face in
+// turn, in the order printed on stdio (+X, -X, +Y, -Y, +Z, -Z, by the
+// labels on the shell). A face is taken once the cube has rested for a
+// second on an orientation at least 45 degrees from the last, with the
+// start chirp. After the sixth, solve_mount() turns the six readings into
+// the Q14 mount matrix, which is written into the config blob's
+// calibration with everything else kept; the product classifier then
+// works in cube axes. One `key=value` line per step goes to stdio for the
+// fixture log, and the cancel chirp marks a rejected set, which restarts
+// from +X.
+
+#include <cstdint>
+#include <cstdio>
+
+#include "audio/melodies.hpp"
+#include "audio/pio_buzzer.hpp"
+#include "board.hpp"
+#include "drivers/i2c_bus.hpp"
+#include "drivers/i2c_dma.hpp"
+#include "drivers/lis3dh.hpp"
+#include "drivers/lis3dh_regs.hpp"
+#include "hardware/i2c.h"
+#include "orientation/mount.hpp"
+#include "pico/stdlib.h"
+#include "storage/config_blob.hpp"
+#include "storage/config_store.hpp"
+
+namespace {
+
+constexpr const tilt::board::BoardConfig& kBoard = tilt::board::kBoard;
+
+// 25 samples at 100 Hz per window, four still windows per face.
+constexpr unsigned kWindowSamples = 25;
+constexpr unsigned kStillWindows = 4;
+// Largest per-axis excursion from the window mean that still counts as
+// resting, in 12-bit counts (mg).
+constexpr int32_t kStillSpread = 40;
+
+constexpr tilt::MountLimits kLimits = tilt::make_mount_limits(10.0);
+
+constexpr const char* kFaceNames[tilt::kFaceCount] = {"+X", "-X", "+Y", "-Y", "+Z", "-Z"};
+
+constexpr const char* error_name(tilt::MountError error) {
+    switch (error) {
+        case tilt::MountError::kNone:
+            return "none";
+        case tilt::MountError::kMagnitude:
+            return "magnitude";
+        case tilt::MountError::kSkew:
+            return "skew";
+        case tilt::MountError::kMirrored:
+            return "mirrored";
+    }
+    return "unknown";
+}
+
+bool next_sample(tilt::Lis3dh& accel, int32_t& x, int32_t& y, int32_t& z) {
+    uint8_t status = 0;
+    do {
+        if (!accel.read_reg(tilt::lis3dh::reg::kStatus, status)) {
+            return false;
+        }
+    } while (!(status & tilt::lis3dh::kStatusXyzReady));
+    tilt::AccelSample s{};
+    if (!accel.read_sample(s)) {
+        return false;
+    }
+    x = s.x >> 4;
+    y = s.y >> 4;
+    z = s.z >> 4;
+    return true;
+}
+
+// Mean of one window, or false if the cube moved during it.
+bool still_window(tilt::Lis3dh& accel, tilt::Gravity& mean) {
+    int32_t xs[kWindowSamples];
+    int32_t ys[kWindowSamples];
+    int32_t zs[kWindowSamples];
+    int32_t sx = 0;
+    int32_t sy = 0;
+    int32_t sz = 0;
+    for (unsigned i = 0; i < kWindowSamples; ++i) {
+        if (!next_sample(accel, xs[i], ys[i], zs[i])) {
+            return false;
+        }
+        sx += xs[i];
+        sy += ys[i];
+        sz += zs[i];
+    }
+    mean = tilt::Gravity{sx / int32_t{kWindowSamples}, sy / int32_t{kWindowSamples},
+                         sz / int32_t{kWindowSamples}};
+    const auto far = [](int32_t v, int32_t m) {
+        return v - m > kStillSpread || m - v > kStillSpread;
+    };
+    for (unsigned i = 0; i < kWindowSamples; ++i) {
+        if (far(xs[i], mean.x) || far(ys[i], mean.y) || far(zs[i], mean.z)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int64_t dot(const tilt::Gravity& a, const tilt::Gravity& b) {
+    return int64_t{a.x} * b.x + int64_t{a.y} * b.y + int64_t{a.z} * b.z;
+}
+
+// Within 45 degrees: dot > 0 and cos^2 > 1/2.
+bool same_direction(const tilt::Gravity& a, const tilt::Gravity& b) {
+    const int64_t d = dot(a, b);
+    return d > 0 && 2 * d * d > dot(a, a) * dot(b, b);
+}
+
+// Waits for kStillWindows consecutive still windows that agree with each
+// other and point away from `previous` (if any), and averages them.
+tilt::Gravity capture(tilt::Lis3dh& accel, const tilt::Gravity* previous) {
+    for (;;) {
+        tilt::Gravity sum{0, 0, 0};
+        tilt::Gravity first{};
+        unsigned still = 0;
+        tilt::Gravity window{};
+        while (still < kStillWindows && still_window(accel, window) &&
+               (previous == nullptr || !same_direction(window, *previous)) &&
+               (still == 0 || same_direction(window, first))) {
+            if (still == 0) {
+                first = window;
+            }
+            sum.x += window.x;
+            sum.y += window.y;
+            sum.z += window.z;
+            ++still;
+        }
+        if (still == kStillWindows) {
+            return tilt::Gravity{sum.x / int32_t{kStillWindows}, sum.y / int32_t{kStillWindows},
+                                 sum.z / int32_t{kStillWindows}};
+        }
+    }
+}
+
+bool store(tilt::ConfigStore& config, const tilt::Mount& mount) {
+    static tilt::ConfigBlob blob;
+    blob = config.active();
+    blob.calibration.mount = mount.m;
+    blob.calibration.mount_set = 1;
+    blob.header.crc = tilt::config_crc(blob);
+    return config.program(blob) && config.active().calibration.mount_set == 1;
+}
+
+}  // namespace
+
+int main() {
+    stdio_init_all();
+    i2c_init(i2c0, kBoard.i2c_baud_hz);
+    gpio_set_function(kBoard.i2c_sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(kBoard.i2c_scl_pin, GPIO_FUNC_I2C);
+
+    static tilt::I2cDma i2c_dma(i2c0);
+    static tilt::I2cBus bus(i2c_dma);
+    static tilt::Lis3dh accel(bus, kBoard.accel_address);
+    static tilt::PioBuzzer buzzer(pio0, kBoard.buzzer_pin);
+    static tilt::ConfigStore config;
+    if (!i2c_dma.init()) {
+        return 1;
+    }
+    const bool buzzer_ok = buzzer.init();
+    const bool from_flash = config.init();
+
+    sleep_ms(2000);
+    // 100 Hz, high resolution at +/-2 g: 1 mg per count, as the classifier
+    // sees it.
+    using namespace tilt::lis3dh;
+    const bool accel_ok = accel.probe() &&
+                          accel.write_reg(reg::kCtrlReg1, ctrl1(Odr::k100Hz, false)) &&
+                          accel.write_reg(reg::kCtrlReg4, kCtrl4Bdu | kCtrl4Fs2g | kCtrl4HighRes);
+    printf("face_cal=start board=\"%s\" accel=%d buzzer=%d config=%s\n", kBoard.name,
+           accel_ok, buzzer_ok, from_flash ? "flash" : "default");
+    if (!accel_ok) {
+        printf("face_cal=end status=no_accel\n");
+        return 1;
+    }
+
+    for (;;) {
+        tilt::Gravity up[tilt::kFaceCount] = {};
+        for (unsigned f = 0; f < tilt::kFaceCount; ++f) {
+            printf("face_cal=place face=%s step=%u\n", kFaceNames[f], f + 1);
+            up[f] = capture(accel, f == 0 ? nullptr : &up[f - 1]);
+            (void)buzzer.play(tilt::melodies::kStart);
+            printf("face_cal=captured face=%s x=%ld y=%ld z=%ld\n", kFaceNames[f],
+                   static_cast<long>(up[f].x), static_cast<long>(up[f].y),
+                   static_cast<long>(up[f].z));
+        }
+        tilt::Mount mount{};
+        const tilt::MountError error = tilt::solve_mount(up, kLimits, mount);
+        if (error != tilt::MountError::kNone) {
+            (void)buzzer.play(tilt::melodies::kCancel);
+            printf("face_cal=rejected reason=%s\n", error_name(error));
+            continue;
+        }
+        const auto& m = mount.m;
+        printf("face_cal=mount m=%d,%d,%d,%d,%d,%d,%d,%d,%d\n", m[0], m[1], m[2], m[3], m[4],
+               m[5], m[6], m[7], m[8]);
+        // The chirp streams its words from XIP, which the flash write takes
+        // offline (see flash_quiet() in main.cpp).
+        while (buzzer.active()) {
+            tight_loop_contents();
+        }
+        const bool ok = store(config, mount);
+        printf("face_cal=end status=%s\n", ok ? "ok" : "program_failed");
+        (void)buzzer.play(ok ? tilt::melodies::kStart : tilt::melodies::kCancel);
+        for (;;) {
+            tight_loop_contents();
+        }
+    }
+}
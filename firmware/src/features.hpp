@@ -0,0 +1,53 @@
+// Compile-time feature switches. Override with -D on the compiler line.
+#pragma once
+
+/// Service-unit USB streaming of raw LIS3DH frames (usb/). Needs the USB
+/// rework and a 12 MHz crystal; see the README. The CMake option of the
+/// same name also adds the usb/ sources and tinyusb_device.
+#ifndef TILT_USB_STREAM
+#define TILT_USB_STREAM 0
+#endif
+
+/// Seconds between scheduler latency reports on stdio; 0 disables them.
+/// The report deadline keeps the system timer running, so the cube never
+/// goes dormant while this is on.
+#ifndef TILT_SCHED_REPORT_S
+#define TILT_SCHED_REPORT_S 0
+#endif
+
+/// Builds without a heap (util/no_heap.cpp). Every allocation function is
+/// replaced by one that references an undefined symbol, so any malloc or
+/// new that survives --gc-sections fails the link; tools/mem_report.py
+/// names the culprit. Everything already lives in static storage.
+#ifndef TILT_NO_HEAP
+#define TILT_NO_HEAP 0
+#endif
+
+/// Host simulation build (sim/, see the README). hal/devices.hpp then
+/// resolves DS1, BZ1 and D1 to the sim/ stand-ins, and code that only makes
+/// sense on the RP2040 (core 1 launch, multicore doorbells) compiles out.
+/// Never set for a firmware target.
+#ifndef TILT_HOST
+#define TILT_HOST 0
+#endif
+
+/// Binary event trace (diag/trace.hpp): a per-core RAM ring of 8-byte
+/// records covering interrupts, bus transactions, tilt decisions, rendering
+/// and sleep, for tools/trace_decode.py. An event costs roughly 30
+/// cycles inline (tilt_bench reports the exact figure as trace_record) and
+/// the rings take 16 * TILT_TRACE_DEPTH bytes of RAM, so it may stay on in
+/// release builds.
+#ifndef TILT_TRACE
+#define TILT_TRACE 0
+#endif
+
+/// Records kept per core when TILT_TRACE is on; a power of two.
+#ifndef TILT_TRACE_DEPTH
+#define TILT_TRACE_DEPTH 256
+#endif
+
+/// Board revision the firmware is built for, major * 10 + minor (10 is
+/// rev 1.0). board.hpp maps it to a generated config in board/.
+#ifndef TILT_BOARD_REV
+#define TILT_BOARD_REV 10
+#endif
@@ -0,0 +1,38 @@
+// Output devices the UI pipeline drives, resolved per build.
+#pragma once
+
+#include "features.hpp"
+
+#if TILT_HOST
+#include "sim/sim_devices.hpp"
+#else
+#include "audio/pio_buzzer.hpp"
+#include "display/ssd1306.hpp"
+#include "led/led_effects.hpp"
+#endif
+
+namespace tilt::hal {
+
+/// A compile-time HAL: each alias names a concrete class, and every backend
+/// provides the same members under the same names, so there is no virtual
+/// dispatch and the firmware build is unchanged. The members UiPipeline
+/// relies on:
+///
+///   Display: init(), send_commands(cmds, len), flush(fb, cb, ctx), flushing()
+///   Tone:    init(), play(melody), stop(), set_volume(step), active()
+///   Led:     play(effect, period_ms), off(), effect(), active()
+///
+/// The accelerometer has no alias: everything above the drivers consumes
+/// AccelSample batches (drivers/accel_sample.hpp), which the simulation
+/// reads from a trace instead of the FIFO.
+#if TILT_HOST
+using Display = sim::Display;
+using Tone = sim::Tone;
+using Led = sim::Led;
+#else
+using Display = Ssd1306;
+using Tone = PioBuzzer;
+using Led = LedEffects;
+#endif
+
+}  // namespace tilt::hal
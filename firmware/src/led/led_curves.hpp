@@ -0,0 +1,59 @@
+// Gamma-corrected LED brightness curves generated at compile time.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "util/constexpr_math.hpp"
+
+namespace tilt::led_curves {
+
+/// Curve length; the DMA ring-wraps over the table, so it must be a power
+/// of two and the table aligned to its own size in bytes.
+inline constexpr size_t kLength = 256;
+inline constexpr size_t kRingBits = 9;  // log2(kLength * sizeof(uint16_t))
+
+/// PWM TOP; levels run 0..kPwmTop + 1.
+inline constexpr uint16_t kPwmTop = 1023;
+
+using Curve = std::array<uint16_t, kLength>;
+
+namespace detail {
+
+/// Maps perceived brightness 0..1 to a PWM level (gamma 2.2).
+constexpr uint16_t level(double perceived) {
+    if (perceived <= 0) {
+        return 0;
+    }
+    const double linear = perceived >= 1 ? 1.0 : cmath::pow(perceived, 2.2);
+    return static_cast<uint16_t>(linear * (kPwmTop + 1) + 0.5);
+}
+
+template <typename Shape>
+constexpr Curve make_curve(Shape shape) {
+    Curve c{};
+    for (size_t i = 0; i < kLength; ++i) {
+        c[i] = level(shape(static_cast<double>(i) / kLength));
+    }
+    return c;
+}
+
+}  // namespace detail
+
+/// Raised-cosine breathing, one breath per cycle.
+alignas(kLength * sizeof(uint16_t)) inline constexpr Curve kBreathe =
+    detail::make_curve([](double t) { return (1 - cmath::cos(2 * cmath::kPi * t)) / 2; });
+
+/// 50 % square blink.
+alignas(kLength * sizeof(uint16_t)) inline constexpr Curve kBlink =
+    detail::make_curve([](double t) { return t < 0.5 ? 1.0 : 0.0; });
+
+/// Short heartbeat-style pulse at the start of each cycle, dark otherwise;
+/// the cycle period is what conveys progress.
+alignas(kLength * sizeof(uint16_t)) inline constexpr Curve kPulse =
+    detail::make_curve([](double t) {
+        return t < 0.125 ? (1 - cmath::cos(2 * cmath::kPi * t * 8)) / 2 : 0.0;
+    });
+
+}  // namespace tilt::led_curves
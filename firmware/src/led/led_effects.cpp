@@ -0,0 +1,126 @@
+#include "led/led_effects.hpp"
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+
+namespace tilt {
+
+namespace {
+
+// PWM clock divider at full clk_sys speed. Dividing clk_sys by up to 8
+// is absorbed by lowering this, keeping PWM at ~800 Hz on the ROSC.
+constexpr uint32_t kPwmBaseDiv = 8;
+
+// Effectively "forever": at the fastest useful pace this lasts for months.
+constexpr uint32_t kEndlessTransfers = 0xFFFF'FFFF;
+
+const led_curves::Curve* curve_for(LedEffect effect) {
+    switch (effect) {
+        case LedEffect::kBreathe:
+            return &led_curves::kBreathe;
+        case LedEffect::kBlink:
+            return &led_curves::kBlink;
+        case LedEffect::kPulse:
+            return &led_curves::kPulse;
+        case LedEffect::kOff:
+            break;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+bool LedEffects::init() {
+    const int chan = dma_claim_unused_channel(false);
+    const int timer = dma_claim_unused_timer(false);
+    if (chan < 0 || timer < 0) {
+        return false;
+    }
+    dma_chan_ = static_cast<unsigned>(chan);
+    pacing_timer_ = static_cast<unsigned>(timer);
+    critical_section_init(&lock_);
+
+    gpio_set_function(pin_, GPIO_FUNC_PWM);
+    slice_ = pwm_gpio_to_slice_num(pin_);
+    pwm_config cfg = pwm_get_default_config();
+    pwm_config_set_wrap(&cfg, led_curves::kPwmTop);
+    pwm_config_set_clkdiv_int(&cfg, kPwmBaseDiv);
+    pwm_init(slice_, &cfg, true);
+    pwm_set_gpio_level(pin_, 0);
+    ready_ = true;
+    return true;
+}
+
+void LedEffects::play(LedEffect effect, uint32_t period_ms) {
+    if (!ready_) {
+        return;
+    }
+    off();
+    const led_curves::Curve* curve = curve_for(effect);
+    if (curve == nullptr) {
+        return;
+    }
+
+    // Steps per second = kLength / period; pace = steps / clk_sys as num/den.
+    const uint64_t sys_hz = clock_get_hz(clk_sys);
+    uint64_t den = sys_hz * period_ms / (1000 * led_curves::kLength);
+    if (den > 0xFFFF) {
+        den = 0xFFFF;
+    }
+    if (den == 0) {
+        den = 1;
+    }
+    critical_section_enter_blocking(&lock_);
+    pace_num_ = 1;
+    pace_den_ = static_cast<uint16_t>(den);
+    apply_rates();
+    critical_section_exit(&lock_);
+
+    effect_ = effect;
+
+    dma_channel_config c = dma_channel_get_default_config(dma_chan_);
+    // The CC register holds both channel levels; a 16-bit write is
+    // replicated to both halves, and only this pin's channel is routed out.
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_ring(&c, false, led_curves::kRingBits);
+    channel_config_set_dreq(&c, dma_get_timer_dreq(pacing_timer_));
+    dma_channel_configure(dma_chan_, &c, &pwm_hw->slice[slice_].cc, curve->data(),
+                          kEndlessTransfers, true);
+}
+
+void LedEffects::off() {
+    if (!ready_) {
+        return;
+    }
+    dma_channel_abort(dma_chan_);
+    effect_ = LedEffect::kOff;
+    pwm_set_gpio_level(pin_, 0);
+}
+
+void LedEffects::on_clock_change(uint32_t sys_divider, void* ctx) {
+    auto* self = static_cast<LedEffects*>(ctx);
+    critical_section_enter_blocking(&self->lock_);
+    self->sys_divider_ = sys_divider;
+    self->apply_rates();
+    critical_section_exit(&self->lock_);
+}
+
+// Caller holds lock_.
+void LedEffects::apply_rates() {
+    const uint32_t div = sys_divider_;
+    const uint32_t pwm_div = div < kPwmBaseDiv ? kPwmBaseDiv / div : 1;
+    pwm_set_clkdiv_int_frac(slice_, static_cast<uint8_t>(pwm_div), 0);
+    // A slower clk_sys needs a proportionally larger pacing fraction.
+    uint32_t num = static_cast<uint32_t>(pace_num_) * div;
+    if (num > pace_den_) {
+        num = pace_den_;
+    }
+    dma_timer_set_fraction(pacing_timer_, static_cast<uint16_t>(num), pace_den_);
+}
+
+}  // namespace tilt
@@ -0,0 +1,62 @@
+// D1 status effects: PWM slice fed brightness curves by a paced DMA channel.
+#pragma once
+
+#include <cstdint>
+
+#include "led/led_curves.hpp"
+#include "pico/critical_section.h"
+
+namespace tilt {
+
+enum class LedEffect : uint8_t {
+    kOff,
+    kBreathe,
+    kBlink,
+    kPulse,
+};
+
+/// Runs brightness curves on D1 with zero CPU cost once started.
+///
+/// A DMA channel ring-wraps over a 256-entry curve in flash and writes each
+/// level into the PWM compare register, paced by a DMA pacing timer. Both
+/// the PWM counter and the pacing timer run from clk_sys, so on_clock_change()
+/// rescales them whenever the power manager divides clk_sys; the effect
+/// keeps its speed and flicker-free PWM rate through sleep.
+///
+/// play() runs on core 1 (UiPipeline) and on_clock_change() on core 0 (the
+/// PowerManager hook), so the pacing fraction and both rate registers are
+/// only touched under lock_.
+class LedEffects {
+public:
+    explicit LedEffects(unsigned pin) : pin_(pin) {}
+
+    [[nodiscard]] bool init();
+
+    /// Starts `effect`, one curve cycle every `period_ms`. Periods are
+    /// clamped to what the pacing timer can express at the current clock.
+    void play(LedEffect effect, uint32_t period_ms);
+    void off();
+
+    LedEffect effect() const { return effect_; }
+    /// An effect needs clocks running; dormant would freeze it mid-curve.
+    bool active() const { return effect_ != LedEffect::kOff; }
+
+    /// PowerManager::ClockHook.
+    static void on_clock_change(uint32_t sys_divider, void* ctx);
+
+private:
+    void apply_rates();
+
+    unsigned pin_;
+    unsigned slice_ = 0;
+    unsigned dma_chan_ = 0;
+    unsigned pacing_timer_ = 0;
+    bool ready_ = false;
+    LedEffect effect_ = LedEffect::kOff;
+    uint16_t pace_num_ = 1;
+    uint16_t pace_den_ = 0xFFFF;
+    volatile uint32_t sys_divider_ = 1;
+    critical_section_t lock_;
+};
+
+}  // namespace tilt
@@ -0,0 +1,533 @@
+// Tilt-Timer Cube firmware entry point.
+//
+// Core 0 owns U2, orientation and the timer state machine; core 1 owns DS1
+// (see UiPipeline). The two only meet in the UiLink ring and the I2C bus.
+// Core 0 work is split into EventLoop tasks that interrupts post; nothing
+// polls, and the loop hands the core to PowerManager when all are idle.
+
+#include <cstring>
+
+#include "app/cube_timer.hpp"
+#include "app/session_tracker.hpp"
+#include "app/ui_link.hpp"
+#include "audio/pio_buzzer.hpp"
+#include "board.hpp"
+#include "diag/trace.hpp"
+#include "display/ssd1306.hpp"
+#include "drivers/i2c_bus.hpp"
+#include "drivers/i2c_dma.hpp"
+#include "drivers/lis3dh.hpp"
+#include "drivers/lis3dh_fifo.hpp"
+#include "features.hpp"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "led/led_effects.hpp"
+#include "orientation/gesture_detector.hpp"
+#include "orientation/orientation_engine.hpp"
+#include "orientation/tilt_classifier.hpp"
+#include "pico/stdlib.h"
+#include "power/battery_monitor.hpp"
+#include "power/power_governor.hpp"
+#include "power/power_manager.hpp"
+#include "power/timebase.hpp"
+#include "sched/event_loop.hpp"
+#include "storage/config_store.hpp"
+#include "storage/frame_cache.hpp"
+#include "storage/session_log.hpp"
+#include "ui/display_policy.hpp"
+#include "ui/ui_pipeline.hpp"
+
+#if TILT_USB_STREAM
+#include "pico/unique_id.h"
+#include "usb/accel_stream.hpp"
+#include "usb/log_export.hpp"
+#include "usb/sof_calibrator.hpp"
+#endif
+
+namespace {
+
+constexpr const tilt::board::BoardConfig& kBoard = tilt::board::kBoard;
+
+// The orientation engine and the power manager both run off U2's
+// interrupt lines.
+static_assert(tilt::board::has(kBoard.accel_int1_pin) &&
+                  tilt::board::has(kBoard.accel_int2_pin),
+              "the firmware needs U2 INT1 and INT2 wired (README, Board rework)");
+
+// A face must sit within 30 degrees of its axis for 20 ms to take over;
+// batches of 4 keep the watermark-to-callback latency around 40 ms at full
+// power. Dwell is counted in samples, so each governor level (and its ODR)
+// gets its own config.
+//
+// About 10 degrees of that cone is for how U2 may sit in the shell. A unit
+// with a factory mount rests on axis, so it takes a 20 degree cone; the
+// wider dead band between faces then settles border flicker in 10 ms.
+constexpr tilt::TiltConfig tilt_config(tilt::PowerLevel level, bool mounted) {
+    return tilt::make_tilt_config(mounted ? 20.0 : 30.0, mounted ? 10 : 20,
+                                  tilt::power_profile(level).odr_hz);
+}
+constexpr tilt::TiltConfig kTiltConfigs[2][tilt::kPowerLevelCount] = {
+    {
+        tilt_config(tilt::PowerLevel::kFull, false),
+        tilt_config(tilt::PowerLevel::kReduced, false),
+        tilt_config(tilt::PowerLevel::kLow, false),
+        tilt_config(tilt::PowerLevel::kCritical, false),
+    },
+    {
+        tilt_config(tilt::PowerLevel::kFull, true),
+        tilt_config(tilt::PowerLevel::kReduced, true),
+        tilt_config(tilt::PowerLevel::kLow, true),
+        tilt_config(tilt::PowerLevel::kCritical, true),
+    },
+};
+static_assert(tilt::power_profile(tilt::PowerLevel::kFull).odr_hz ==
+              tilt::OrientationEngine::kSampleRateHz);
+constexpr uint8_t kTiltBatch = 4;
+
+// Battery reads repeat at this period while a countdown runs; otherwise
+// there is one at boot and one at each countdown start.
+constexpr uint32_t kBatteryPeriodMs = 60'000;
+
+// How often a log write blocked by a playing melody or LED effect retries.
+constexpr uint32_t kLogRetryMs = 2000;
+// The idle screen is cached for the next boot once it has stood this long,
+// which lets a quick pick-up cancel the save rather than wait it out.
+constexpr uint32_t kFrameSaveDelayMs = 5000;
+
+#if TILT_USB_STREAM
+// A new SOF measurement is only written to flash if it moved this far.
+constexpr int32_t kCalibrationPersistPpb = 1'000;
+#endif
+
+struct App {
+    tilt::OrientationEngine* orientation = nullptr;
+    tilt::I2cBus* bus = nullptr;
+    tilt::PioBuzzer* buzzer = nullptr;
+    tilt::LedEffects* led = nullptr;
+    const tilt::ConfigStore* config = nullptr;
+    tilt::SessionLog* log = nullptr;
+    tilt::TiltClassifier* classifier = nullptr;
+    tilt::BatteryMonitor* battery = nullptr;
+    tilt::PowerGovernor governor;
+    tilt::CubeTimer timer;
+    tilt::SessionTracker session;
+#if TILT_USB_STREAM
+    tilt::AccelStream stream;
+    tilt::SofCalibrator sof;
+    tilt::UsbLogExport* log_export = nullptr;
+    tilt::ConfigStore* store = nullptr;
+    tilt::TaskId calibration_task = tilt::kNoTask;
+    tilt::Deadline calibration_period;
+    bool calibrated = false;
+#endif
+    tilt::UiLink ui;
+    tilt::Face face = tilt::Face::kUnknown;
+
+    tilt::EventLoop loop;
+    tilt::PowerManager* power = nullptr;
+    tilt::TaskId log_task = tilt::kNoTask;
+    tilt::TaskId stream_task = tilt::kNoTask;
+    tilt::TaskId battery_task = tilt::kNoTask;
+    tilt::Deadline log_retry;
+    const tilt::UiPipeline* pipeline = nullptr;
+    tilt::TaskId frame_task = tilt::kNoTask;
+    tilt::Deadline frame_save;
+    tilt::Deadline battery_period;
+#if TILT_SCHED_REPORT_S
+    tilt::TaskId report_task = tilt::kNoTask;
+    tilt::Deadline report_period;
+#endif
+};
+
+void on_wake(tilt::PowerState from, void* ctx) {
+    if (from == tilt::PowerState::kDormant) {
+        static_cast<App*>(ctx)->orientation->resync();
+    }
+}
+
+/// Deepest state that is safe right now. Dormant stops every clock, so it
+/// needs core 1 settled, the bus drained and no countdown or dim alarms
+/// pending; a sounding buzzer pins clk_sys undivided to keep its pitch, and
+/// a running LED effect rescales itself but still needs clocks.
+tilt::PowerState choose_power_state(const App& app) {
+    if (!app.ui.settled() || app.buzzer->active()) {
+        return tilt::PowerState::kRun;
+    }
+    // Armed deadlines, including core 1's dim alarm, need the system timer,
+    // which dormant stops; so does clk_adc under a battery reading.
+    if (app.timer.state() == tilt::CubeTimer::State::kRunning || !app.bus->idle() ||
+        app.led->active() || app.loop.timers_armed() || app.battery->busy() ||
+        app.pipeline->dim_pending()) {
+        return tilt::PowerState::kSleep;
+    }
+#if TILT_USB_STREAM
+    // Dormant would stop the crystal under a configured USB device.
+    if (app.stream.connected()) {
+        return tilt::PowerState::kSleep;
+    }
+#endif
+    return tilt::PowerState::kDormant;
+}
+
+/// Flash writes stall both cores and take XIP offline, which would starve
+/// the buzzer and LED DMA streams; they wait until nothing is running.
+bool flash_quiet(const App& app) {
+    return app.timer.state() != tilt::CubeTimer::State::kRunning && !app.buzzer->active() &&
+           !app.led->active();
+}
+
+void init_i2c() {
+    i2c_init(i2c0, kBoard.i2c_baud_hz);
+    gpio_set_function(kBoard.i2c_sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(kBoard.i2c_scl_pin, GPIO_FUNC_I2C);
+}
+
+void post_idle(App& app) {
+    app.ui.post({tilt::UiEvent::Kind::kIdle, app.face, 0});
+    app.loop.arm(app.frame_save, app.frame_task, kFrameSaveDelayMs);
+}
+
+void end_session(App& app, tilt::SessionOutcome outcome) {
+    // Periodic battery reads only run alongside a countdown.
+    app.loop.cancel(app.battery_period);
+    tilt::SessionRecord record;
+    if (app.session.end(outcome, record)) {
+        app.log->append(record);
+        app.loop.post(app.log_task);
+    }
+}
+
+void on_face_change(tilt::Face face, void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    app.face = face;
+    const uint32_t duration = app.config->preset(face).duration_ms;
+    if (duration == 0) {
+        end_session(app, tilt::SessionOutcome::kCancelled);
+        app.timer.cancel();
+        post_idle(app);
+    } else {
+        end_session(app, tilt::SessionOutcome::kSuperseded);
+        app.timer.start(duration);
+        // The latest reading (0 if none yet); this start also takes a new one.
+        app.session.begin(face, duration, app.battery->millivolts(),
+                          app.orientation->in_motion());
+        app.ui.post({tilt::UiEvent::Kind::kStarted, face, app.timer.remaining_s()});
+        app.loop.post(app.battery_task);
+    }
+}
+
+/// Double tap pauses or resumes a countdown; a shake cancels it, as turning
+/// to the idle face would.
+void on_gesture(tilt::Gesture gesture, void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    const tilt::CubeTimer::State state = app.timer.state();
+    if (state != tilt::CubeTimer::State::kRunning && state != tilt::CubeTimer::State::kPaused) {
+        return;
+    }
+    if (gesture == tilt::Gesture::kShake) {
+        end_session(app, tilt::SessionOutcome::kCancelled);
+        app.timer.cancel();
+        post_idle(app);
+    } else if (state == tilt::CubeTimer::State::kRunning) {
+        app.timer.pause();
+        app.ui.post({tilt::UiEvent::Kind::kPaused, app.face, app.timer.remaining_s()});
+    } else {
+        app.timer.resume();
+        app.ui.post({tilt::UiEvent::Kind::kRunning, app.face, app.timer.remaining_s()});
+    }
+}
+
+void run_orientation(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    app.orientation->service();
+    app.session.note_motion(app.orientation->in_motion());
+}
+
+void run_timer(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    switch (app.timer.poll()) {
+        case tilt::CubeTimer::Event::kTick: {
+            // On a low battery or a long countdown the display redraws less
+            // often, except in the face's final stretch.
+            const uint32_t remaining = app.timer.remaining_s();
+            if (tilt::display_policy::redraw_due(remaining, app.governor.profile().redraw_s,
+                                                 app.config->theme(app.face).hurry_below_s)) {
+                app.ui.post({tilt::UiEvent::Kind::kRunning, app.face, remaining});
+            }
+            break;
+        }
+        case tilt::CubeTimer::Event::kExpired:
+            app.ui.post({tilt::UiEvent::Kind::kExpired, app.face, 0});
+            end_session(app, tilt::SessionOutcome::kCompleted);
+            break;
+        case tilt::CubeTimer::Event::kNone:
+            break;
+    }
+}
+
+void run_log(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    if (app.log->service(flash_quiet(app))) {
+        // One page or one erase per run; come back for the rest.
+        app.loop.post(app.log_task);
+    } else if (app.log->pending() && !app.log_retry.armed) {
+        // Core 1 does not signal when a melody or LED effect ends.
+        app.loop.arm(app.log_retry, app.log_task, kLogRetryMs);
+    }
+}
+
+/// Keeps the idle screen in flash as the next boot's first frame. Boot always
+/// comes up idle, so no other screen is cached, and an unchanged one (the
+/// usual case) costs a memcmp and no flash wear.
+void run_frame_save(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    if (app.timer.state() != tilt::CubeTimer::State::kIdle) {
+        return;
+    }
+    if (!app.ui.settled() || !flash_quiet(app)) {
+        app.loop.arm(app.frame_save, app.frame_task, kLogRetryMs);
+        return;
+    }
+    if (!tilt::frame_cache::matches(app.pipeline->frame())) {
+        (void)tilt::frame_cache::store(app.pipeline->frame());
+    }
+}
+
+void apply_power_level(App& app) {
+    const tilt::PowerLevel level = app.governor.level();
+    const tilt::PowerProfile& profile = app.governor.profile();
+    app.classifier->set_config(
+        kTiltConfigs[app.classifier->mounted()][static_cast<unsigned>(level)]);
+    // A failed write leaves the old ODR with a dwell scaled for the new
+    // one, which costs a little debounce until the next level change.
+    tilt::spawn(app.orientation->set_run_odr(profile.odr, profile.odr_hz), nullptr, nullptr);
+    tilt::UiEvent event{tilt::UiEvent::Kind::kPower, app.face, 0};
+    event.power = level;
+    app.ui.post(event);
+}
+
+void run_battery(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    if (app.battery->take_fresh()) {
+        if (app.governor.update(app.battery->millivolts())) {
+            apply_power_level(app);
+        }
+    } else {
+        // Finishes in the DMA IRQ, which posts this task again.
+        (void)app.battery->start();
+    }
+    if (app.timer.state() == tilt::CubeTimer::State::kRunning && !app.battery_period.armed) {
+        app.loop.arm(app.battery_period, app.battery_task, kBatteryPeriodMs);
+    }
+}
+
+#if TILT_USB_STREAM
+void run_stream(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    bool more = app.stream.service();
+    // An export keeps the accel frames off the endpoint until it is done.
+    more |= app.log_export->service();
+    app.stream.hold(app.log_export->active());
+    if (more) {
+        app.loop.post(app.stream_task);
+    }
+    // One SOF measurement per boot, started by the first connection.
+    if (!app.calibrated && !app.calibration_period.armed && app.stream.connected()) {
+        app.loop.arm(app.calibration_period, app.calibration_task,
+                     tilt::SofCalibrator::kSamplePeriodMs);
+    }
+}
+
+void export_info(tilt::ExportInfo& info, void* ctx) {
+    const auto& app = *static_cast<const App*>(ctx);
+    pico_unique_board_id_t id;
+    pico_get_unique_board_id(&id);
+    static_assert(sizeof(id.id) == sizeof(info.board_id));
+    std::memcpy(info.board_id, id.id, sizeof(info.board_id));
+    info.awake_s = static_cast<uint32_t>(tilt::timebase::us_from_ticks(time_us_64()) / 1'000'000);
+    info.battery_mv = app.battery->millivolts();
+    info.power_level = static_cast<uint8_t>(app.governor.level());
+    info.power = app.power->stats();
+}
+
+/// Keeps the measured error in the config blob, so units calibrated once
+/// on a host keep it without USB.
+void persist_calibration(App& app, int32_t ppb) {
+    const tilt::Calibration& stored = app.config->active().calibration;
+    const int32_t moved = ppb - stored.timer_ppb;
+    if (stored.timer_source == static_cast<uint8_t>(tilt::timebase::Source::kUsbSof) &&
+        moved < kCalibrationPersistPpb && moved > -kCalibrationPersistPpb) {
+        return;
+    }
+    static tilt::ConfigBlob blob;
+    blob = app.config->active();
+    blob.calibration.timer_ppb = ppb;
+    blob.calibration.timer_source = static_cast<uint8_t>(tilt::timebase::Source::kUsbSof);
+    blob.header.crc = tilt::config_crc(blob);
+    (void)app.store->program(blob);
+}
+
+void run_calibration(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    if (!app.calibrated) {
+        // run_stream() starts over on the next connection.
+        if (!app.stream.connected()) {
+            app.sof.reset();
+            return;
+        }
+        app.calibrated = app.sof.sample();
+    }
+    // A running countdown's alarms keep the old scale, and programming
+    // flash would stall the melody and LED streams, so a result waits for
+    // flash_quiet().
+    if (app.calibrated && flash_quiet(app)) {
+        tilt::timebase::set_error(app.sof.error_ppb(), tilt::timebase::Source::kUsbSof);
+        persist_calibration(app, app.sof.error_ppb());
+        return;
+    }
+    app.loop.rearm(app.calibration_period, tilt::SofCalibrator::kSamplePeriodMs);
+}
+#endif
+
+#if TILT_SCHED_REPORT_S
+void run_report(void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    app.loop.print_report();
+    // Snapshot of the last few milliseconds per core; see tools/trace_decode.py.
+    tilt::trace::dump();
+    app.loop.rearm(app.report_period, TILT_SCHED_REPORT_S * 1000);
+}
+#endif
+
+void idle(tilt::EventLoop& loop, void* ctx) {
+    auto& app = *static_cast<App*>(ctx);
+    app.power->idle(choose_power_state(app), &tilt::EventLoop::has_work_thunk, &loop);
+}
+
+}  // namespace
+
+int main() {
+    tilt::trace::init();
+    init_i2c();
+
+    static tilt::I2cDma i2c_dma(i2c0);
+    static tilt::I2cBus bus(i2c_dma);
+    static tilt::Lis3dh accel(bus, kBoard.accel_address);
+    static tilt::Lis3dhFifo fifo(accel);
+    static tilt::TiltClassifier classifier(kTiltConfigs[0][0]);
+    static tilt::OrientationEngine orientation(accel, kBoard.accel_int1_pin, kBoard.accel_int2_pin);
+    orientation.attach_classifier(fifo, classifier, kTiltBatch);
+    static tilt::GestureDetector gestures;
+    orientation.attach_gestures(gestures);
+    static tilt::Ssd1306 oled(bus, kBoard.oled_address);
+    static tilt::PioBuzzer buzzer(pio0, kBoard.buzzer_pin);
+    static tilt::LedEffects led(kBoard.led_pin);
+    static tilt::ConfigStore config;
+    static tilt::SessionLog log;
+    static tilt::BatteryMonitor battery(kBoard.battery);
+    static App app;
+    app.orientation = &orientation;
+    app.bus = &bus;
+    app.buzzer = &buzzer;
+    app.led = &led;
+    app.config = &config;
+    app.log = &log;
+    app.classifier = &classifier;
+    app.battery = &battery;
+    static tilt::UiPipeline ui(app.ui, config, oled, buzzer, led);
+    app.pipeline = &ui;
+    static tilt::PowerManager power;
+    app.power = &power;
+
+    // Lower ids run first when several tasks are pending.
+    tilt::EventLoop& loop = app.loop;
+    static tilt::EventLoop::PostTarget orientation_target{
+        &loop, loop.add_task("orientation", &run_orientation, &app)};
+    static tilt::EventLoop::PostTarget timer_target{&loop,
+                                                    loop.add_task("timer", &run_timer, &app)};
+#if TILT_USB_STREAM
+    app.stream_task = loop.add_task("usb", &run_stream, &app);
+    static tilt::EventLoop::PostTarget stream_target{&loop, app.stream_task};
+    app.calibration_task = loop.add_task("sof", &run_calibration, &app);
+    app.store = &config;
+    static tilt::UsbLogExport log_export(log);
+    log_export.set_info_source(&export_info, &app);
+    app.log_export = &log_export;
+#endif
+    // Without the BT1 divider the task, the ADC and its DMA IRQ compile out
+    // and the governor stays at full power. It does with the divider too
+    // until PowerGovernor has real thresholds for BT1.
+    if constexpr (tilt::board::has(kBoard.battery.pin)) {
+        app.battery_task = loop.add_task("battery", &run_battery, &app);
+    }
+    static tilt::EventLoop::PostTarget battery_target{&loop, app.battery_task};
+    app.log_task = loop.add_task("log", &run_log, &app);
+    app.frame_task = loop.add_task("frame", &run_frame_save, &app);
+#if TILT_SCHED_REPORT_S
+    app.report_task = loop.add_task("report", &run_report, &app);
+#endif
+
+    // The DMA engine's IRQ is enabled on the calling core, so bus
+    // completions (and transaction callbacks) always run on core 0.
+    if (!i2c_dma.init() || !loop.init()) {
+        return 1;
+    }
+    // Stage 1, first pixel: with only the bus up, light DS1 with the cached
+    // idle screen. tilt_bench's boot_* results time this path.
+    ui.boot(tilt::frame_cache::load());
+
+    // Stage 2: everything else, with U2's retrying bring-up last.
+    if (led.init()) {
+        power.add_clock_hook(&tilt::LedEffects::on_clock_change, &led);
+    }
+    // Without a reading the governor stays at full power.
+    if constexpr (tilt::board::has(kBoard.battery.pin)) {
+        if (battery.init()) {
+            battery.set_notify(&tilt::EventLoop::post_target, &battery_target);
+            loop.post(app.battery_task);
+        }
+    }
+    // Before core 1 starts: it reads the store without locking.
+    config.init();
+    const tilt::Calibration& calibration = config.active().calibration;
+    // Before orientation.init(), which maps the 6D start-up face through it.
+    if (calibration.mount_set != 0) {
+        classifier.set_mount(tilt::calibrated_mount(calibration));
+        classifier.set_config(kTiltConfigs[1][static_cast<unsigned>(app.governor.level())]);
+    }
+    if (calibration.timer_source != 0) {
+        tilt::timebase::set_error(calibration.timer_ppb,
+                                  static_cast<tilt::timebase::Source>(calibration.timer_source));
+    }
+    log.init();
+    ui.launch();
+    while (!orientation.init()) {
+        sleep_ms(100);
+    }
+    orientation.set_face_callback(&on_face_change, &app);
+    orientation.set_gesture_callback(&on_gesture, &app);
+    orientation.set_notify(&tilt::EventLoop::post_target, &orientation_target);
+    app.timer.set_notify(&tilt::EventLoop::post_target, &timer_target);
+#if TILT_USB_STREAM
+    if (app.stream.init()) {
+        app.stream.set_notify(&tilt::EventLoop::post_target, &stream_target);
+        orientation.set_batch_tap(&tilt::AccelStream::tap, &app.stream);
+    }
+#endif
+    // INT1 rises on a FIFO batch or a new 6D face. INT2 rises as U2 drops to
+    // rest and falls as motion starts, which must also wake the chip so the
+    // engine can restore the run watermark (see OrientationEngine).
+    power.init({kBoard.accel_int1_pin, GPIO_IRQ_EDGE_RISE},
+               {kBoard.accel_int2_pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL});
+    power.set_wake_hook(&on_wake, &app);
+    loop.set_idle(&idle, &app);
+
+    // Anything init() latched before the notify hook was attached.
+    loop.post(orientation_target.task);
+    // Boot is idle: cache the screen if this is the first boot or it changed.
+    loop.arm(app.frame_save, app.frame_task, kFrameSaveDelayMs);
+#if TILT_SCHED_REPORT_S
+    loop.arm(app.report_period, app.report_task, TILT_SCHED_REPORT_S * 1000);
+#endif
+    loop.run();
+}
@@ -0,0 +1,22 @@
+// Cube faces as seen by the accelerometer: the face whose axis points up.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt {
+
+enum class Face : uint8_t {
+    kXPos,
+    kXNeg,
+    kYPos,
+    kYNeg,
+    kZPos,
+    kZNeg,
+    kUnknown,
+};
+
+inline constexpr unsigned kFaceCount = 6;
+
+constexpr unsigned face_index(Face face) { return static_cast<unsigned>(face); }
+
+}  // namespace tilt
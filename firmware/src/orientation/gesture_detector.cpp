@@ -0,0 +1,78 @@
+#include "orientation/gesture_detector.hpp"
+
+#include "drivers/lis3dh_regs.hpp"
+
+namespace tilt {
+
+namespace {
+
+// TIME_LIMIT is 7 bits wide; TIME_LATENCY and TIME_WINDOW are 8.
+constexpr uint8_t kMaxLimit = 0x7F;
+constexpr uint8_t kMaxTiming = 0xFF;
+
+// IA2 relatches on every sample a jolt stays over the threshold; hits
+// closer together than this are the same jolt. A hand shake reverses
+// about every 100 ms.
+constexpr uint32_t kShakeGapMs = 60;
+
+static_assert(GestureDetector::samples(30, 200, kMaxLimit) == 6);
+static_assert(GestureDetector::samples(30, 25, kMaxLimit) == 1);
+
+}  // namespace
+
+CoTask GestureDetector::configure(Lis3dh& accel, uint32_t odr_hz) {
+    using namespace lis3dh;
+    // Gravity would hold every face axis over both thresholds, so the click
+    // engine and IA2 see high-passed data; 6D and the FIFO do not.
+    const uint8_t writes[][2] = {
+        {reg::kCtrlReg2, kCtrl2HpClick | kCtrl2HpIa2},
+        {reg::kClickCfg, kClickCfgDoubleAll},
+        {reg::kClickThs, static_cast<uint8_t>(kClickThsLatch | config_.tap_threshold)},
+        {reg::kInt2Cfg, kIntCfgHighAxes},
+        {reg::kInt2Ths, config_.shake_threshold},
+        {reg::kInt2Duration, 0},
+    };
+    for (const auto& w : writes) {
+        if (!co_await accel.write_reg_async(w[0], w[1])) {
+            co_return false;
+        }
+    }
+    co_return co_await retime(accel, odr_hz);
+}
+
+CoTask GestureDetector::retime(Lis3dh& accel, uint32_t odr_hz) {
+    using namespace lis3dh;
+    co_return co_await accel.write_reg_async(
+                  reg::kTimeLimit, samples(config_.tap_limit_ms, odr_hz, kMaxLimit)) &&
+              co_await accel.write_reg_async(
+                  reg::kTimeLatency, samples(config_.tap_latency_ms, odr_hz, kMaxTiming)) &&
+              co_await accel.write_reg_async(
+                  reg::kTimeWindow, samples(config_.tap_window_ms, odr_hz, kMaxTiming));
+}
+
+Gesture GestureDetector::decode(uint8_t int2_src, uint8_t click_src, uint32_t now_ms) {
+    using namespace lis3dh;
+    if ((click_src & kClickSrcActive) && (click_src & kClickSrcDouble)) {
+        // A tap is a jolt too; it must not count towards a shake.
+        shake_count_ = 0;
+        return Gesture::kDoubleTap;
+    }
+    if (!(int2_src & kIntSrcActive)) {
+        return Gesture::kNone;
+    }
+    if (shake_count_ != 0 && now_ms - last_hit_ms_ < kShakeGapMs) {
+        return Gesture::kNone;
+    }
+    last_hit_ms_ = now_ms;
+    if (shake_count_ == 0 || now_ms - shake_start_ms_ > config_.shake_window_ms) {
+        shake_start_ms_ = now_ms;
+        shake_count_ = 0;
+    }
+    if (++shake_count_ < config_.shake_hits) {
+        return Gesture::kNone;
+    }
+    shake_count_ = 0;
+    return Gesture::kShake;
+}
+
+}  // namespace tilt
@@ -0,0 +1,72 @@
+// Double-tap and shake gestures from the LIS3DH click and IA2 engines.
+#pragma once
+
+#include <cstdint>
+
+#include "drivers/lis3dh.hpp"
+#include "sched/co_task.hpp"
+
+namespace tilt {
+
+enum class Gesture : uint8_t {
+    kNone,
+    kDoubleTap,
+    kShake,
+};
+
+/// Lets U2 watch for gestures in hardware so the firmware pays nothing for
+/// them until one starts: no extra ODR, no extra FIFO traffic.
+///
+/// The click engine detects the double tap on its own. IA2 fires on
+/// high-pass filtered acceleration above `shake_threshold` on any axis,
+/// which a single knock or a flip that lands hard also does, so a shake is
+/// only reported once IA2 has fired `shake_hits` times within
+/// `shake_window_ms` of the first. Both are latched and routed to INT2
+/// next to the sleep-to-wake engine; OrientationEngine reads their sources
+/// in one burst and passes them to decode().
+///
+/// The click timings are in samples, so they are rescaled with the run
+/// ODR. While U2 sits in its 10 Hz sleep-to-wake state taps are too short
+/// to resolve; the first one wakes it and the gesture needs the run ODR.
+class GestureDetector {
+public:
+    struct Config {
+        uint8_t tap_threshold;  // CLICK_THS at +/-2 g, 16 mg/LSB
+        uint16_t tap_limit_ms;  // longest a tap may stay over the threshold
+        uint16_t tap_latency_ms;  // dead time after the first tap
+        uint16_t tap_window_ms;   // the second tap must start within this
+        uint8_t shake_threshold;  // INT2_THS at +/-2 g, 16 mg/LSB
+        uint8_t shake_hits;
+        uint16_t shake_window_ms;
+    };
+
+    /// ~0.75 g taps 80..380 ms apart; ~1 g jolts three times within 0.8 s.
+    static constexpr Config kDefaultConfig{0x30, 30, 80, 300, 0x3E, 3, 800};
+
+    explicit GestureDetector(const Config& config = kDefaultConfig) : config_(config) {}
+
+    /// Click and IA2 setup for the run ODR `odr_hz`. OrientationEngine
+    /// calls this from its own configure() and owns the INT2 routing.
+    CoTask configure(Lis3dh& accel, uint32_t odr_hz);
+
+    /// Rewrites the click timings after a run ODR change.
+    CoTask retime(Lis3dh& accel, uint32_t odr_hz);
+
+    /// Turns one read of INT2_SRC and CLICK_SRC into at most one gesture.
+    /// Reading them clears both latches.
+    Gesture decode(uint8_t int2_src, uint8_t click_src, uint32_t now_ms);
+
+    /// Samples of `odr_hz` covering `ms`, at least 1, clamped to `max`.
+    static constexpr uint8_t samples(uint32_t ms, uint32_t odr_hz, uint8_t max) {
+        const uint32_t n = (ms * odr_hz + 999) / 1000;
+        return static_cast<uint8_t>(n < 1 ? 1 : n > max ? max : n);
+    }
+
+private:
+    Config config_;
+    uint32_t shake_start_ms_ = 0;
+    uint32_t last_hit_ms_ = 0;
+    uint8_t shake_count_ = 0;
+};
+
+}  // namespace tilt
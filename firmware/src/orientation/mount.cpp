@@ -0,0 +1,98 @@
+#include "orientation/mount.hpp"
+
+namespace tilt {
+
+namespace {
+
+struct Vec {
+    int64_t x;
+    int64_t y;
+    int64_t z;
+};
+
+int64_t dot(const Vec& a, const Vec& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+Vec cross(const Vec& a, const Vec& b) {
+    return Vec{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+uint64_t isqrt(uint64_t v) {
+    uint64_t root = 0;
+    for (uint64_t bit = uint64_t{1} << 62; bit != 0; bit >>= 2) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+int64_t div_round(int64_t n, int64_t d) {
+    return (n >= 0 ? n + d / 2 : n - d / 2) / d;
+}
+
+// `v` scaled to a Q14 unit vector.
+Vec unit(const Vec& v) {
+    const int64_t len = static_cast<int64_t>(isqrt(static_cast<uint64_t>(dot(v, v))));
+    return Vec{div_round(v.x * Mount::kOne, len), div_round(v.y * Mount::kOne, len),
+               div_round(v.z * Mount::kOne, len)};
+}
+
+Vec difference(const Gravity& pos, const Gravity& neg) {
+    return Vec{pos.x - neg.x, pos.y - neg.y, pos.z - neg.z};
+}
+
+// (a.b)^2 > sin2 * |a|^2 |b|^2, i.e. a and b are more than the skew angle
+// from perpendicular. The axes are ~2000 counts long, so the products stay
+// below 2^63.
+bool skewed(const Vec& a, const Vec& b, uq15_t sin2) {
+    const int64_t d = dot(a, b);
+    const uint64_t lhs = static_cast<uint64_t>(d * d);
+    const uint64_t bound = static_cast<uint64_t>(dot(a, a)) * static_cast<uint64_t>(dot(b, b));
+    return lhs > (bound >> 15) * sin2;
+}
+
+void put_row(Mount& out, unsigned row, const Vec& v) {
+    out.m[row * 3 + 0] = static_cast<int16_t>(v.x);
+    out.m[row * 3 + 1] = static_cast<int16_t>(v.y);
+    out.m[row * 3 + 2] = static_cast<int16_t>(v.z);
+}
+
+}  // namespace
+
+MountError solve_mount(const Gravity (&up)[kFaceCount], const MountLimits& limits, Mount& out) {
+    for (const Gravity& g : up) {
+        const int64_t mag2 = int64_t{g.x} * g.x + int64_t{g.y} * g.y + int64_t{g.z} * g.z;
+        if (mag2 < limits.min_mag2 || mag2 > limits.max_mag2) {
+            return MountError::kMagnitude;
+        }
+    }
+    const Vec x = difference(up[face_index(Face::kXPos)], up[face_index(Face::kXNeg)]);
+    const Vec y = difference(up[face_index(Face::kYPos)], up[face_index(Face::kYNeg)]);
+    const Vec z = difference(up[face_index(Face::kZPos)], up[face_index(Face::kZNeg)]);
+    if (skewed(x, y, limits.max_skew_sin2) || skewed(y, z, limits.max_skew_sin2) ||
+        skewed(z, x, limits.max_skew_sin2)) {
+        return MountError::kSkew;
+    }
+    if (dot(cross(x, y), z) <= 0) {
+        return MountError::kMirrored;
+    }
+    const Vec uz = unit(z);
+    const int64_t z2 = dot(z, z);
+    const int64_t xz = dot(x, z);
+    const Vec ux = unit(Vec{x.x - div_round(xz * z.x, z2), x.y - div_round(xz * z.y, z2),
+                            x.z - div_round(xz * z.z, z2)});
+    const Vec c = cross(uz, ux);
+    const Vec uy{div_round(c.x, Mount::kOne), div_round(c.y, Mount::kOne),
+                 div_round(c.z, Mount::kOne)};
+    put_row(out, 0, ux);
+    put_row(out, 1, uy);
+    put_row(out, 2, uz);
+    return MountError::kNone;
+}
+
+}  // namespace tilt
@@ -0,0 +1,102 @@
+// Fixed-point rotation from LIS3DH axes to cube-face axes.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "orientation/face.hpp"
+#include "util/constexpr_math.hpp"
+#include "util/fixed_point.hpp"
+
+namespace tilt {
+
+/// How U2 sits in the shell: row r holds cube axis r (X, Y, Z) as a Q14
+/// unit vector in sensor axes, so cube = M * sensor. Measured per unit by
+/// the factory calibration (factory/face_cal.cpp) and kept in the config
+/// blob; without one the sensor axes are taken as the cube axes.
+///
+/// Entries stay within +/-2^14 and samples within 12 bits, so each row is
+/// three 32-bit products on the M0+ multiplier with no overflow.
+struct Mount {
+    static constexpr unsigned kShift = 14;
+    static constexpr int32_t kOne = 1 << kShift;
+
+    std::array<int16_t, 9> m;
+
+    constexpr void apply(int32_t& x, int32_t& y, int32_t& z) const {
+        const int32_t cx = (m[0] * x + m[1] * y + m[2] * z) >> kShift;
+        const int32_t cy = (m[3] * x + m[4] * y + m[5] * z) >> kShift;
+        const int32_t cz = (m[6] * x + m[7] * y + m[8] * z) >> kShift;
+        x = cx;
+        y = cy;
+        z = cz;
+    }
+};
+
+inline constexpr Mount kIdentityMount = {{Mount::kOne, 0, 0, 0, Mount::kOne, 0, 0, 0,
+                                          Mount::kOne}};
+
+/// The cube face that points where sensor face `face` does, e.g. to map the
+/// LIS3DH 6D engine's answer. kUnknown stays kUnknown.
+constexpr Face cube_face(const Mount& mount, Face face) {
+    if (face == Face::kUnknown) {
+        return face;
+    }
+    const unsigned axis = face_index(face) / 2;
+    const int32_t sign = face_index(face) % 2 == 0 ? 1 : -1;
+    unsigned best = 0;
+    int32_t best_abs = 0;
+    for (unsigned r = 0; r < 3; ++r) {
+        const int32_t v = mount.m[r * 3 + axis];
+        if ((v < 0 ? -v : v) > best_abs) {
+            best = r;
+            best_abs = v < 0 ? -v : v;
+        }
+    }
+    const bool negative = (mount.m[best * 3 + axis] < 0) != (sign < 0);
+    return static_cast<Face>(best * 2 + (negative ? 1 : 0));
+}
+
+static_assert(cube_face(kIdentityMount, Face::kYNeg) == Face::kYNeg);
+static_assert(cube_face(Mount{{0, -Mount::kOne, 0, Mount::kOne, 0, 0, 0, 0, Mount::kOne}},
+                        Face::kXPos) == Face::kYPos);
+
+/// Mean resting reading with one face up, in 12-bit counts (mg at +/-2 g).
+struct Gravity {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+};
+
+/// Limits a set of six readings must meet before it becomes a Mount.
+struct MountLimits {
+    /// Accepted |g|^2 band per face, in counts^2.
+    uint32_t min_mag2;
+    uint32_t max_mag2;
+    /// sin^2 of the largest skew accepted between measured cube axes. Any
+    /// more and a face was not sitting flat while it was recorded.
+    uq15_t max_skew_sin2;
+};
+
+constexpr MountLimits make_mount_limits(double max_skew_deg, double min_g = 0.85,
+                                        double max_g = 1.15) {
+    const double c = cmath::cos(cmath::radians(max_skew_deg));
+    return MountLimits{static_cast<uint32_t>(min_g * min_g * 1e6 + 0.5),
+                       static_cast<uint32_t>(max_g * max_g * 1e6 + 0.5), to_uq15(1 - c * c)};
+}
+
+enum class MountError : uint8_t {
+    kNone,
+    kMagnitude,  // a face reading outside the |g| band
+    kSkew,       // measured axes too far from perpendicular
+    kMirrored,   // left-handed axes: faces recorded out of order
+};
+
+/// Builds the mount from one reading per face, indexed by face_index().
+/// Opposite faces are differenced, which cancels the sensor's zero-g
+/// offset; Z is kept as measured, X is made perpendicular to it and Y is
+/// their cross product.
+[[nodiscard]] MountError solve_mount(const Gravity (&up)[kFaceCount], const MountLimits& limits,
+                                     Mount& out);
+
+}  // namespace tilt
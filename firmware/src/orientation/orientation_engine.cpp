@@ -0,0 +1,354 @@
+#include "orientation/orientation_engine.hpp"
+
+#include "diag/trace.hpp"
+#include "drivers/lis3dh_regs.hpp"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "orientation/mount.hpp"
+#include "pico/time.h"
+
+namespace tilt {
+
+namespace {
+
+// 6D zone threshold at +/-2 g (16 mg/LSB): ~0.7 g, i.e. ~45 degrees off axis.
+constexpr uint8_t kFaceThreshold = 0x2C;
+// Samples the position must hold before IA1 latches (1/ODR each).
+constexpr uint8_t kFaceDuration = 1;
+
+// Sleep-to-wake: 128 mg for (8 * ACT_DUR + 1) / ODR ~= 2 s of stillness.
+constexpr uint8_t kActThreshold = 0x08;
+constexpr uint32_t kStillMs = 2000;
+
+constexpr uint8_t act_dur(uint32_t odr_hz) {
+    return static_cast<uint8_t>((kStillMs * odr_hz / 1000 + 7) / 8);
+}
+static_assert(act_dur(OrientationEngine::kSampleRateHz) == 50);
+
+}  // namespace
+
+OrientationEngine* OrientationEngine::instance_ = nullptr;
+
+OrientationEngine::OrientationEngine(Lis3dh& accel, unsigned int1_pin, unsigned int2_pin)
+    : accel_(accel), int1_pin_(int1_pin), int2_pin_(int2_pin) {
+    src_sub_ = lis3dh::reg::kInt1Src;
+    src_txn_.address = accel.address();
+    src_txn_.priority = I2cPriority::kSensor;
+    src_txn_.write = &src_sub_;
+    src_txn_.write_len = 1;
+    src_txn_.read = &src_value_;
+    src_txn_.read_len = 1;
+    src_txn_.callback = &OrientationEngine::on_src_read;
+    src_txn_.ctx = this;
+    gesture_sub_ = lis3dh::reg::kInt2Src | lis3dh::reg::kAutoIncrement;
+    gesture_txn_.address = accel.address();
+    gesture_txn_.priority = I2cPriority::kSensor;
+    gesture_txn_.write = &gesture_sub_;
+    gesture_txn_.write_len = 1;
+    gesture_txn_.read = gesture_src_;
+    gesture_txn_.read_len = kGestureSrcLen;
+    gesture_txn_.callback = &OrientationEngine::on_gesture_read;
+    gesture_txn_.ctx = this;
+}
+
+CoTask OrientationEngine::configure() {
+    using namespace lis3dh;
+    if (!co_await accel_.probe_async()) {
+        co_return false;
+    }
+    if (gestures_ != nullptr && !co_await gestures_->configure(accel_, run_hz_)) {
+        co_return false;
+    }
+    const uint8_t int2_gestures = gestures_ ? kCtrl6I2Click | kCtrl6I2Ia2 : 0;
+    const uint8_t writes[][2] = {
+        {reg::kCtrlReg1, ctrl1(run_odr_, false)},
+        {reg::kCtrlReg4, kCtrl4Bdu | kCtrl4Fs2g},
+        {reg::kInt1Cfg, kIntCfgAoi | kIntCfg6d | kIntCfgAllAxes},
+        {reg::kInt1Ths, kFaceThreshold},
+        {reg::kInt1Duration, kFaceDuration},
+        {reg::kActThs, kActThreshold},
+        {reg::kActDur, act_dur(run_hz_)},
+        {reg::kCtrlReg5,
+         static_cast<uint8_t>(kCtrl5LatchInt1 | (gestures_ ? kCtrl5LatchInt2 : 0))},
+        {reg::kCtrlReg3, static_cast<uint8_t>(classifier_ ? 0 : kCtrl3I1Ia1)},
+        {reg::kCtrlReg6, static_cast<uint8_t>(kCtrl6I2Act | int2_gestures)},
+    };
+    for (const auto& w : writes) {
+        if (!co_await accel_.write_reg_async(w[0], w[1])) {
+            co_return false;
+        }
+    }
+    // Stream mode keeps the newest 32 samples and raises WTM on INT1.
+    if (fifo_ != nullptr) {
+        const bool ok = co_await fifo_->enable_async(FifoMode::kStream, watermark_);
+        fifo_watermark_ = ok ? watermark_ : 0;
+        co_return ok;
+    }
+    co_return true;
+}
+
+CoTask OrientationEngine::set_run_odr(lis3dh::Odr odr, uint32_t hz) {
+    using namespace lis3dh;
+    run_odr_ = odr;
+    run_hz_ = hz;
+    if (!co_await accel_.write_reg_async(reg::kCtrlReg1, ctrl1(odr, false)) ||
+        !co_await accel_.write_reg_async(reg::kActDur, act_dur(hz))) {
+        co_return false;
+    }
+    co_return gestures_ == nullptr || co_await gestures_->retime(accel_, hz);
+}
+
+bool OrientationEngine::init() {
+    using namespace lis3dh;
+    if (!sync_wait(configure())) {
+        return false;
+    }
+
+    instance_ = this;
+    const unsigned pins[] = {int1_pin_, int2_pin_};
+    for (unsigned pin : pins) {
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_IN);
+        gpio_pull_down(pin);
+    }
+    // One shared-handler slot for both lines.
+    gpio_add_raw_irq_handler_masked((1u << int1_pin_) | (1u << int2_pin_),
+                                    &OrientationEngine::gpio_irq_handler);
+    gpio_set_irq_enabled(int1_pin_, GPIO_IRQ_EDGE_RISE, true);
+    gpio_set_irq_enabled(int2_pin_, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    // The sensor may have latched before the GPIO edge detector was armed;
+    // reading INT1_SRC both fetches the resting face and re-arms the latch.
+    // A gesture latched since configure() would mask the wake state.
+    if (gestures_ != nullptr &&
+        !accel_.read_regs(reg::kInt2Src | reg::kAutoIncrement, gesture_src_, kGestureSrcLen)) {
+        return false;
+    }
+    set_motion(!gpio_get(int2_pin_));
+    uint8_t src = 0;
+    if (!accel_.read_reg(reg::kInt1Src, src)) {
+        return false;
+    }
+    apply_src(src);
+    if (classifier_ != nullptr) {
+        classifier_->reset(face_);
+        // WTM is level-triggered; a FIFO already past it never edges.
+        if (gpio_get(int1_pin_)) {
+            set_pending(kPendingInt1);
+        }
+    }
+    return true;
+}
+
+bool OrientationEngine::service() {
+    const uint32_t status = save_and_disable_interrupts();
+    const uint32_t pending = pending_;
+    pending_ = 0;
+    restore_interrupts(status);
+
+    // Results before the reads that refill them: the INT2 burst read
+    // writes gesture_src_ from the bus IRQ.
+    if (pending & kPendingGesture) {
+        apply_gesture();
+    }
+    if (pending & kPendingInt2) {
+        if (gestures_ != nullptr) {
+            // The gesture latches share the line; in_motion_ is updated once
+            // the read has cleared them.
+            accel_.bus().submit(gesture_txn_);
+        } else {
+            // INT2 is high while the sensor sits in its inactive low-power state.
+            set_motion(!gpio_get(int2_pin_));
+        }
+    }
+    // The same for INT1: a drain or INT1_SRC read started first would
+    // rewrite batch_ or src_value_ while they are still being read.
+    if (pending & kPendingSrc) {
+        const Face previous = face_;
+        apply_src(src_value_);
+        notify(previous);
+    }
+    if (pending & kPendingBatch) {
+        classify();
+    }
+    if (pending & kPendingInt1) {
+        if (classifier_ != nullptr) {
+            // A drain in flight will pick up whatever raised the line.
+            (void)fifo_->start_drain(&OrientationEngine::on_batch, this);
+        } else {
+            // Already queued means a read is in flight and will see the latch.
+            accel_.bus().submit(src_txn_);
+        }
+    }
+    if (pending & kPendingRetune) {
+        retune_fifo();
+        // A lower mark may already be passed, which raises no edge.
+        if (gpio_get(int1_pin_)) {
+            set_pending(kPendingInt1);
+        }
+    }
+    return pending != 0;
+}
+
+void OrientationEngine::classify() {
+    if (tap_ != nullptr) {
+        tap_(*batch_, !in_motion_, tap_ctx_);
+    }
+    const Face previous = face_;
+    trace::record(trace::Event::kTiltBatch, batch_->count);
+    if (classifier_->update(batch_->samples.data(), batch_->count)) {
+        face_ = classifier_->face();
+    }
+    notify(previous);
+    // Samples that landed during the burst may have refilled past the
+    // watermark without a new edge.
+    if (gpio_get(int1_pin_)) {
+        set_pending(kPendingInt1);
+    }
+}
+
+void OrientationEngine::apply_gesture() {
+    using namespace lis3dh;
+    const uint8_t int2_src = gesture_src_[0];
+    const uint8_t click_src = gesture_src_[reg::kClickSrc - reg::kInt2Src];
+    set_motion(!gpio_get(int2_pin_));
+    // A latch set again since the read holds the line high without an edge;
+    // read until a burst finds nothing, which leaves only the wake state.
+    if (!in_motion_ && ((int2_src & kIntSrcActive) || (click_src & kClickSrcActive))) {
+        set_pending(kPendingInt2);
+    }
+    const uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    const Gesture gesture = gestures_->decode(int2_src, click_src, now_ms);
+    if (gesture != Gesture::kNone) {
+        trace::record(trace::Event::kGesture, static_cast<uint16_t>(gesture));
+    }
+    if (gesture != Gesture::kNone && gesture_cb_ != nullptr) {
+        gesture_cb_(gesture, gesture_ctx_);
+    }
+}
+
+void OrientationEngine::set_motion(bool in_motion) {
+    in_motion_ = in_motion;
+    if (fifo_ != nullptr) {
+        retune_fifo();
+    }
+}
+
+void OrientationEngine::retune_fifo() {
+    const uint8_t want = in_motion_ ? watermark_ : kRestWatermark;
+    // One write at a time; on_retuned() comes back here for any later change.
+    if (retuning_ || want == fifo_watermark_) {
+        return;
+    }
+    retuning_ = true;
+    fifo_watermark_ = want;
+    spawn(fifo_->set_watermark_async(want), &OrientationEngine::on_retuned, this);
+}
+
+void OrientationEngine::notify(Face previous) {
+    if (face_ != previous) {
+        trace::record(trace::Event::kTiltFace, static_cast<uint16_t>(face_));
+    }
+    if (face_ != previous && face_cb_ != nullptr) {
+        face_cb_(face_, face_ctx_);
+    }
+}
+
+Face OrientationEngine::face_from_int_src(uint8_t src) {
+    using namespace lis3dh;
+    if (!(src & kIntSrcActive)) {
+        return Face::kUnknown;
+    }
+    // In 6D position mode exactly one axis flag is set once IA latches.
+    if (src & kIntSrcXHigh) {
+        return Face::kXPos;
+    }
+    if (src & kIntSrcXLow) {
+        return Face::kXNeg;
+    }
+    if (src & kIntSrcYHigh) {
+        return Face::kYPos;
+    }
+    if (src & kIntSrcYLow) {
+        return Face::kYNeg;
+    }
+    if (src & kIntSrcZHigh) {
+        return Face::kZPos;
+    }
+    if (src & kIntSrcZLow) {
+        return Face::kZNeg;
+    }
+    return Face::kUnknown;
+}
+
+void OrientationEngine::apply_src(uint8_t src) {
+    Face face = face_from_int_src(src);
+    // The 6D engine answers in sensor axes; the classifier works in cube axes.
+    if (classifier_ != nullptr) {
+        face = cube_face(classifier_->mount(), face);
+    }
+    if (face != Face::kUnknown) {
+        face_ = face;
+    }
+}
+
+void OrientationEngine::set_pending(uint32_t bits) {
+    const uint32_t status = save_and_disable_interrupts();
+    pending_ = pending_ | bits;
+    restore_interrupts(status);
+    if (notify_fn_ != nullptr) {
+        notify_fn_(notify_ctx_);
+    }
+}
+
+void OrientationEngine::on_src_read(I2cTransaction&, bool ok, void* ctx) {
+    auto* self = static_cast<OrientationEngine*>(ctx);
+    // A failed read leaves INT1 latched high; retry via the INT1 path.
+    self->set_pending(ok ? kPendingSrc : kPendingInt1);
+}
+
+void OrientationEngine::on_batch(const AccelBatch& batch, bool ok, void* ctx) {
+    auto* self = static_cast<OrientationEngine*>(ctx);
+    // The batch stays valid until the next drain, which only service() starts.
+    self->batch_ = &batch;
+    self->set_pending(ok ? kPendingBatch : kPendingInt1);
+}
+
+void OrientationEngine::on_gesture_read(I2cTransaction&, bool ok, void* ctx) {
+    auto* self = static_cast<OrientationEngine*>(ctx);
+    // A failed read leaves the latches set; retry via the INT2 path.
+    self->set_pending(ok ? kPendingGesture : kPendingInt2);
+}
+
+void OrientationEngine::on_retuned(bool ok, void* ctx) {
+    auto* self = static_cast<OrientationEngine*>(ctx);
+    if (!ok) {
+        self->fifo_watermark_ = 0;
+    }
+    self->retuning_ = false;
+    self->set_pending(kPendingRetune);
+}
+
+void OrientationEngine::gpio_irq_handler() {
+    OrientationEngine* self = instance_;
+    uint32_t pending = 0;
+    if (const uint32_t events = gpio_get_irq_event_mask(self->int1_pin_)) {
+        trace::record(trace::Event::kIsrGpio, static_cast<uint16_t>(self->int1_pin_));
+        gpio_acknowledge_irq(self->int1_pin_, events);
+        pending |= kPendingInt1;
+    }
+    if (const uint32_t events = gpio_get_irq_event_mask(self->int2_pin_)) {
+        trace::record(trace::Event::kIsrGpio, static_cast<uint16_t>(self->int2_pin_));
+        gpio_acknowledge_irq(self->int2_pin_, events);
+        pending |= kPendingInt2;
+    }
+    // Another handler's pin: nothing to notify.
+    if (pending == 0) {
+        return;
+    }
+    self->set_pending(pending);
+}
+
+}  // namespace tilt
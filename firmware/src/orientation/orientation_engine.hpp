@@ -0,0 +1,187 @@
+// Interrupt-driven face detection using the LIS3DH 6D and activity engines.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "drivers/lis3dh.hpp"
+#include "drivers/lis3dh_fifo.hpp"
+#include "drivers/lis3dh_regs.hpp"
+#include "orientation/face.hpp"
+#include "orientation/gesture_detector.hpp"
+#include "orientation/tilt_classifier.hpp"
+#include "sched/co_task.hpp"
+
+namespace tilt {
+
+/// Lets the LIS3DH do orientation classification in hardware and only
+/// touches the bus when the sensor signals a change.
+///
+/// INT1 carries the 6D position generator (IA1): it latches whenever the
+/// sensor settles in a new face zone, and INT1_SRC holds that face.
+/// INT2 carries the sleep-to-wake activity engine: while the cube rests the
+/// sensor drops itself to 10 Hz low-power, and it returns to the configured
+/// ODR as soon as motion starts, so a flip that lands is reported within one
+/// sample period of the run ODR.
+///
+/// The INT1_SRC read is queued at sensor priority on the shared bus, so
+/// service() never waits for an in-flight display transfer.
+///
+/// With a classifier attached, INT1 carries the FIFO watermark instead and
+/// the face comes from TiltClassifier over the drained samples. The 6D
+/// engine then only seeds the initial face. This trades a little latency
+/// (watermark plus dwell) for tunable thresholds and hysteresis. While U2
+/// rests at 10 Hz the watermark moves up to kRestWatermark, so INT1 (and,
+/// from dormant, the whole chip) wakes every few seconds instead of several
+/// times a second; the activity edge that ends the rest restores the run
+/// watermark before the first moving batch is due. That edge is INT2
+/// falling, so it has to be a dormant wake source as well as INT1 rising
+/// (PowerManager::init); otherwise a flip out of rest waits for the rest
+/// watermark to fill at the run ODR (`tilt_sim --rest-flip`).
+///
+/// With a gesture detector attached, INT2 also carries the click and IA2
+/// engines (latched). An INT2 edge then reads INT2_SRC..CLICK_SRC in one
+/// burst first: that clears the latches, so the line level afterwards is
+/// the sleep-to-wake state again.
+class OrientationEngine {
+public:
+    using FaceCallback = void (*)(Face face, void* ctx);
+    using GestureCallback = void (*)(Gesture gesture, void* ctx);
+    /// Sees every drained batch in classifier mode, from service().
+    /// `low_power` is true while U2 sits in its 10 Hz sleep-to-wake state.
+    using BatchTap = void (*)(const AccelBatch& batch, bool low_power, void* ctx);
+    /// Called, possibly from interrupt context, whenever service() has new
+    /// work; lets an event loop schedule it instead of polling.
+    using Notify = void (*)(void* ctx);
+
+    /// ODR while the cube is handled at full power; classifier dwell is
+    /// counted in these.
+    static constexpr uint32_t kSampleRateHz = 200;
+
+    /// FIFO watermark while U2 is in its 10 Hz sleep-to-wake state: 3 s.
+    static constexpr uint8_t kRestWatermark = 30;
+
+    OrientationEngine(Lis3dh& accel, unsigned int1_pin, unsigned int2_pin);
+
+    /// Switches to FIFO + software classification. Call before init().
+    /// `watermark` is the batch size in samples, 1..31.
+    void attach_classifier(Lis3dhFifo& fifo, TiltClassifier& classifier, uint8_t watermark) {
+        fifo_ = &fifo;
+        classifier_ = &classifier;
+        watermark_ = watermark;
+    }
+
+    /// Adds tap and shake detection on INT2. Call before init().
+    void attach_gestures(GestureDetector& gestures) { gestures_ = &gestures; }
+
+    /// Configures U2 and arms the GPIO interrupts. Only one engine may exist.
+    [[nodiscard]] bool init();
+
+    /// The register half of init(): probe, interrupt and FIFO setup, with
+    /// the caller free while each write is on the bus.
+    CoTask configure();
+
+    /// Changes the run ODR (and rescales the sleep-to-wake delay so it
+    /// still takes ~2 s of stillness). The classifier counts its dwell in
+    /// samples, so the caller swaps in a TiltConfig built for `hz`.
+    CoTask set_run_odr(lis3dh::Odr odr, uint32_t hz);
+
+    void set_face_callback(FaceCallback cb, void* ctx) {
+        face_cb_ = cb;
+        face_ctx_ = ctx;
+    }
+
+    /// Called from service() for each recognised gesture.
+    void set_gesture_callback(GestureCallback cb, void* ctx) {
+        gesture_cb_ = cb;
+        gesture_ctx_ = ctx;
+    }
+
+    void set_notify(Notify fn, void* ctx) {
+        notify_ctx_ = ctx;
+        notify_fn_ = fn;
+    }
+
+    void set_batch_tap(BatchTap tap, void* ctx) {
+        tap_ = tap;
+        tap_ctx_ = ctx;
+    }
+
+    /// Services latched interrupt lines from thread context. Returns true if
+    /// any work was done so the caller can re-check before sleeping.
+    bool service();
+
+    /// True if an interrupt is waiting for service().
+    bool pending() const { return pending_ != 0; }
+
+    /// Forces both lines to be re-read on the next service(). Needed after
+    /// dormant, where the wake edge is consumed by the clock wake logic and
+    /// never reaches the GPIO interrupt.
+    void resync() { set_pending(kPendingInt1 | kPendingInt2); }
+
+    Face face() const { return face_; }
+    bool in_motion() const { return in_motion_; }
+
+    static Face face_from_int_src(uint8_t src);
+
+private:
+    static constexpr uint32_t kPendingInt1 = 1u << 0;
+    static constexpr uint32_t kPendingInt2 = 1u << 1;
+    static constexpr uint32_t kPendingSrc = 1u << 2;
+    static constexpr uint32_t kPendingBatch = 1u << 3;
+    static constexpr uint32_t kPendingGesture = 1u << 4;
+    static constexpr uint32_t kPendingRetune = 1u << 5;
+
+    // INT2_SRC through CLICK_SRC.
+    static constexpr size_t kGestureSrcLen = 5;
+
+    static void gpio_irq_handler();
+    static void on_src_read(I2cTransaction& txn, bool ok, void* ctx);
+    static void on_batch(const AccelBatch& batch, bool ok, void* ctx);
+    static void on_gesture_read(I2cTransaction& txn, bool ok, void* ctx);
+    static void on_retuned(bool ok, void* ctx);
+
+    void set_pending(uint32_t bits);
+    void apply_src(uint8_t src);
+    void classify();
+    void apply_gesture();
+    void set_motion(bool in_motion);
+    void retune_fifo();
+    void notify(Face previous);
+
+    Lis3dh& accel_;
+    unsigned int1_pin_;
+    unsigned int2_pin_;
+    volatile uint32_t pending_ = 0;
+    I2cTransaction src_txn_;
+    uint8_t src_sub_ = 0;
+    uint8_t src_value_ = 0;
+    I2cTransaction gesture_txn_;
+    uint8_t gesture_sub_ = 0;
+    uint8_t gesture_src_[kGestureSrcLen] = {};
+    GestureDetector* gestures_ = nullptr;
+    Lis3dhFifo* fifo_ = nullptr;
+    TiltClassifier* classifier_ = nullptr;
+    const AccelBatch* batch_ = nullptr;
+    uint8_t watermark_ = 0;
+    // What FIFO_CTRL holds (0 = unknown after a failed write).
+    uint8_t fifo_watermark_ = 0;
+    volatile bool retuning_ = false;
+    // One sample every 5 ms until the governor says otherwise.
+    lis3dh::Odr run_odr_ = lis3dh::Odr::k200Hz;
+    uint32_t run_hz_ = kSampleRateHz;
+    Face face_ = Face::kUnknown;
+    bool in_motion_ = false;
+    FaceCallback face_cb_ = nullptr;
+    void* face_ctx_ = nullptr;
+    GestureCallback gesture_cb_ = nullptr;
+    void* gesture_ctx_ = nullptr;
+    BatchTap tap_ = nullptr;
+    void* tap_ctx_ = nullptr;
+    Notify notify_fn_ = nullptr;
+    void* notify_ctx_ = nullptr;
+
+    static OrientationEngine* instance_;
+};
+
+}  // namespace tilt
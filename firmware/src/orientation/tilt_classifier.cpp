@@ -0,0 +1,76 @@
+#include "orientation/tilt_classifier.hpp"
+
+namespace tilt {
+
+bool TiltClassifier::update(const AccelSample& sample) {
+    int32_t x = sample.x >> 4;
+    int32_t y = sample.y >> 4;
+    int32_t z = sample.z >> 4;
+    if (rotate_) {
+        mount_.apply(x, y, z);
+    }
+    return classify(x, y, z);
+}
+
+bool TiltClassifier::classify(int32_t x, int32_t y, int32_t z) {
+    const uint32_t xx = static_cast<uint32_t>(x * x);
+    const uint32_t yy = static_cast<uint32_t>(y * y);
+    const uint32_t zz = static_cast<uint32_t>(z * z);
+    const uint32_t mag2 = xx + yy + zz;
+
+    if (mag2 < config_.min_mag2 || mag2 > config_.max_mag2) {
+        count_ = 0;
+        return false;
+    }
+
+    Face face;
+    uint32_t dom2;
+    if (xx >= yy && xx >= zz) {
+        face = x >= 0 ? Face::kXPos : Face::kXNeg;
+        dom2 = xx;
+    } else if (yy >= zz) {
+        face = y >= 0 ? Face::kYPos : Face::kYNeg;
+        dom2 = yy;
+    } else {
+        face = z >= 0 ? Face::kZPos : Face::kZNeg;
+        dom2 = zz;
+    }
+
+    // cos^2(angle to axis) = dom2 / mag2; compare without dividing.
+    if (face == face_ || dom2 < mul_q15(mag2, config_.enter_cos2)) {
+        count_ = 0;
+        return false;
+    }
+    if (face != candidate_) {
+        candidate_ = face;
+        count_ = 0;
+    }
+    if (++count_ < config_.dwell_samples) {
+        return false;
+    }
+    face_ = face;
+    count_ = 0;
+    return true;
+}
+
+bool TiltClassifier::update(const AccelSample* samples, size_t count) {
+    // One branch per batch; the loops differ only in the rotation.
+    bool changed = false;
+    if (!rotate_) {
+        for (size_t i = 0; i < count; ++i) {
+            changed |= classify(samples[i].x >> 4, samples[i].y >> 4, samples[i].z >> 4);
+        }
+        return changed;
+    }
+    const Mount mount = mount_;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t x = samples[i].x >> 4;
+        int32_t y = samples[i].y >> 4;
+        int32_t z = samples[i].z >> 4;
+        mount.apply(x, y, z);
+        changed |= classify(x, y, z);
+    }
+    return changed;
+}
+
+}  // namespace tilt
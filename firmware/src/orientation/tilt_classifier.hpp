@@ -0,0 +1,89 @@
+// Fixed-point face classifier with angular hysteresis and dwell.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "drivers/accel_sample.hpp"
+#include "orientation/face.hpp"
+#include "orientation/mount.hpp"
+#include "util/constexpr_math.hpp"
+#include "util/fixed_point.hpp"
+
+namespace tilt {
+
+/// Classifier thresholds, in the units the hot path compares directly.
+/// Samples are taken as 12-bit counts (raw >> 4), which at +/-2 g is 1 mg
+/// per LSB in high-resolution mode and still mg-scaled in lower modes.
+struct TiltConfig {
+    /// cos^2 of the cone a new face must be inside before it can win.
+    uq15_t enter_cos2;
+    /// Consecutive in-cone samples required before switching.
+    uint16_t dwell_samples;
+    /// Accepted |a|^2 band; outside it the cube is being thrown or shaken.
+    uint32_t min_mag2;
+    uint32_t max_mag2;
+};
+
+/// `enter_deg` is the cone half-angle around a face axis. Anything below
+/// 45 degrees leaves a dead band between faces where the current face holds,
+/// which is the hysteresis: 30 degrees gives 30 degrees of it.
+constexpr TiltConfig make_tilt_config(double enter_deg, uint32_t dwell_ms, uint32_t odr_hz,
+                                      double min_g = 0.7, double max_g = 1.3) {
+    const double c = cmath::cos(cmath::radians(enter_deg));
+    uint32_t dwell = dwell_ms * odr_hz / 1000;
+    if (dwell == 0) {
+        dwell = 1;
+    }
+    return TiltConfig{to_uq15(c * c), static_cast<uint16_t>(dwell),
+                      static_cast<uint32_t>(min_g * min_g * 1e6 + 0.5),
+                      static_cast<uint32_t>(max_g * max_g * 1e6 + 0.5)};
+}
+
+/// Turns raw samples into a debounced resting face using only integer
+/// multiplies: three squares per sample, one Q15 scale, no sqrt or division.
+///
+/// With a mount set, each batch is first rotated into cube-face axes (nine
+/// more multiplies per sample), so a unit whose sensor sits a few degrees
+/// off in the shell still rests on axis and the cone can stay tight.
+class TiltClassifier {
+public:
+    explicit TiltClassifier(const TiltConfig& config) : config_(config) {}
+
+    /// Feeds one sample. Returns true when the stable face changes.
+    bool update(const AccelSample& sample);
+
+    /// Feeds a batch; returns true if the stable face changed at any point.
+    bool update(const AccelSample* samples, size_t count);
+
+    Face face() const { return face_; }
+
+    /// Forces the stable face, e.g. from the LIS3DH 6D engine at start-up.
+    void reset(Face face) {
+        face_ = face;
+        candidate_ = Face::kUnknown;
+        count_ = 0;
+    }
+
+    void set_config(const TiltConfig& config) { config_ = config; }
+    const TiltConfig& config() const { return config_; }
+
+    void set_mount(const Mount& mount) {
+        mount_ = mount;
+        rotate_ = mount.m != kIdentityMount.m;
+    }
+    const Mount& mount() const { return mount_; }
+    bool mounted() const { return rotate_; }
+
+private:
+    bool classify(int32_t x, int32_t y, int32_t z);
+
+    TiltConfig config_;
+    Mount mount_ = kIdentityMount;
+    bool rotate_ = false;
+    Face face_ = Face::kUnknown;
+    Face candidate_ = Face::kUnknown;
+    uint16_t count_ = 0;
+};
+
+}  // namespace tilt
@@ -0,0 +1,112 @@
+#include "power/battery_monitor.hpp"
+
+#include "diag/trace.hpp"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "power/clock_tree.hpp"
+
+namespace tilt {
+
+namespace {
+constexpr unsigned kAdcCounts = 4096;
+
+constexpr uint32_t mv_per_count_q16(const board::BatterySense& sense) {
+    if (!board::has(sense.pin)) {
+        return 0;
+    }
+    const uint64_t ratio_ohms = sense.divider_top_ohms + sense.divider_bottom_ohms;
+    return static_cast<uint32_t>((uint64_t{sense.reference_mv} * ratio_ohms << 16) /
+                                 (uint64_t{kAdcCounts} * sense.divider_bottom_ohms));
+}
+}  // namespace
+
+BatteryMonitor* BatteryMonitor::instance_ = nullptr;
+
+BatteryMonitor::BatteryMonitor(const board::BatterySense& sense)
+    : pin_(sense.pin), adc_input_(sense.adc_input), mv_per_count_q16_(mv_per_count_q16(sense)) {}
+
+bool BatteryMonitor::init() {
+    const int chan = dma_claim_unused_channel(false);
+    if (chan < 0) {
+        return false;
+    }
+    dma_chan_ = static_cast<unsigned>(chan);
+
+    // adc_init() waits for READY, which needs clk_adc.
+    clock_tree::start_adc_clock();
+    adc_init();
+    adc_gpio_init(pin_);
+    adc_select_input(adc_input_);
+    // DREQ at one sample, no error bit, full 12-bit results.
+    adc_fifo_setup(true, true, 1, false, false);
+    hw_clear_bits(&adc_hw->cs, ADC_CS_EN_BITS);
+    clock_tree::stop_adc_clock();
+
+    instance_ = this;
+    dma_channel_set_irq0_enabled(dma_chan_, true);
+    irq_add_shared_handler(DMA_IRQ_0, &BatteryMonitor::dma_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+    return true;
+}
+
+bool BatteryMonitor::start() {
+    if (busy_) {
+        return false;
+    }
+    busy_ = true;
+    clock_tree::start_adc_clock();
+    hw_set_bits(&adc_hw->cs, ADC_CS_EN_BITS);
+    while (!(adc_hw->cs & ADC_CS_READY_BITS)) {
+    }
+    adc_fifo_drain();
+
+    dma_channel_config c = dma_channel_get_default_config(dma_chan_);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    dma_channel_configure(dma_chan_, &c, samples_, &adc_hw->fifo, kSamples, true);
+    adc_run(true);
+    return true;
+}
+
+bool BatteryMonitor::take_fresh() {
+    const uint32_t irq = save_and_disable_interrupts();
+    const bool fresh = fresh_;
+    fresh_ = false;
+    restore_interrupts(irq);
+    return fresh;
+}
+
+void BatteryMonitor::finish() {
+    adc_run(false);
+    adc_fifo_drain();
+    hw_clear_bits(&adc_hw->cs, ADC_CS_EN_BITS);
+    clock_tree::stop_adc_clock();
+
+    uint32_t sum = 0;
+    for (uint16_t s : samples_) {
+        sum += s;
+    }
+    const uint32_t average = (sum + kSamples / 2) / kSamples;
+    millivolts_ = static_cast<uint16_t>((average * mv_per_count_q16_ + (1u << 15)) >> 16);
+    fresh_ = true;
+    busy_ = false;
+    if (notify_fn_ != nullptr) {
+        notify_fn_(notify_ctx_);
+    }
+}
+
+void BatteryMonitor::dma_irq_handler() {
+    trace::record(trace::Event::kIsrDma0);
+    BatteryMonitor* self = instance_;
+    if (self != nullptr && dma_channel_get_irq0_status(self->dma_chan_)) {
+        dma_channel_acknowledge_irq0(self->dma_chan_);
+        self->finish();
+    }
+}
+
+}  // namespace tilt
@@ -0,0 +1,69 @@
+// BT1 voltage through the board divider, averaged over a DMA burst.
+#pragma once
+
+#include <cstdint>
+
+#include "board/board_config.hpp"
+
+namespace tilt {
+
+/// Occasional battery readings with no CPU work during the conversion.
+///
+/// start() powers the ADC and clk_adc, and a DMA channel paced by the ADC's
+/// DREQ copies kSamples free-running conversions out of its FIFO. The
+/// completion IRQ (DMA_IRQ_0, on the core that called init()) powers both
+/// down again, averages the burst and converts it to millivolts at BT1.
+/// A burst takes about kSamples * 15 us from the ROSC.
+class BatteryMonitor {
+public:
+    /// Called from the DMA IRQ when a reading is ready.
+    using Notify = void (*)(void* ctx);
+
+    static constexpr unsigned kSamples = 16;
+
+    /// The divider ratio is (top + bottom) / bottom. A board without the
+    /// divider (pin kNoPin) must not call init().
+    explicit BatteryMonitor(const board::BatterySense& sense);
+
+    /// Sets up the pin and ADC and claims a DMA channel. Only one monitor
+    /// may exist.
+    [[nodiscard]] bool init();
+
+    /// Starts a reading. Returns false if one is already running.
+    bool start();
+
+    /// True while the ADC is converting; clk_adc is running, so the chip
+    /// must not go dormant.
+    bool busy() const { return busy_; }
+
+    /// Latest averaged reading in mV at BT1; 0 until the first completes.
+    uint16_t millivolts() const { return millivolts_; }
+
+    /// Clears and returns whether a reading finished since the last call.
+    bool take_fresh();
+
+    void set_notify(Notify fn, void* ctx) {
+        notify_ctx_ = ctx;
+        notify_fn_ = fn;
+    }
+
+private:
+    static void dma_irq_handler();
+    void finish();
+
+    unsigned pin_;
+    unsigned adc_input_;
+    // Q16 millivolts per ADC count, divider included.
+    uint32_t mv_per_count_q16_;
+    unsigned dma_chan_ = 0;
+    volatile bool busy_ = false;
+    volatile bool fresh_ = false;
+    volatile uint16_t millivolts_ = 0;
+    uint16_t samples_[kSamples] = {};
+    Notify notify_fn_ = nullptr;
+    void* notify_ctx_ = nullptr;
+
+    static BatteryMonitor* instance_;
+};
+
+}  // namespace tilt
@@ -0,0 +1,87 @@
+#include "power/clock_tree.hpp"
+
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/structs/clocks.h"
+#include "hardware/structs/xosc.h"
+#include "hardware/watchdog.h"
+
+namespace tilt::clock_tree {
+
+namespace {
+// clk_rtc must be an integer-ish divide down to something the RTC can turn
+// into 1 Hz; 46875 Hz is the value the SDK uses with a 12 MHz crystal.
+constexpr uint32_t kRtcHz = 46'875;
+
+constexpr uint32_t kXoscHz = 12'000'000;
+constexpr uint32_t kUsbHz = 48'000'000;
+// ~1 ms of crystal start-up in units of 256 XOSC cycles, as the SDK uses.
+constexpr uint32_t kXoscStartupDelay = (kXoscHz / 1000 + 128) / 256;
+// Status polls before giving up on a missing crystal (tens of ms).
+constexpr uint32_t kXoscStablePolls = 100'000;
+
+// Any ENABLE code other than the two magic values turns the XOSC on.
+void xosc_disable() {
+    xosc_hw->ctrl = XOSC_CTRL_FREQ_RANGE_VALUE_1_15MHZ |
+                    (XOSC_CTRL_ENABLE_VALUE_DISABLE << XOSC_CTRL_ENABLE_LSB);
+}
+}  // namespace
+
+void init() {
+    constexpr uint32_t f = kRoscNominalHz;
+    clock_configure(clk_ref, CLOCKS_CLK_REF_CTRL_SRC_VALUE_ROSC_CLKSRC_PH, 0, f, f);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_ROSC_CLKSRC, f, f);
+    // clk_peri straight from the ROSC rather than clk_sys, so scaling the
+    // core clock never changes I2C/UART baud rates.
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_ROSC_CLKSRC_PH, f, f);
+    clock_configure(clk_rtc, 0, CLOCKS_CLK_RTC_CTRL_AUXSRC_VALUE_ROSC_CLKSRC_PH, f, kRtcHz);
+    watchdog_start_tick(f / MHZ);
+}
+
+void set_sys_divider(uint32_t div) {
+    // clk_sys is glitchless, so its integer divider may change on the fly.
+    clocks_hw->clk[clk_sys].div = div << CLOCKS_CLK_SYS_DIV_INT_LSB;
+}
+
+uint32_t sys_divider() {
+    return clocks_hw->clk[clk_sys].div >> CLOCKS_CLK_SYS_DIV_INT_LSB;
+}
+
+void start_adc_clock() {
+    constexpr uint32_t f = kRoscNominalHz;
+    clock_configure(clk_adc, 0, CLOCKS_CLK_ADC_CTRL_AUXSRC_VALUE_ROSC_CLKSRC_PH, f, f);
+}
+
+void stop_adc_clock() {
+    clock_stop(clk_adc);
+}
+
+bool start_usb_clock() {
+    xosc_hw->startup = kXoscStartupDelay;
+    xosc_hw->ctrl = XOSC_CTRL_FREQ_RANGE_VALUE_1_15MHZ |
+                    (XOSC_CTRL_ENABLE_VALUE_ENABLE << XOSC_CTRL_ENABLE_LSB);
+    uint32_t polls = 0;
+    while (!(xosc_hw->status & XOSC_STATUS_STABLE_BITS)) {
+        if (++polls == kXoscStablePolls) {
+            xosc_disable();
+            return false;
+        }
+    }
+    // 12 MHz * 40 = 480 MHz VCO, / 5 / 2 = 48 MHz.
+    pll_init(pll_usb, 1, 40 * kXoscHz, 5, 2);
+    return clock_configure(clk_usb, 0, CLOCKS_CLK_USB_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, kUsbHz,
+                           kUsbHz);
+}
+
+void stop_usb_clock() {
+    clock_stop(clk_usb);
+    pll_deinit(pll_usb);
+    xosc_disable();
+}
+
+}  // namespace tilt::clock_tree
+
+extern "C" void runtime_init_clocks() {
+    tilt::clock_tree::init();
+}
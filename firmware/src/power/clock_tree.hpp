@@ -0,0 +1,39 @@
+// Crystal-less clock tree: everything runs from the ring oscillator.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt::clock_tree {
+
+/// Nominal ROSC frequency. The real value varies by several percent with
+/// process, voltage and temperature; timekeeping corrects for it.
+inline constexpr uint32_t kRoscNominalHz = 6'500'000;
+
+/// Routes clk_ref, clk_sys, clk_peri and clk_rtc to the ROSC and starts the
+/// 1 us timer tick. Rev 1.0 has no crystal on XIN/XOUT, so the SDK's default
+/// XOSC + PLL bring-up would hang; this replaces runtime_init_clocks().
+void init();
+
+/// Divides clk_sys by `div` (1 = full speed) without touching clk_peri or
+/// clk_ref, so I2C timing and the system timer are unaffected.
+void set_sys_divider(uint32_t div);
+
+uint32_t sys_divider();
+
+/// Feeds clk_adc from the ROSC for the length of a battery reading. The ADC
+/// is specified at 48 MHz but converts correctly (just slower, 96 cycles a
+/// sample) from the ROSC; it is stopped again between readings.
+void start_adc_clock();
+void stop_adc_clock();
+
+/// Starts the 12 MHz crystal and PLL_USB and feeds clk_usb at 48 MHz. USB
+/// full speed allows 0.25%, which the ROSC cannot hold, so this only works
+/// on service units with the crystal fitted. Returns false (and leaves the
+/// XOSC off) if the crystal does not stabilise, rather than hanging like
+/// the SDK's xosc_init(). clk_sys and clk_peri stay on the ROSC.
+[[nodiscard]] bool start_usb_clock();
+
+/// Stops clk_usb, PLL_USB and the XOSC again.
+void stop_usb_clock();
+
+}  // namespace tilt::clock_tree
@@ -0,0 +1,36 @@
+#include "power/power_governor.hpp"
+
+namespace tilt {
+
+PowerLevel PowerGovernor::target(uint16_t millivolts) const {
+    unsigned level = 0;
+    while (level < kPowerLevelCount - 1 && millivolts < thresholds_.below_mv[level]) {
+        ++level;
+    }
+    return static_cast<PowerLevel>(level);
+}
+
+bool PowerGovernor::update(uint16_t millivolts) {
+    if (millivolts == 0) {
+        return false;
+    }
+    const PowerLevel down = target(millivolts);
+    PowerLevel next = level_;
+    if (down > level_) {
+        next = down;
+    } else if (down < level_) {
+        // Climb only as far as the reading clears with margin to spare.
+        next = target(static_cast<uint16_t>(
+            millivolts > thresholds_.hysteresis_mv ? millivolts - thresholds_.hysteresis_mv : 0));
+        if (next > level_) {
+            next = level_;
+        }
+    }
+    if (next == level_) {
+        return false;
+    }
+    level_ = next;
+    return true;
+}
+
+}  // namespace tilt
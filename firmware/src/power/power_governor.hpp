@@ -0,0 +1,87 @@
+// Battery-driven performance levels: trade brightness and rate for runtime.
+#pragma once
+
+#include <cstdint>
+
+#include "drivers/lis3dh_regs.hpp"
+
+namespace tilt {
+
+enum class PowerLevel : uint8_t {
+    kFull,
+    kReduced,
+    kLow,
+    kCritical,
+};
+
+inline constexpr unsigned kPowerLevelCount = 4;
+
+/// What each subsystem runs at on a given level.
+struct PowerProfile {
+    /// OLED contrast is the theme value shifted right by this much.
+    uint8_t contrast_shift;
+    /// Countdown redraws only on multiples of this many seconds (every
+    /// second once the face's hurry threshold is reached).
+    uint8_t redraw_s;
+    /// LIS3DH run ODR; the classifier dwell is rebuilt for it.
+    lis3dh::Odr odr;
+    uint32_t odr_hz;
+    /// BZ1 pad drive step, see PioBuzzer::set_volume(). Full power keeps the
+    /// reset default.
+    uint8_t buzzer_volume;
+};
+
+inline constexpr PowerProfile kPowerProfiles[kPowerLevelCount] = {
+    {0, 1, lis3dh::Odr::k200Hz, 200, 1},
+    {1, 1, lis3dh::Odr::k100Hz, 100, 1},
+    {2, 5, lis3dh::Odr::k50Hz, 50, 0},
+    {3, 15, lis3dh::Odr::k25Hz, 25, 0},
+};
+
+constexpr const PowerProfile& power_profile(PowerLevel level) {
+    return kPowerProfiles[static_cast<unsigned>(level)];
+}
+
+/// Maps battery readings to a PowerLevel with hysteresis, so the sag and
+/// recovery that follow load changes do not make it oscillate.
+///
+/// Levels step down as soon as a reading is below a threshold but only
+/// step back up once it is hysteresis_mv above it (e.g. after a battery
+/// swap). Real thresholds must all stay above U3's dropout, where the ADC
+/// reference starts to sag with the battery.
+class PowerGovernor {
+public:
+    struct Thresholds {
+        /// A level applies below its threshold: kReduced below
+        /// below_mv[0], kLow below below_mv[1], kCritical below below_mv[2].
+        uint16_t below_mv[kPowerLevelCount - 1];
+        uint16_t hysteresis_mv;
+    };
+
+    /// No reading is below 0 mV, so this keeps the governor at kFull.
+    static constexpr Thresholds kDisabled{{0, 0, 0}, 0};
+
+    /// BT1 is not chosen yet, so there are no thresholds to step by: the
+    /// governor is disabled until its discharge curve gives real ones. A
+    /// level taken from guesses would throttle a healthy cell, or a board
+    /// whose divider is missing and whose ADC pin reads near 0 V.
+    static constexpr Thresholds kDefaultThresholds = kDisabled;
+
+    explicit PowerGovernor(const Thresholds& thresholds = kDefaultThresholds)
+        : thresholds_(thresholds) {}
+
+    /// Feeds one reading (0 = none, ignored). Returns true if the level
+    /// changed.
+    bool update(uint16_t millivolts);
+
+    PowerLevel level() const { return level_; }
+    const PowerProfile& profile() const { return power_profile(level_); }
+
+private:
+    PowerLevel target(uint16_t millivolts) const;
+
+    Thresholds thresholds_;
+    PowerLevel level_ = PowerLevel::kFull;
+};
+
+}  // namespace tilt
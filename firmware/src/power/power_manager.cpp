@@ -0,0 +1,108 @@
+#include "power/power_manager.hpp"
+
+#include "diag/trace.hpp"
+#include "hardware/gpio.h"
+#include "hardware/structs/rosc.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "power/clock_tree.hpp"
+
+namespace tilt {
+
+PowerManager::PowerManager(const CurrentModel& model) : model_(model) {}
+
+void PowerManager::init(const WakePin& wake_a, const WakePin& wake_b) {
+    wake_pins_[0] = wake_a;
+    wake_pins_[1] = wake_b;
+    last_us_ = time_us_64();
+}
+
+void PowerManager::idle(PowerState state, WorkPredicate has_work, void* ctx) {
+    const uint32_t irq = save_and_disable_interrupts();
+    if (has_work != nullptr && has_work(ctx)) {
+        restore_interrupts(irq);
+        return;
+    }
+
+    const uint64_t start = time_us_64();
+    account(PowerState::kRun, last_us_, start);
+    ++entries_[static_cast<unsigned>(state)];
+    trace::record(trace::Event::kSleepEnter, static_cast<uint16_t>(state));
+
+    switch (state) {
+        case PowerState::kRun:
+            __wfi();
+            break;
+        case PowerState::kSleep:
+            set_sys_divider(kSleepDivider);
+            __wfi();
+            set_sys_divider(1);
+            break;
+        case PowerState::kDormant:
+            enter_dormant();
+            break;
+    }
+
+    trace::record(trace::Event::kSleepExit, static_cast<uint16_t>(state));
+    const uint64_t end = time_us_64();
+    account(state, start, end);
+    last_us_ = end;
+    if (wake_hook_ != nullptr) {
+        wake_hook_(state, wake_ctx_);
+    }
+    restore_interrupts(irq);
+}
+
+bool PowerManager::add_clock_hook(ClockHook hook, void* ctx) {
+    const uint32_t irq = save_and_disable_interrupts();
+    const unsigned n = clock_hook_count_;
+    const bool ok = n < kMaxClockHooks;
+    if (ok) {
+        clock_hooks_[n] = ClockHookSlot{hook, ctx};
+        clock_hook_count_ = n + 1;
+    }
+    restore_interrupts(irq);
+    return ok;
+}
+
+void PowerManager::set_sys_divider(uint32_t div) {
+    // Listeners are a few register writes behind the switch, which is far
+    // below anything visible or audible.
+    clock_tree::set_sys_divider(div);
+    const unsigned n = clock_hook_count_;
+    for (unsigned i = 0; i < n; ++i) {
+        clock_hooks_[i].hook(div, clock_hooks_[i].ctx);
+    }
+}
+
+void PowerManager::enter_dormant() {
+    for (const WakePin& wake : wake_pins_) {
+        gpio_set_dormant_irq_enabled(wake.pin, wake.edges, true);
+    }
+    // Execution stops on this write and resumes once a wake edge restarts
+    // the oscillator; clk_sys and clk_ref both come straight from it.
+    rosc_hw->dormant = ROSC_DORMANT_VALUE_DORMANT;
+    while (!(rosc_hw->status & ROSC_STATUS_STABLE_BITS)) {
+    }
+    for (const WakePin& wake : wake_pins_) {
+        gpio_set_dormant_irq_enabled(wake.pin, wake.edges, false);
+        gpio_acknowledge_irq(wake.pin, wake.edges);
+    }
+}
+
+void PowerManager::account(PowerState state, uint64_t since_us, uint64_t now_us) {
+    residency_us_[static_cast<unsigned>(state)] += now_us - since_us;
+}
+
+PowerManager::Stats PowerManager::stats() const {
+    Stats s{};
+    for (unsigned i = 0; i < kPowerStateCount; ++i) {
+        s.residency_us[i] = residency_us_[i];
+        s.entries[i] = entries_[i];
+        // uA * us -> nAh: * 1000 / 3'600'000'000 us/h.
+        s.charge_nah[i] = residency_us_[i] * model_.microamps[i] / 3'600'000;
+    }
+    return s;
+}
+
+}  // namespace tilt
@@ -0,0 +1,100 @@
+// Run/sleep/dormant policy for U1 with per-state charge accounting.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace tilt {
+
+enum class PowerState : uint8_t {
+    kRun,      // WFI at full clk_sys; another core or DMA still needs it
+    kSleep,    // WFI with clk_sys divided; the system timer keeps running
+    kDormant,  // ROSC stopped; only a LIS3DH interrupt edge wakes the chip
+};
+
+inline constexpr unsigned kPowerStateCount = 3;
+
+/// Puts core 0 (and therefore the chip) into the requested low-power state
+/// whenever the main loop runs out of work, and keeps a coulomb estimate.
+///
+/// Currents come from a per-state model rather than measurement; they are
+/// board-level estimates to be replaced with values from a current probe.
+/// The system timer stops in dormant, so dormant residency cannot be timed
+/// on rev 1.0 (no 32 kHz reference); only entry counts are kept for it.
+/// Nothing timed can end dormant either: a timed wake is an EventLoop
+/// deadline, and the caller picks kSleep while one is armed.
+class PowerManager {
+public:
+    using WorkPredicate = bool (*)(void* ctx);
+    using WakeHook = void (*)(PowerState from, void* ctx);
+    /// Told the new clk_sys divider right after every change, with
+    /// interrupts masked, so clk_sys-paced peripherals can rescale.
+    using ClockHook = void (*)(uint32_t sys_divider, void* ctx);
+
+    static constexpr unsigned kMaxClockHooks = 4;
+
+    struct CurrentModel {
+        std::array<uint32_t, kPowerStateCount> microamps;
+    };
+
+    static constexpr CurrentModel kDefaultModel{{{4'500, 1'300, 250}}};
+
+    /// clk_sys divider used in kSleep.
+    static constexpr uint32_t kSleepDivider = 8;
+
+    struct Stats {
+        std::array<uint64_t, kPowerStateCount> residency_us;
+        std::array<uint32_t, kPowerStateCount> entries;
+        std::array<uint64_t, kPowerStateCount> charge_nah;  // nanoamp-hours
+    };
+
+    /// A GPIO that may end dormant, and the edges that do
+    /// (GPIO_IRQ_EDGE_RISE / GPIO_IRQ_EDGE_FALL).
+    struct WakePin {
+        unsigned pin;
+        uint32_t edges;
+    };
+
+    explicit PowerManager(const CurrentModel& model = kDefaultModel);
+
+    void init(const WakePin& wake_a, const WakePin& wake_b);
+
+    /// Called after every low-power exit, before interrupts are re-enabled.
+    void set_wake_hook(WakeHook hook, void* ctx) {
+        wake_hook_ = hook;
+        wake_ctx_ = ctx;
+    }
+
+    /// Registers a clock hook; safe to call from either core before the
+    /// main loop starts. Returns false when all slots are taken.
+    bool add_clock_hook(ClockHook hook, void* ctx);
+
+    /// Enters `state` unless `has_work` reports pending work once interrupts
+    /// are masked, which closes the race with ISRs that ran since the caller
+    /// last checked. Returns after the next wakeup.
+    void idle(PowerState state, WorkPredicate has_work, void* ctx);
+
+    Stats stats() const;
+
+private:
+    struct ClockHookSlot {
+        ClockHook hook;
+        void* ctx;
+    };
+
+    void set_sys_divider(uint32_t div);
+    void account(PowerState state, uint64_t since_us, uint64_t now_us);
+    void enter_dormant();
+
+    CurrentModel model_;
+    WakePin wake_pins_[2] = {};
+    std::array<uint64_t, kPowerStateCount> residency_us_{};
+    std::array<uint32_t, kPowerStateCount> entries_{};
+    uint64_t last_us_ = 0;
+    ClockHookSlot clock_hooks_[kMaxClockHooks] = {};
+    volatile unsigned clock_hook_count_ = 0;
+    WakeHook wake_hook_ = nullptr;
+    void* wake_ctx_ = nullptr;
+};
+
+}  // namespace tilt
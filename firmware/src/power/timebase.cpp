@@ -0,0 +1,39 @@
+#include "power/timebase.hpp"
+
+namespace tilt::timebase {
+
+namespace {
+
+// Written only with no countdown armed, so the alarm IRQ never sees a
+// half-updated pair.
+int32_t current_ppb = kNominalErrorPpb;
+int32_t forward = forward_q30(kNominalErrorPpb);
+int32_t inverse = inverse_q30(kNominalErrorPpb);
+Source current_source = Source::kNominal;
+
+}  // namespace
+
+void set_error(int32_t ppb, Source source) {
+    current_ppb = ppb;
+    forward = forward_q30(ppb);
+    inverse = inverse_q30(ppb);
+    current_source = source;
+}
+
+int32_t error_ppb() {
+    return current_ppb;
+}
+
+Source source() {
+    return current_source;
+}
+
+uint64_t ticks_from_us(uint64_t us) {
+    return static_cast<uint64_t>(apply_q30(us, forward));
+}
+
+uint64_t us_from_ticks(uint64_t ticks) {
+    return static_cast<uint64_t>(apply_q30(ticks, inverse));
+}
+
+}  // namespace tilt::timebase
@@ -0,0 +1,70 @@
+// Corrects system timer ticks to real time for a ROSC-clocked board.
+#pragma once
+
+#include <cstdint>
+
+#include "features.hpp"
+#include "power/clock_tree.hpp"
+
+namespace tilt::timebase {
+
+/// Where the current rate error came from.
+enum class Source : uint8_t {
+    kNominal = 0,  // no measurement: only the known tick divider error
+    kFactory = 1,  // stored in the config blob
+    kUsbSof = 2,   // measured against a USB host's 1 kHz start of frame
+};
+
+/// The watchdog tick divides clk_ref by a whole number, so from a 6.5 MHz
+/// ROSC the timer ticks at 6.5 MHz / 6 even before the ROSC itself is off.
+/// In parts per billion of 1 MHz; 0 on the host, whose clock is exact.
+#if TILT_HOST
+inline constexpr int32_t kNominalErrorPpb = 0;
+#else
+inline constexpr int32_t kNominalErrorPpb = static_cast<int32_t>(
+    (uint64_t{clock_tree::kRoscNominalHz} * 1000 / (clock_tree::kRoscNominalHz / 1'000'000)) -
+    1'000'000'000);
+static_assert(kNominalErrorPpb == 83'333'333);
+#endif
+
+/// A rate as a signed Q2.30 fraction: `r` means ticks = us * (1 + r / 2^30).
+/// Q30 resolves about 1 ppb, and splitting the multiply at bit 20 keeps
+/// every product within 64 bits for spans up to 2^40 us (12 days), so the
+/// conversions need no 64-bit division at run time.
+constexpr int64_t apply_q30(uint64_t value, int32_t rate_q30) {
+    const int64_t hi = static_cast<int64_t>(value >> 20) * rate_q30;
+    const int64_t lo = static_cast<int64_t>(value & 0xF'FFFF) * rate_q30;
+    return static_cast<int64_t>(value) + (hi >> 10) + (lo >> 30);
+}
+
+constexpr int32_t div_round(int64_t num, int64_t den) {
+    return static_cast<int32_t>((num + (num < 0 ? -den / 2 : den / 2)) / den);
+}
+/// Q30 forward and inverse rates for an error of `ppb` (timer fast when
+/// positive). Needs |ppb| well below 10^9.
+constexpr int32_t forward_q30(int32_t ppb) {
+    return div_round(int64_t{ppb} << 30, 1'000'000'000);
+}
+constexpr int32_t inverse_q30(int32_t ppb) {
+    return div_round(-(int64_t{ppb} << 30), 1'000'000'000 + int64_t{ppb});
+}
+
+// An hour of the nominal error each way, to the millisecond.
+static_assert(apply_q30(1'000'000, forward_q30(1'000)) == 1'000'001);
+static_assert((apply_q30(3'600'000'000, forward_q30(83'333'333)) + 500) / 1000 == 3'900'000);
+static_assert((apply_q30(3'900'000'000, inverse_q30(83'333'333)) + 500) / 1000 == 3'600'000);
+
+/// Installs a rate error. Core 0 only; call with no countdown running or
+/// restart it, since armed alarms keep the old scale.
+void set_error(int32_t ppb, Source source);
+
+int32_t error_ppb();
+Source source();
+
+/// Timer ticks that span `us` of real time.
+uint64_t ticks_from_us(uint64_t us);
+
+/// Real microseconds spanned by `ticks` timer ticks.
+uint64_t us_from_ticks(uint64_t ticks);
+
+}  // namespace tilt::timebase
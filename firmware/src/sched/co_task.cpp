@@ -0,0 +1,112 @@
+#include "sched/co_task.hpp"
+
+#include "hardware/sync.h"
+
+namespace tilt {
+
+namespace frame_pool {
+
+namespace {
+
+// Hardware spin lock reserved by the SDK for OS use; it needs no init, so
+// allocation works before any constructor runs.
+constexpr unsigned kSpinLock = PICO_SPINLOCK_ID_OS1;
+
+alignas(8) uint8_t blocks[kBlocks][kBlockBytes];
+uint32_t used = 0;
+unsigned peak = 0;
+
+static_assert(kBlocks <= 32, "one bit per block");
+
+unsigned popcount(uint32_t v) {
+    unsigned n = 0;
+    for (; v != 0; v &= v - 1) {
+        ++n;
+    }
+    return n;
+}
+
+}  // namespace
+
+void* allocate(size_t size) {
+    if (size > kBlockBytes) {
+        return nullptr;
+    }
+    spin_lock_t* lock = spin_lock_instance(kSpinLock);
+    const uint32_t irq = spin_lock_blocking(lock);
+    void* frame = nullptr;
+    for (unsigned i = 0; i < kBlocks; ++i) {
+        if (!(used & (1u << i))) {
+            used |= 1u << i;
+            frame = blocks[i];
+            break;
+        }
+    }
+    const unsigned n = popcount(used);
+    if (n > peak) {
+        peak = n;
+    }
+    spin_unlock(lock, irq);
+    return frame;
+}
+
+void release(void* frame) {
+    const auto offset = static_cast<uint8_t*>(frame) - blocks[0];
+    const auto index = static_cast<unsigned>(offset / kBlockBytes);
+    spin_lock_t* lock = spin_lock_instance(kSpinLock);
+    const uint32_t irq = spin_lock_blocking(lock);
+    used &= ~(1u << index);
+    spin_unlock(lock, irq);
+}
+
+unsigned in_use() {
+    return popcount(used);
+}
+
+unsigned high_water() {
+    return peak;
+}
+
+}  // namespace frame_pool
+
+void spawn(CoTask task, CoTask::DoneFn done, void* ctx) {
+    if (!task.valid()) {
+        if (done != nullptr) {
+            done(false, ctx);
+        }
+        return;
+    }
+    CoTask::Handle h = task.handle_;
+    task.handle_ = nullptr;
+    h.promise().done = done;
+    h.promise().done_ctx = ctx;
+    h.resume();
+}
+
+namespace {
+
+struct SyncWait {
+    volatile bool done = false;
+    volatile bool ok = false;
+};
+
+void on_sync_done(bool ok, void* ctx) {
+    auto* wait = static_cast<SyncWait*>(ctx);
+    wait->ok = ok;
+    wait->done = true;
+    // May complete on the other core's IRQ.
+    __sev();
+}
+
+}  // namespace
+
+bool sync_wait(CoTask task) {
+    SyncWait wait;
+    spawn(static_cast<CoTask&&>(task), &on_sync_done, &wait);
+    while (!wait.done) {
+        __wfe();
+    }
+    return wait.ok;
+}
+
+}  // namespace tilt
@@ -0,0 +1,124 @@
+// Coroutine task type whose frames come from a fixed pool, never the heap.
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+namespace tilt {
+
+/// Fixed pool of coroutine frames, shared by both cores and IRQ handlers
+/// (driver coroutines resume from the bus completion interrupt).
+namespace frame_pool {
+
+inline constexpr size_t kBlockBytes = 256;
+inline constexpr unsigned kBlocks = 8;
+
+/// nullptr if `size` is too big or every block is taken. The promise
+/// turns that into a task that completes immediately with false.
+void* allocate(size_t size);
+void release(void* frame);
+
+/// Blocks in use now and at most since boot, for sizing kBlocks.
+unsigned in_use();
+unsigned high_water();
+
+}  // namespace frame_pool
+
+/// A lazily started coroutine that finishes with a success flag.
+///
+/// Awaiting a CoTask starts it and resumes the awaiter when it ends (by
+/// symmetric transfer, so chains do not grow the stack). A top-level task
+/// is started with spawn(), or with sync_wait() from thread context.
+/// Driver coroutines are resumed from whatever context completes their
+/// awaitables, typically the I2C completion IRQ on core 0, so they must be
+/// short between suspension points.
+class [[nodiscard]] CoTask {
+public:
+    using DoneFn = void (*)(bool ok, void* ctx);
+
+    struct promise_type {
+        bool ok = false;
+        std::coroutine_handle<> continuation;
+        DoneFn done = nullptr;
+        void* done_ctx = nullptr;
+
+        static void* operator new(size_t size) noexcept { return frame_pool::allocate(size); }
+        static void operator delete(void* frame) noexcept { frame_pool::release(frame); }
+        static CoTask get_return_object_on_allocation_failure() { return CoTask{}; }
+
+        CoTask get_return_object() {
+            return CoTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                promise_type& p = h.promise();
+                if (p.continuation) {
+                    return p.continuation;
+                }
+                // Detached: nobody owns the frame, so free it before
+                // reporting, which lets the callback spawn a successor.
+                const DoneFn done = p.done;
+                void* const ctx = p.done_ctx;
+                const bool ok = p.ok;
+                h.destroy();
+                if (done != nullptr) {
+                    done(ok, ctx);
+                }
+                return std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_value(bool value) { ok = value; }
+        void unhandled_exception() { __builtin_trap(); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    CoTask() = default;
+    CoTask(CoTask&& other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+    CoTask(const CoTask&) = delete;
+    CoTask& operator=(const CoTask&) = delete;
+    ~CoTask() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /// False if the frame could not be allocated.
+    bool valid() const { return static_cast<bool>(handle_); }
+
+    struct Awaiter {
+        Handle handle;
+        bool await_ready() const noexcept { return !handle; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            handle.promise().continuation = caller;
+            return handle;
+        }
+        bool await_resume() const noexcept { return handle && handle.promise().ok; }
+    };
+    Awaiter operator co_await() const& noexcept { return Awaiter{handle_}; }
+
+    /// Starts `task` detached; `done` runs when it finishes, in whatever
+    /// context resumed it last. A task whose frame failed to allocate
+    /// reports false straight away.
+    friend void spawn(CoTask task, DoneFn done, void* ctx);
+
+private:
+    explicit CoTask(Handle handle) : handle_(handle) {}
+
+    Handle handle_;
+};
+
+void spawn(CoTask task, CoTask::DoneFn done, void* ctx);
+
+/// Runs `task` to completion, sleeping in WFE. Thread context only, and
+/// never on core 0 with the bus IRQ masked.
+bool sync_wait(CoTask task);
+
+}  // namespace tilt
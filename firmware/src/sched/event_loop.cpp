@@ -0,0 +1,268 @@
+#include "sched/event_loop.hpp"
+
+#include <cstdio>
+
+#include "diag/trace.hpp"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+namespace tilt {
+
+namespace {
+
+uint32_t now_ms() {
+    return static_cast<uint32_t>(time_us_64() / 1000);
+}
+
+// Signed distance on the wrapping millisecond counter.
+int32_t ms_until(uint32_t when, uint32_t now) {
+    return static_cast<int32_t>(when - now);
+}
+
+}  // namespace
+
+EventLoop* EventLoop::instance_ = nullptr;
+
+bool EventLoop::init() {
+    alarm_ = hardware_alarm_claim_unused(false);
+    if (alarm_ < 0) {
+        return false;
+    }
+    instance_ = this;
+    wheel_ms_ = now_ms();
+    hardware_alarm_set_callback(static_cast<unsigned>(alarm_), &EventLoop::alarm_irq);
+    return true;
+}
+
+TaskId EventLoop::add_task(const char* name, TaskFn fn, void* ctx) {
+    if (task_count_ == kMaxTasks) {
+        return kNoTask;
+    }
+    const auto id = static_cast<TaskId>(task_count_++);
+    tasks_[id] = Task{fn, ctx, TaskStats{name, 0, 0, 0}};
+    return id;
+}
+
+void EventLoop::post(TaskId task) {
+    post_at(task, time_us_32());
+}
+
+void EventLoop::post_at(TaskId task, uint32_t origin_us) {
+    if (task >= task_count_) {
+        return;
+    }
+    const uint32_t bit = 1u << task;
+    const uint32_t irq = save_and_disable_interrupts();
+    // Only the first post since the last run sets the latency origin.
+    if (!(pending_ & bit)) {
+        posted_us_[task] = origin_us;
+        pending_ = pending_ | bit;
+    }
+    restore_interrupts(irq);
+}
+
+void EventLoop::arm(Deadline& deadline, TaskId task, uint32_t delay_ms) {
+    cancel(deadline);
+    deadline.task = task;
+    deadline.expires_ms = now_ms() + delay_ms;
+    insert(deadline);
+    program_alarm();
+}
+
+void EventLoop::rearm(Deadline& deadline, uint32_t period_ms) {
+    cancel(deadline);
+    deadline.expires_ms += period_ms;
+    insert(deadline);
+    program_alarm();
+}
+
+void EventLoop::cancel(Deadline& deadline) {
+    if (deadline.armed) {
+        unlink(deadline);
+    }
+}
+
+void EventLoop::insert(Deadline& deadline) {
+    // wheel_ms_ only moves in expire_due(). With nothing armed for 2^31 ms
+    // (24.8 days) a new deadline would look overdue and fire at once; an
+    // empty wheel can start again from now.
+    if (armed_count_ == 0) {
+        wheel_ms_ = now_ms();
+    }
+    // Slots before wheel_ms_ are never walked again; a deadline that is
+    // already due fires straight away instead.
+    if (ms_until(deadline.expires_ms, wheel_ms_) < 0) {
+        post_at(deadline.task, deadline.expires_ms * 1000);
+        return;
+    }
+    Deadline*& head = wheel_[deadline.expires_ms % kWheelSlots];
+    deadline.next = head;
+    head = &deadline;
+    deadline.armed = true;
+    ++armed_count_;
+}
+
+void EventLoop::unlink(Deadline& deadline) {
+    for (Deadline** link = &wheel_[deadline.expires_ms % kWheelSlots]; *link != nullptr;
+         link = &(*link)->next) {
+        if (*link == &deadline) {
+            *link = deadline.next;
+            break;
+        }
+    }
+    deadline.next = nullptr;
+    deadline.armed = false;
+    --armed_count_;
+}
+
+void EventLoop::expire_due() {
+    const uint32_t now = now_ms();
+    const int32_t behind = ms_until(now, wheel_ms_);
+    if (behind < 0) {
+        return;
+    }
+    // A gap of a full revolution or more means every slot needs a look.
+    const uint32_t slots = behind >= static_cast<int32_t>(kWheelSlots)
+                               ? kWheelSlots
+                               : static_cast<uint32_t>(behind) + 1;
+    for (uint32_t i = 0; i < slots; ++i) {
+        Deadline** link = &wheel_[(wheel_ms_ + i) % kWheelSlots];
+        while (*link != nullptr) {
+            Deadline* d = *link;
+            if (ms_until(d->expires_ms, now) > 0) {
+                link = &d->next;
+                continue;
+            }
+            *link = d->next;
+            d->next = nullptr;
+            d->armed = false;
+            --armed_count_;
+            // us origin from the ms expiry: equal modulo 2^32 because
+            // 1000 * 2^32 vanishes.
+            post_at(d->task, d->expires_ms * 1000);
+        }
+    }
+    wheel_ms_ = now + 1;
+}
+
+void EventLoop::program_alarm() {
+    if (alarm_ < 0) {
+        return;
+    }
+    if (armed_count_ == 0) {
+        hardware_alarm_cancel(static_cast<unsigned>(alarm_));
+        return;
+    }
+    // Within one revolution the first occupied slot holding a deadline for
+    // this revolution is the earliest; past that, take the minimum.
+    bool found = false;
+    uint32_t earliest = 0;
+    for (uint32_t i = 0; i < kWheelSlots; ++i) {
+        const uint32_t t = wheel_ms_ + i;
+        for (const Deadline* d = wheel_[t % kWheelSlots]; d != nullptr; d = d->next) {
+            if (!found || ms_until(d->expires_ms, earliest) < 0) {
+                earliest = d->expires_ms;
+                found = true;
+            }
+        }
+        if (found && ms_until(earliest, t) <= 0) {
+            break;
+        }
+    }
+    const uint64_t now_us = time_us_64();
+    const uint32_t now = static_cast<uint32_t>(now_us / 1000);
+    const int32_t ahead = ms_until(earliest, now);
+    const uint64_t target_ms = now_us / 1000 + (ahead > 0 ? ahead : 0);
+    if (hardware_alarm_set_target(static_cast<unsigned>(alarm_),
+                                  from_us_since_boot(target_ms * 1000))) {
+        // Already in the past.
+        alarm_fired_ = true;
+    }
+}
+
+void EventLoop::alarm_irq(unsigned) {
+    trace::record(trace::Event::kIsrAlarm);
+    instance_->alarm_fired_ = true;
+}
+
+bool EventLoop::run_once() {
+    bool did = false;
+    if (alarm_fired_) {
+        alarm_fired_ = false;
+        expire_due();
+        program_alarm();
+        did = true;
+    }
+
+    uint32_t origin[kMaxTasks];
+    const uint32_t irq = save_and_disable_interrupts();
+    const uint32_t pending = pending_;
+    pending_ = 0;
+    for (unsigned i = 0; i < task_count_; ++i) {
+        origin[i] = posted_us_[i];
+    }
+    restore_interrupts(irq);
+
+    for (unsigned i = 0; i < task_count_; ++i) {
+        if (!(pending & (1u << i))) {
+            continue;
+        }
+        Task& task = tasks_[i];
+        const uint32_t start = time_us_32();
+        trace::record(trace::Event::kTaskStart, static_cast<uint16_t>(i));
+        task.fn(task.ctx);
+        trace::record(trace::Event::kTaskEnd, static_cast<uint16_t>(i));
+        const uint32_t end = time_us_32();
+        TaskStats& s = task.stats;
+        ++s.runs;
+        const uint32_t latency = start - origin[i];
+        // A deadline origin rounds down to its millisecond and may sit
+        // fractionally in the future relative to a post; clamp.
+        if (static_cast<int32_t>(latency) > 0 && latency > s.worst_latency_us) {
+            s.worst_latency_us = latency;
+        }
+        if (end - start > s.worst_run_us) {
+            s.worst_run_us = end - start;
+        }
+    }
+    return did || pending != 0;
+}
+
+void EventLoop::run() {
+    while (true) {
+        if (run_once()) {
+            continue;
+        }
+        if (idle_fn_ != nullptr) {
+            idle_fn_(*this, idle_ctx_);
+            continue;
+        }
+        // WFI with PRIMASK set still wakes on a pending IRQ, so a post that
+        // lands between the check and the sleep is never missed.
+        const uint32_t irq = save_and_disable_interrupts();
+        if (!has_work()) {
+            __wfi();
+        }
+        restore_interrupts(irq);
+    }
+}
+
+void EventLoop::reset_stats() {
+    for (unsigned i = 0; i < task_count_; ++i) {
+        TaskStats& s = tasks_[i].stats;
+        s.runs = 0;
+        s.worst_latency_us = 0;
+        s.worst_run_us = 0;
+    }
+}
+
+void EventLoop::print_report() const {
+    for (unsigned i = 0; i < task_count_; ++i) {
+        const TaskStats& s = tasks_[i].stats;
+        printf("task=%s runs=%lu worst_latency_us=%lu worst_run_us=%lu\n", s.name,
+               static_cast<unsigned long>(s.runs), static_cast<unsigned long>(s.worst_latency_us),
+               static_cast<unsigned long>(s.worst_run_us));
+    }
+}
+
+}  // namespace tilt
@@ -0,0 +1,136 @@
+// Cooperative event loop: ISR-posted tasks, timer-wheel deadlines, idle hook.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt {
+
+class EventLoop;
+
+using TaskId = uint8_t;
+inline constexpr TaskId kNoTask = 0xFF;
+
+/// One-shot deadline, owned by the caller and linked into the wheel while
+/// armed. When it expires its task is posted, with the expiry time as the
+/// latency origin.
+struct Deadline {
+    TaskId task = kNoTask;
+    uint32_t expires_ms = 0;
+    Deadline* next = nullptr;
+    bool armed = false;
+};
+
+/// Per-task counters. Latency is from the first post (or deadline expiry)
+/// to the start of the run that serviced it; several posts before a run
+/// collapse into one.
+struct TaskStats {
+    const char* name;
+    uint32_t runs;
+    uint32_t worst_latency_us;
+    uint32_t worst_run_us;
+};
+
+/// Core 0's main loop.
+///
+/// Tasks are run-to-completion functions identified by a small id; a lower
+/// id runs first when several are pending. post() is the only entry point
+/// from interrupt context: it sets a bit with interrupts masked (the M0+
+/// has no atomic RMW), so ISRs never touch driver state beyond their own
+/// flags. Deadlines hash into a 64-slot wheel by expiry millisecond; one
+/// hardware alarm is kept on the earliest one, so the core only wakes when
+/// something is actually due, and expiry processing only walks the slots
+/// that elapsed.
+///
+/// With nothing pending the idle hook runs with the loop's has_work() as
+/// its predicate; PowerManager::idle() fits it directly.
+class EventLoop {
+public:
+    using TaskFn = void (*)(void* ctx);
+    using IdleFn = void (*)(EventLoop& loop, void* ctx);
+
+    static constexpr unsigned kMaxTasks = 16;
+    static constexpr unsigned kWheelSlots = 64;
+
+    /// Claims a hardware alarm and hooks its IRQ on the calling core.
+    [[nodiscard]] bool init();
+
+    /// Registers a task. Returns kNoTask when the table is full.
+    TaskId add_task(const char* name, TaskFn fn, void* ctx);
+
+    /// Marks `task` runnable. Safe from any interrupt on core 0.
+    void post(TaskId task);
+
+    /// Adapts post() to the `void (*)(void*)` notify hooks drivers expose;
+    /// `ctx` is a PostTarget.
+    struct PostTarget {
+        EventLoop* loop;
+        TaskId task;
+    };
+    static void post_target(void* ctx) {
+        auto* t = static_cast<PostTarget*>(ctx);
+        t->loop->post(t->task);
+    }
+
+    /// (Re)arms `deadline` to post `task` after `delay_ms`. Thread context.
+    void arm(Deadline& deadline, TaskId task, uint32_t delay_ms);
+    /// Re-arms relative to the previous expiry, for drift-free periods.
+    void rearm(Deadline& deadline, uint32_t period_ms);
+    void cancel(Deadline& deadline);
+
+    void set_idle(IdleFn fn, void* ctx) {
+        idle_fn_ = fn;
+        idle_ctx_ = ctx;
+    }
+
+    /// True if a task is runnable or a deadline has fired. Safe with IRQs
+    /// masked; this is the idle predicate.
+    bool has_work() const { return pending_ != 0 || alarm_fired_; }
+    static bool has_work_thunk(void* ctx) { return static_cast<EventLoop*>(ctx)->has_work(); }
+
+    /// True while any deadline is armed; the system timer must keep running.
+    bool timers_armed() const { return armed_count_ != 0; }
+
+    /// Dispatches forever.
+    [[noreturn]] void run();
+
+    /// Runs everything currently pending (and due deadlines) once. Returns
+    /// false if there was nothing to do.
+    bool run_once();
+
+    unsigned task_count() const { return task_count_; }
+    const TaskStats& stats(TaskId task) const { return tasks_[task].stats; }
+    void reset_stats();
+
+    /// Prints one line per task on stdio.
+    void print_report() const;
+
+private:
+    struct Task {
+        TaskFn fn;
+        void* ctx;
+        TaskStats stats;
+    };
+
+    static void alarm_irq(unsigned alarm);
+    void post_at(TaskId task, uint32_t origin_us);
+    void insert(Deadline& deadline);
+    void unlink(Deadline& deadline);
+    void expire_due();
+    void program_alarm();
+
+    Task tasks_[kMaxTasks] = {};
+    uint32_t posted_us_[kMaxTasks] = {};
+    unsigned task_count_ = 0;
+    volatile uint32_t pending_ = 0;
+    volatile bool alarm_fired_ = false;
+    int alarm_ = -1;
+    Deadline* wheel_[kWheelSlots] = {};
+    uint32_t wheel_ms_ = 0;  // every slot before this has been processed
+    unsigned armed_count_ = 0;
+    IdleFn idle_fn_ = nullptr;
+    void* idle_ctx_ = nullptr;
+
+    static EventLoop* instance_;
+};
+
+}  // namespace tilt
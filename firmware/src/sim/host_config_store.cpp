@@ -0,0 +1,20 @@
+// ConfigStore for the host build: there is no flash, so always the defaults.
+
+#include "storage/config_store.hpp"
+
+namespace tilt {
+
+const ConfigBlob* ConfigStore::flash_blob() {
+    return nullptr;
+}
+
+bool ConfigStore::init() {
+    active_ = &kDefaultConfig;
+    return false;
+}
+
+bool ConfigStore::program(const ConfigBlob&) {
+    return false;
+}
+
+}  // namespace tilt
@@ -0,0 +1,17 @@
+// UiLink for the host build: one thread, so there is no doorbell to ring.
+
+#include "app/ui_link.hpp"
+
+namespace tilt {
+
+bool UiLink::post(const UiEvent& event) {
+    if (!ring_.push(event)) {
+        ++dropped_;
+        return false;
+    }
+    return true;
+}
+
+void UiLink::wait() {}
+
+}  // namespace tilt
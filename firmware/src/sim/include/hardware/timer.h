@@ -0,0 +1,14 @@
+// Host stand-in for hardware/timer.h; the simulated timer is sim/sim_clock.hpp.
+#pragma once
+
+#include <cstdint>
+
+#include "pico/time.h"
+
+inline uint64_t time_us_64() {
+    return to_us_since_boot(get_absolute_time());
+}
+
+inline uint32_t time_us_32() {
+    return static_cast<uint32_t>(time_us_64());
+}
@@ -0,0 +1,8 @@
+// Host stand-in for pico/critical_section.h. The sim is single-threaded
+// and builds none of the drivers that take the lock; only the type is
+// needed, for the members of headers it includes.
+#pragma once
+
+typedef struct {
+    int unused;
+} critical_section_t;
@@ -0,0 +1,56 @@
+// Host stand-in for the pico-sdk time API, backed by sim/sim_clock.hpp.
+#pragma once
+
+#include <cstdint>
+
+/// Microseconds since simulated boot. The SDK's type is opaque in debug
+/// builds; code here only goes through the functions below, so a plain
+/// integer is equivalent.
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void* user_data);
+
+absolute_time_t get_absolute_time();
+
+inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return static_cast<uint32_t>(t / 1000);
+}
+
+inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) {
+    return t + us;
+}
+
+inline absolute_time_t make_timeout_time_us(uint64_t us) {
+    return get_absolute_time() + us;
+}
+
+inline absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return get_absolute_time() + uint64_t{ms} * 1000;
+}
+
+inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return static_cast<int64_t>(to - from);
+}
+
+/// Same contract as the SDK's default alarm pool: a positive return
+/// reschedules that many us after the previous target, a negative one that
+/// many us after now, zero ends the alarm. Callbacks run from
+/// tilt::sim::clock::advance_to(), never asynchronously.
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void* user_data,
+                        bool fire_if_past);
+
+inline alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void* user_data,
+                                  bool fire_if_past) {
+    return add_alarm_at(get_absolute_time() + us, callback, user_data, fire_if_past);
+}
+
+inline alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void* user_data,
+                                  bool fire_if_past) {
+    return add_alarm_in_us(uint64_t{ms} * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id);
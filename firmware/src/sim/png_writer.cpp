@@ -0,0 +1,99 @@
+#include "sim/png_writer.hpp"
+
+#include <cstdio>
+#include <vector>
+
+#include "display/framebuffer.hpp"
+#include "sim/sim_devices.hpp"
+#include "util/crc32.hpp"
+
+namespace tilt::sim {
+
+namespace {
+
+constexpr size_t kMaxStoredBlock = 65535;
+
+void put_u32be(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void put_chunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& body) {
+    put_u32be(out, static_cast<uint32_t>(body.size()));
+    Crc32 crc;
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(type[i]));
+        crc.add_u8(static_cast<uint8_t>(type[i]));
+    }
+    out.insert(out.end(), body.begin(), body.end());
+    crc.add(body.data(), body.size());
+    put_u32be(out, crc.value());
+}
+
+// zlib stream of stored blocks; no compression, valid for any decoder.
+std::vector<uint8_t> zlib_stored(const std::vector<uint8_t>& raw) {
+    std::vector<uint8_t> z = {0x78, 0x01};
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (uint8_t v : raw) {
+        a = (a + v) % 65521;
+        b = (b + a) % 65521;
+    }
+    size_t pos = 0;
+    do {
+        const size_t len = raw.size() - pos < kMaxStoredBlock ? raw.size() - pos : kMaxStoredBlock;
+        const bool last = pos + len == raw.size();
+        z.push_back(last ? 1 : 0);
+        z.push_back(static_cast<uint8_t>(len));
+        z.push_back(static_cast<uint8_t>(len >> 8));
+        z.push_back(static_cast<uint8_t>(~len));
+        z.push_back(static_cast<uint8_t>(~len >> 8));
+        z.insert(z.end(), raw.begin() + static_cast<std::ptrdiff_t>(pos),
+                 raw.begin() + static_cast<std::ptrdiff_t>(pos + len));
+        pos += len;
+    } while (pos < raw.size());
+    put_u32be(z, (b << 16) | a);
+    return z;
+}
+
+}  // namespace
+
+bool write_png(const char* path, const Display& display, unsigned scale) {
+    const unsigned width = Framebuffer::kWidth * scale;
+    const unsigned height = Framebuffer::kHeight * scale;
+    // The panel's contrast acts on segment current; map it onto the upper
+    // part of the grey range so a dim theme stays readable.
+    const auto lit = static_cast<uint8_t>(64 + display.contrast() * 191 / 255);
+
+    std::vector<uint8_t> raw;
+    raw.reserve(size_t{height} * (width + 1));
+    for (unsigned y = 0; y < height; ++y) {
+        raw.push_back(0);  // filter: none
+        for (unsigned x = 0; x < width; ++x) {
+            const bool on = display.on() &&
+                            (display.pixel(x / scale, y / scale) != display.inverted());
+            raw.push_back(on ? lit : 0);
+        }
+    }
+
+    std::vector<uint8_t> ihdr;
+    put_u32be(ihdr, width);
+    put_u32be(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 0, 0, 0, 0});  // 8-bit greyscale, no interlace
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    put_chunk(png, "IHDR", ihdr);
+    put_chunk(png, "IDAT", zlib_stored(raw));
+    put_chunk(png, "IEND", {});
+
+    FILE* f = std::fopen(path, "wb");
+    if (f == nullptr) {
+        return false;
+    }
+    const bool ok = std::fwrite(png.data(), 1, png.size(), f) == png.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+}  // namespace tilt::sim
@@ -0,0 +1,18 @@
+// Minimal 8-bit greyscale PNG encoder for DS1 snapshots.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt::sim {
+
+class Display;
+
+/// Writes what `display` shows to `path`, each panel pixel as a
+/// `scale` x `scale` block. Lit pixels are drawn at a grey matching the
+/// contrast setting, so dimmed themes are visibly dimmer; an inverted or
+/// switched-off panel is drawn as such. Stored (uncompressed) deflate
+/// blocks keep the encoder to a few lines; a 4x frame is about 130 KiB.
+/// Returns false if the file cannot be written.
+bool write_png(const char* path, const Display& display, unsigned scale);
+
+}  // namespace tilt::sim
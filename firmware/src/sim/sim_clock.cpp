@@ -0,0 +1,108 @@
+#include "sim/sim_clock.hpp"
+
+#include "pico/time.h"
+
+namespace tilt::sim::clock {
+
+namespace {
+
+struct Alarm {
+    alarm_id_t id;  // 0 = free slot
+    uint64_t target_us;
+    alarm_callback_t callback;
+    void* ctx;
+};
+
+uint64_t g_now_us = 0;
+alarm_id_t g_next_id = 1;
+Alarm g_alarms[kMaxAlarms] = {};
+
+Alarm* earliest() {
+    Alarm* best = nullptr;
+    for (Alarm& a : g_alarms) {
+        if (a.id != 0 && (best == nullptr || a.target_us < best->target_us)) {
+            best = &a;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+uint64_t now_us() {
+    return g_now_us;
+}
+
+uint64_t next_alarm_us() {
+    const Alarm* a = earliest();
+    return a != nullptr ? a->target_us : UINT64_MAX;
+}
+
+void advance_to(uint64_t us) {
+    for (Alarm* a = earliest(); a != nullptr && a->target_us <= us; a = earliest()) {
+        if (a->target_us > g_now_us) {
+            g_now_us = a->target_us;
+        }
+        // The slot stays claimed while the callback runs so that a
+        // cancel_alarm() on its own id from inside it is harmless.
+        const alarm_id_t id = a->id;
+        const int64_t again = a->callback(id, a->ctx);
+        if (a->id != id) {
+            continue;
+        }
+        if (again > 0) {
+            a->target_us += static_cast<uint64_t>(again);
+        } else if (again < 0) {
+            a->target_us = g_now_us + static_cast<uint64_t>(-again);
+        } else {
+            a->id = 0;
+        }
+    }
+    if (us > g_now_us) {
+        g_now_us = us;
+    }
+}
+
+void reset() {
+    g_now_us = 0;
+    g_next_id = 1;
+    for (Alarm& a : g_alarms) {
+        a = Alarm{};
+    }
+}
+
+}  // namespace tilt::sim::clock
+
+absolute_time_t get_absolute_time() {
+    return tilt::sim::clock::now_us();
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void* user_data,
+                        bool fire_if_past) {
+    using namespace tilt::sim::clock;
+    if (time < g_now_us) {
+        if (!fire_if_past) {
+            return 0;
+        }
+        time = g_now_us;
+    }
+    for (Alarm& a : g_alarms) {
+        if (a.id == 0) {
+            a = Alarm{g_next_id, time, callback, user_data};
+            g_next_id = g_next_id == INT32_MAX ? 1 : g_next_id + 1;
+            return a.id;
+        }
+    }
+    return -1;
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    using namespace tilt::sim::clock;
+    for (Alarm& a : g_alarms) {
+        if (id > 0 && a.id == id) {
+            a.id = 0;
+            return true;
+        }
+    }
+    return false;
+}
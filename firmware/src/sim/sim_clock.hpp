@@ -0,0 +1,28 @@
+// Simulated microsecond timer behind the host pico/time.h.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt::sim::clock {
+
+/// Simulated time only moves when the harness says so, which is what lets
+/// a trace replay run as fast as the host allows. Alarms added through the
+/// pico/time.h stand-in fire, in target order, from inside advance_to().
+///
+/// Up to kMaxAlarms alarms may be pending; add_alarm_at() returns -1 past
+/// that, like an exhausted SDK pool.
+inline constexpr unsigned kMaxAlarms = 16;
+
+uint64_t now_us();
+
+/// Moves time forward to `us` (never back), running every alarm due on the
+/// way with now_us() equal to its target.
+void advance_to(uint64_t us);
+
+/// Target of the earliest pending alarm, or UINT64_MAX if there is none.
+uint64_t next_alarm_us();
+
+/// Back to t = 0 with no alarms, between independent runs.
+void reset();
+
+}  // namespace tilt::sim::clock
@@ -0,0 +1,91 @@
+#include "sim/sim_devices.hpp"
+
+#include "sim/sim_clock.hpp"
+
+namespace tilt::sim {
+
+namespace {
+constexpr uint8_t kCmdContrast = 0x81;
+constexpr uint8_t kCmdNormal = 0xA6;
+constexpr uint8_t kCmdInverse = 0xA7;
+constexpr uint8_t kCmdDisplayOff = 0xAE;
+constexpr uint8_t kCmdDisplayOn = 0xAF;
+}  // namespace
+
+bool Display::init() {
+    on_ = true;
+    return true;
+}
+
+bool Display::send_commands(const uint8_t* cmds, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        switch (cmds[i]) {
+            case kCmdContrast:
+                if (i + 1 < len) {
+                    contrast_ = cmds[++i];
+                }
+                break;
+            case kCmdNormal:
+            case kCmdInverse:
+                inverted_ = cmds[i] == kCmdInverse;
+                break;
+            case kCmdDisplayOff:
+            case kCmdDisplayOn:
+                on_ = cmds[i] == kCmdDisplayOn;
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool Display::flush(Framebuffer& fb, FlushCallback cb, void* ctx) {
+    if (!fb.any_dirty()) {
+        return false;
+    }
+    uint32_t bytes = 0;
+    for (unsigned page = 0; page < Framebuffer::kPages; ++page) {
+        const Framebuffer::DirtySpan span = fb.take_dirty(page);
+        const uint8_t* src = fb.page_data(page);
+        for (unsigned col = span.first; col <= span.last && !span.empty(); ++col) {
+            gddram_[page][col] = src[col];
+        }
+        bytes += span.width();
+    }
+    last_flush_bytes_ = bytes;
+    ++flushes_;
+    if (frame_fn_ != nullptr) {
+        frame_fn_(*this, frame_ctx_);
+    }
+    if (cb != nullptr) {
+        cb(true, ctx);
+    }
+    return true;
+}
+
+uint64_t Tone::duration_us(const Melody& melody) {
+    uint64_t cycles = 0;
+    for (uint32_t i = 0; i + 2 < melody.word_count; i += 3) {
+        const uint64_t periods = uint64_t{melody.words[i + 1]} + 1;
+        cycles += periods * (2 * uint64_t{melody.words[i]} + 7);
+    }
+    return cycles * 1'000'000 / kToneSmHz;
+}
+
+bool Tone::play(const Melody& melody) {
+    const uint64_t now = clock::now_us();
+    busy_until_us_ = (busy_until_us_ > now ? busy_until_us_ : now) + duration_us(melody);
+    ++plays_;
+    return true;
+}
+
+void Tone::stop() {
+    busy_until_us_ = 0;
+}
+
+bool Tone::active() const {
+    return clock::now_us() < busy_until_us_;
+}
+
+}  // namespace tilt::sim
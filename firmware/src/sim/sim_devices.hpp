@@ -0,0 +1,105 @@
+// Host stand-ins for DS1, BZ1 and D1 behind hal/devices.hpp.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "audio/melody.hpp"
+#include "display/framebuffer.hpp"
+#include "led/led_effects.hpp"
+
+namespace tilt::sim {
+
+/// Keeps a copy of the panel's GDDRAM plus the contrast and inversion it was
+/// last sent. A flush completes synchronously, before flush() returns, and
+/// copies only the dirty windows, as the real transfer does; the frame hook
+/// then sees exactly what the panel would show.
+///
+/// send_commands() understands what UiPipeline sends: contrast (0x81, value),
+/// normal/inverse (0xA6/0xA7) and display off/on (0xAE/0xAF). Anything else
+/// is ignored.
+class Display {
+public:
+    using FlushCallback = void (*)(bool ok, void* ctx);
+    using FrameHook = void (*)(const Display& display, void* ctx);
+
+    bool init();
+    bool send_commands(const uint8_t* cmds, size_t len);
+    bool flush(Framebuffer& fb, FlushCallback cb, void* ctx);
+    bool flushing() const { return false; }
+    bool take_failed() { return false; }
+
+    void set_frame_hook(FrameHook fn, void* ctx) {
+        frame_ctx_ = ctx;
+        frame_fn_ = fn;
+    }
+
+    bool pixel(unsigned x, unsigned y) const {
+        return (gddram_[y / 8][x] >> (y % 8)) & 1u;
+    }
+    uint8_t contrast() const { return contrast_; }
+    bool inverted() const { return inverted_; }
+    bool on() const { return on_; }
+
+    uint32_t flushes() const { return flushes_; }
+    uint32_t last_flush_bytes() const { return last_flush_bytes_; }
+
+private:
+    uint8_t gddram_[Framebuffer::kPages][Framebuffer::kWidth] = {};
+    uint8_t contrast_ = 0x7F;
+    bool inverted_ = false;
+    bool on_ = false;
+    uint32_t flushes_ = 0;
+    uint32_t last_flush_bytes_ = 0;
+    FrameHook frame_fn_ = nullptr;
+    void* frame_ctx_ = nullptr;
+};
+
+/// Tracks what BZ1 would be playing against the simulated clock. A melody
+/// lasts exactly as long as the tone program would take to play its words.
+class Tone {
+public:
+    bool init() { return true; }
+    bool play(const Melody& melody);
+    void stop();
+    void set_volume(uint8_t step) { volume_ = step; }
+    bool active() const;
+
+    uint8_t volume() const { return volume_; }
+    uint32_t plays() const { return plays_; }
+    /// Simulated time the queue runs dry.
+    uint64_t busy_until_us() const { return busy_until_us_; }
+
+    /// Playing time of `melody` in us.
+    static uint64_t duration_us(const Melody& melody);
+
+private:
+    uint64_t busy_until_us_ = 0;
+    uint32_t plays_ = 0;
+    uint8_t volume_ = 1;
+};
+
+/// Records the effect D1 is running.
+class Led {
+public:
+    bool init() { return true; }
+    void play(LedEffect effect, uint32_t period_ms) {
+        effect_ = effect;
+        period_ms_ = period_ms;
+        ++changes_;
+    }
+    void off() { play(LedEffect::kOff, 0); }
+
+    LedEffect effect() const { return effect_; }
+    bool active() const { return effect_ != LedEffect::kOff; }
+
+    uint32_t period_ms() const { return period_ms_; }
+    uint32_t changes() const { return changes_; }
+
+private:
+    LedEffect effect_ = LedEffect::kOff;
+    uint32_t period_ms_ = 0;
+    uint32_t changes_ = 0;
+};
+
+}  // namespace tilt::sim
@@ -0,0 +1,511 @@
+// Host simulation: replays recorded accelerometer traces through the
+// firmware's classifier, timer and UI pipeline on a simulated clock.
+//
+// Built for the host, not the RP2040 (see README). Each trace is fed to
+// TiltClassifier in FIFO-sized batches at its capture ODR; face changes
+// start and stop CubeTimer countdowns exactly as core 0 does, and the
+// resulting UiEvents go through the real UiPipeline into sim::Display, which
+// can write every pushed frame to PNG. Time only advances as the trace
+// does, so a 25-minute session replays in well under a millisecond.
+//
+// Prints one `key=value` line per trace (and per grid point with --sweep):
+// face changes, flicker (a change undone again within --flicker-ms) and
+// latency, measured from the first sample of the settled run that the
+// classifier accepted to the end of the batch that reported it.
+//
+// --rest-flip needs no trace: it flips the cube straight out of rest, with
+// and without INT2's falling edge as a dormant wake source, and prints the
+// latency of each.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "app/cube_timer.hpp"
+#include "app/session_tracker.hpp"
+#include "app/ui_link.hpp"
+#include "orientation/tilt_classifier.hpp"
+#include "sim/png_writer.hpp"
+#include "sim/sim_clock.hpp"
+#include "sim/sim_devices.hpp"
+#include "sim/trace_reader.hpp"
+#include "storage/config_store.hpp"
+#include "ui/display_policy.hpp"
+#include "ui/ui_pipeline.hpp"
+
+namespace {
+
+using tilt::Face;
+namespace clk = tilt::sim::clock;
+
+struct Options {
+    uint32_t odr_hz = 200;
+    // main.cpp's kTiltBatch.
+    unsigned batch = 4;
+    double enter_deg = 30.0;
+    uint32_t dwell_ms = 20;
+    uint32_t flicker_ms = 1000;
+    unsigned repeat = 1;
+    bool sweep = false;
+    bool events = false;
+    bool finish = true;
+    bool rest_flip = false;
+    const char* png_dir = nullptr;
+    unsigned scale = 4;
+    std::vector<const char*> traces;
+};
+
+struct Metrics {
+    uint64_t samples = 0;
+    uint64_t sim_us = 0;
+    uint32_t changes = 0;
+    uint32_t flickers = 0;
+    uint32_t timed = 0;  // changes with a measurable latency
+    uint64_t latency_sum_us = 0;
+    uint32_t latency_max_us = 0;
+    uint32_t outcomes[3] = {};  // by SessionOutcome
+    uint32_t frames = 0;
+    uint32_t tones = 0;
+
+    void add(const Metrics& m) {
+        samples += m.samples;
+        sim_us += m.sim_us;
+        changes += m.changes;
+        flickers += m.flickers;
+        timed += m.timed;
+        latency_sum_us += m.latency_sum_us;
+        if (m.latency_max_us > latency_max_us) {
+            latency_max_us = m.latency_max_us;
+        }
+        for (unsigned i = 0; i < 3; ++i) {
+            outcomes[i] += m.outcomes[i];
+        }
+        frames += m.frames;
+        tones += m.tones;
+    }
+};
+
+/// Core 0's application logic around the simulated devices. The face and
+/// timer handlers mirror on_face_change() and run_timer() in main.cpp at
+/// full power with no motion input (INT2 is not in the trace).
+struct SimApp {
+    explicit SimApp(const tilt::TiltConfig& tilt, const Options& options)
+        : options(options), classifier(tilt) {}
+
+    const Options& options;
+    tilt::TiltClassifier classifier;
+    tilt::ConfigStore config;
+    tilt::CubeTimer timer;
+    tilt::SessionTracker session;
+    tilt::UiLink link;
+    tilt::sim::Display display;
+    tilt::sim::Tone tone;
+    tilt::sim::Led led;
+    tilt::UiPipeline ui{link, config, display, tone, led};
+    Face face = Face::kUnknown;
+    Metrics metrics;
+};
+
+double ms(uint64_t us) {
+    return static_cast<double>(us) / 1000.0;
+}
+
+void on_frame(const tilt::sim::Display& display, void* ctx) {
+    auto& app = *static_cast<SimApp*>(ctx);
+    ++app.metrics.frames;
+    const uint64_t now = clk::now_us();
+    if (app.options.events) {
+        std::printf("t_ms=%.1f event=frame n=%lu bytes=%lu\n", ms(now),
+                    static_cast<unsigned long>(display.flushes()),
+                    static_cast<unsigned long>(display.last_flush_bytes()));
+    }
+    if (app.options.png_dir != nullptr) {
+        char path[512];
+        std::snprintf(path, sizeof(path), "%s/ds1_%05lu_%09llu.png", app.options.png_dir,
+                      static_cast<unsigned long>(display.flushes()),
+                      static_cast<unsigned long long>(now / 1000));
+        if (!tilt::sim::write_png(path, display, app.options.scale)) {
+            std::fprintf(stderr, "%s: cannot write\n", path);
+        }
+    }
+}
+
+void post(SimApp& app, tilt::UiEvent::Kind kind, uint32_t remaining_s) {
+    if (app.options.events) {
+        std::printf("t_ms=%.1f event=ui kind=%u face=%u remaining_s=%lu\n", ms(clk::now_us()),
+                    static_cast<unsigned>(kind), tilt::face_index(app.face),
+                    static_cast<unsigned long>(remaining_s));
+    }
+    app.link.post({kind, app.face, remaining_s});
+    const uint32_t tones = app.tone.plays();
+    while (app.ui.step()) {
+    }
+    app.metrics.tones += app.tone.plays() - tones;
+}
+
+void end_session(SimApp& app, tilt::SessionOutcome outcome) {
+    tilt::SessionRecord record;
+    if (app.session.end(outcome, record)) {
+        ++app.metrics.outcomes[static_cast<unsigned>(outcome)];
+    }
+}
+
+void on_face_change(SimApp& app, Face face) {
+    app.face = face;
+    const uint32_t duration = app.config.preset(face).duration_ms;
+    if (duration == 0) {
+        end_session(app, tilt::SessionOutcome::kCancelled);
+        app.timer.cancel();
+        post(app, tilt::UiEvent::Kind::kIdle, 0);
+    } else {
+        end_session(app, tilt::SessionOutcome::kSuperseded);
+        app.timer.start(duration);
+        app.session.begin(face, duration, 0, false);
+        post(app, tilt::UiEvent::Kind::kStarted, app.timer.remaining_s());
+    }
+}
+
+void run_timer(SimApp& app) {
+    for (;;) {
+        switch (app.timer.poll()) {
+            case tilt::CubeTimer::Event::kTick: {
+                const uint32_t remaining = app.timer.remaining_s();
+                if (tilt::display_policy::redraw_due(
+                        remaining, tilt::power_profile(tilt::PowerLevel::kFull).redraw_s,
+                        app.config.theme(app.face).hurry_below_s)) {
+                    post(app, tilt::UiEvent::Kind::kRunning, remaining);
+                }
+                break;
+            }
+            case tilt::CubeTimer::Event::kExpired:
+                post(app, tilt::UiEvent::Kind::kExpired, 0);
+                end_session(app, tilt::SessionOutcome::kCompleted);
+                break;
+            case tilt::CubeTimer::Event::kNone:
+                return;
+        }
+    }
+}
+
+// Runs every alarm due up to `us`, servicing the timer after each one as
+// the event loop would.
+void advance(SimApp& app, uint64_t us) {
+    for (uint64_t next = clk::next_alarm_us(); next <= us; next = clk::next_alarm_us()) {
+        clk::advance_to(next);
+        run_timer(app);
+    }
+    clk::advance_to(us);
+}
+
+// The face an ideal observer would call for a sample: nearest axis, with
+// the classifier's magnitude band. kUnknown while the cube is in free fall
+// or being shaken.
+Face raw_face(const tilt::AccelSample& s, const tilt::TiltConfig& config) {
+    const int32_t x = s.x >> 4;
+    const int32_t y = s.y >> 4;
+    const int32_t z = s.z >> 4;
+    const uint32_t xx = static_cast<uint32_t>(x * x);
+    const uint32_t yy = static_cast<uint32_t>(y * y);
+    const uint32_t zz = static_cast<uint32_t>(z * z);
+    const uint32_t mag2 = xx + yy + zz;
+    if (mag2 < config.min_mag2 || mag2 > config.max_mag2) {
+        return Face::kUnknown;
+    }
+    if (xx >= yy && xx >= zz) {
+        return x >= 0 ? Face::kXPos : Face::kXNeg;
+    }
+    if (yy >= zz) {
+        return y >= 0 ? Face::kYPos : Face::kYNeg;
+    }
+    return z >= 0 ? Face::kZPos : Face::kZNeg;
+}
+
+constexpr size_t kNoRun = SIZE_MAX;
+
+Metrics replay(const std::vector<tilt::AccelSample>& trace, const tilt::TiltConfig& tilt,
+               const Options& options) {
+    clk::reset();
+    SimApp app(tilt, options);
+    app.config.init();
+    app.display.set_frame_hook(&on_frame, &app);
+    app.ui.init();
+    while (app.ui.step()) {
+    }
+    app.classifier.reset(Face::kUnknown);
+
+    const uint64_t sample_us = 1'000'000 / options.odr_hz;
+    Face run_face = Face::kUnknown;
+    size_t run_start = 0;
+    Face before_last = Face::kUnknown;
+    uint64_t last_change_us = 0;
+    for (size_t i = 0; i < trace.size(); i += options.batch) {
+        const size_t n = trace.size() - i < options.batch ? trace.size() - i : options.batch;
+        // Sample by sample, which is all update(batch) does, so the run
+        // behind each accepted switch is known.
+        size_t accepted_run = kNoRun;
+        for (size_t j = i; j < i + n; ++j) {
+            const Face f = raw_face(trace[j], tilt);
+            if (f != run_face) {
+                run_face = f;
+                run_start = j;
+            }
+            if (app.classifier.update(trace[j])) {
+                accepted_run = app.classifier.face() == run_face ? run_start : kNoRun;
+            }
+        }
+        // The batch is delivered once its last sample has been taken, and,
+        // as in OrientationEngine, only a net change reaches the callback.
+        const uint64_t now = (i + n) * sample_us;
+        advance(app, now);
+        const Face face = app.classifier.face();
+        const Face previous = app.face;
+        if (face == previous) {
+            continue;
+        }
+        Metrics& m = app.metrics;
+        ++m.changes;
+        if (face == before_last && now - last_change_us < uint64_t{options.flicker_ms} * 1000) {
+            ++m.flickers;
+        }
+        before_last = previous;
+        last_change_us = now;
+        int64_t latency_us = -1;
+        if (accepted_run != kNoRun) {
+            latency_us = static_cast<int64_t>((i + n - accepted_run) * sample_us);
+            ++m.timed;
+            m.latency_sum_us += static_cast<uint64_t>(latency_us);
+            if (latency_us > m.latency_max_us) {
+                m.latency_max_us = static_cast<uint32_t>(latency_us);
+            }
+        }
+        if (options.events) {
+            std::printf("t_ms=%.1f event=face face=%u latency_ms=%.1f\n", ms(now),
+                        tilt::face_index(face), latency_us >= 0 ? ms(latency_us) : -1.0);
+        }
+        on_face_change(app, face);
+    }
+    app.metrics.samples = trace.size();
+    // Leave the cube on its last face until any countdown rings out.
+    if (options.finish) {
+        while (app.timer.state() == tilt::CubeTimer::State::kRunning &&
+               clk::next_alarm_us() != UINT64_MAX) {
+            advance(app, clk::next_alarm_us());
+        }
+        advance(app, app.tone.busy_until_us());
+    }
+    app.metrics.sim_us = clk::now_us();
+    return app.metrics;
+}
+
+void print_metrics(const Metrics& m) {
+    std::printf(" samples=%llu sim_s=%.1f changes=%lu flickers=%lu latency_mean_ms=%.1f "
+                "latency_max_ms=%.1f completed=%lu superseded=%lu cancelled=%lu frames=%lu "
+                "tones=%lu\n",
+                static_cast<unsigned long long>(m.samples), ms(m.sim_us) / 1000.0,
+                static_cast<unsigned long>(m.changes), static_cast<unsigned long>(m.flickers),
+                m.timed != 0 ? ms(m.latency_sum_us) / m.timed : 0.0, ms(m.latency_max_us),
+                static_cast<unsigned long>(m.outcomes[0]),
+                static_cast<unsigned long>(m.outcomes[2]),
+                static_cast<unsigned long>(m.outcomes[1]), static_cast<unsigned long>(m.frames),
+                static_cast<unsigned long>(m.tones));
+}
+
+Metrics run_all(const std::vector<std::vector<tilt::AccelSample>>& traces,
+                const tilt::TiltConfig& tilt, const Options& options, bool per_trace) {
+    Metrics total;
+    for (size_t t = 0; t < traces.size(); ++t) {
+        Metrics trace_total;
+        for (unsigned r = 0; r < options.repeat; ++r) {
+            trace_total.add(replay(traces[t], tilt, options));
+        }
+        if (per_trace) {
+            std::printf("trace=%s", options.traces[t]);
+            print_metrics(trace_total);
+        }
+        total.add(trace_total);
+    }
+    return total;
+}
+
+// OrientationEngine::kRestWatermark.
+constexpr unsigned kRestWatermark = 30;
+// A quarter turn from +Z onto +X.
+constexpr uint32_t kFlipMs = 100;
+constexpr uint32_t kFlipLimitMs = 2'000;
+
+tilt::AccelSample tilted(double deg) {
+    // 1 g is 1000 counts at 12 bits, left-justified as the FIFO gives them.
+    const double rad = deg * 3.14159265358979 / 180.0;
+    return tilt::AccelSample{static_cast<int16_t>(std::lround(16'000 * std::sin(rad))), 0,
+                             static_cast<int16_t>(std::lround(16'000 * std::cos(rad)))};
+}
+
+// The cube has rested on +Z long enough for U2 to drop to 10 Hz and the
+// engine to raise the watermark; `stale` rest samples are in the FIFO when
+// it is flipped onto +X. U2 returns to the run ODR on the first moving
+// sample and drops INT2. If that edge wakes the chip, service() restores
+// the run watermark at once. If not, nothing runs until INT1 reports the
+// rest watermark, and only that batch brings the watermark back down.
+// Returns the time from the start of the flip to the end of the batch
+// that reports +X (the bus time of each drain is left out), or 0 if none
+// does.
+uint64_t rest_flip_us(const tilt::TiltConfig& tilt, const Options& options, unsigned stale,
+                      bool fall_wakes) {
+    tilt::TiltClassifier classifier(tilt);
+    classifier.reset(Face::kZPos);
+    std::vector<tilt::AccelSample> fifo(stale, tilted(0));
+    unsigned watermark = fall_wakes ? options.batch : kRestWatermark;
+    const uint64_t sample_us = 1'000'000 / options.odr_hz;
+    const uint64_t flip_samples = uint64_t{kFlipMs} * options.odr_hz / 1000;
+    for (uint64_t n = 1; n * sample_us <= uint64_t{kFlipLimitMs} * 1000; ++n) {
+        const double deg = n >= flip_samples ? 90.0 : 90.0 * n / flip_samples;
+        fifo.push_back(tilted(deg));
+        if (fifo.size() < watermark) {
+            continue;
+        }
+        classifier.update(fifo.data(), fifo.size());
+        fifo.clear();
+        watermark = options.batch;
+        if (classifier.face() == Face::kXPos) {
+            return n * sample_us;
+        }
+    }
+    return 0;
+}
+
+// Every FIFO level the flip can meet, from just after a rest batch (0)
+// to just before the next (kRestWatermark - 1).
+void print_rest_flip(const tilt::TiltConfig& tilt, const Options& options) {
+    for (const bool fall_wakes : {true, false}) {
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        unsigned missed = 0;
+        for (unsigned stale = 0; stale < kRestWatermark; ++stale) {
+            const uint64_t us = rest_flip_us(tilt, options, stale, fall_wakes);
+            missed += us == 0 ? 1 : 0;
+            sum += us;
+            max = us > max ? us : max;
+        }
+        std::printf("rest_flip int2_fall_wake=%d latency_mean_ms=%.1f latency_max_ms=%.1f "
+                    "missed=%u\n",
+                    fall_wakes ? 1 : 0, ms(sum) / kRestWatermark, ms(max), missed);
+    }
+}
+
+[[noreturn]] void usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [options] trace.csv...\n"
+                 "  --odr HZ          capture ODR (200)\n"
+                 "  --batch N         samples per classifier update (4)\n"
+                 "  --enter-deg DEG   cone half-angle (30)\n"
+                 "  --dwell-ms MS     dwell before a switch (20)\n"
+                 "  --flicker-ms MS   window for counting an undone change (1000)\n"
+                 "  --repeat N        replay each trace N times\n"
+                 "  --sweep           grid over --enter-deg and --dwell-ms instead\n"
+                 "  --rest-flip       flip straight out of rest, with and without the INT2\n"
+                 "                    fall as a dormant wake (no trace needed)\n"
+                 "  --no-finish       stop at the end of the trace\n"
+                 "  --events          print face, UI and frame events\n"
+                 "  --png DIR         write every pushed DS1 frame to DIR\n"
+                 "  --scale N         PNG pixels per panel pixel (4)\n",
+                 argv0);
+    std::exit(2);
+}
+
+Options parse(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(a, "--odr") == 0 && has_value) {
+            o.odr_hz = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(a, "--batch") == 0 && has_value) {
+            o.batch = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(a, "--enter-deg") == 0 && has_value) {
+            o.enter_deg = std::atof(argv[++i]);
+        } else if (std::strcmp(a, "--dwell-ms") == 0 && has_value) {
+            o.dwell_ms = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(a, "--flicker-ms") == 0 && has_value) {
+            o.flicker_ms = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(a, "--repeat") == 0 && has_value) {
+            o.repeat = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(a, "--png") == 0 && has_value) {
+            o.png_dir = argv[++i];
+        } else if (std::strcmp(a, "--scale") == 0 && has_value) {
+            o.scale = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(a, "--sweep") == 0) {
+            o.sweep = true;
+        } else if (std::strcmp(a, "--rest-flip") == 0) {
+            o.rest_flip = true;
+        } else if (std::strcmp(a, "--no-finish") == 0) {
+            o.finish = false;
+        } else if (std::strcmp(a, "--events") == 0) {
+            o.events = true;
+        } else if (a[0] == '-') {
+            usage(argv[0]);
+        } else {
+            o.traces.push_back(a);
+        }
+    }
+    if ((o.traces.empty() && !o.rest_flip) || o.odr_hz == 0 || o.batch == 0 || o.repeat == 0 ||
+        o.scale == 0) {
+        usage(argv[0]);
+    }
+    return o;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options = parse(argc, argv);
+    std::vector<std::vector<tilt::AccelSample>> traces(options.traces.size());
+    for (size_t t = 0; t < traces.size(); ++t) {
+        if (!tilt::sim::read_trace(options.traces[t], traces[t])) {
+            return 1;
+        }
+    }
+
+    if (options.rest_flip) {
+        print_rest_flip(
+            tilt::make_tilt_config(options.enter_deg, options.dwell_ms, options.odr_hz), options);
+        if (options.traces.empty()) {
+            return 0;
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    Metrics total;
+    if (options.sweep) {
+        // Frames and events are per run; a grid would only bury them.
+        options.png_dir = nullptr;
+        options.events = false;
+        const double degs[] = {20.0, 25.0, 30.0, 35.0, 40.0};
+        const uint32_t dwells[] = {5, 10, 20, 40, 80, 160};
+        for (double deg : degs) {
+            for (uint32_t dwell : dwells) {
+                const Metrics m = run_all(
+                    traces, tilt::make_tilt_config(deg, dwell, options.odr_hz), options, false);
+                std::printf("sweep enter_deg=%.0f dwell_ms=%lu", deg,
+                            static_cast<unsigned long>(dwell));
+                print_metrics(m);
+                total.add(m);
+            }
+        }
+    } else {
+        total = run_all(traces,
+                        tilt::make_tilt_config(options.enter_deg, options.dwell_ms,
+                                               options.odr_hz),
+                        options, true);
+    }
+    const double wall_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const uint32_t sessions = total.outcomes[0] + total.outcomes[1] + total.outcomes[2];
+    std::printf("sim=done sessions=%lu sim_s=%.1f wall_ms=%.1f speedup=%.0f sessions_per_s=%.0f\n",
+                static_cast<unsigned long>(sessions), ms(total.sim_us) / 1000.0, wall_s * 1000.0,
+                wall_s > 0 ? ms(total.sim_us) / 1000.0 / wall_s : 0.0,
+                wall_s > 0 ? sessions / wall_s : 0.0);
+    return 0;
+}
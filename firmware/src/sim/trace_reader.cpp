@@ -0,0 +1,84 @@
+#include "sim/trace_reader.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace tilt::sim {
+
+namespace {
+
+// Splits `line` at commas in place; returns the field count.
+unsigned split(char* line, char** fields, unsigned max_fields) {
+    unsigned n = 0;
+    for (char* p = line; n < max_fields;) {
+        fields[n++] = p;
+        p = std::strchr(p, ',');
+        if (p == nullptr) {
+            break;
+        }
+        *p++ = '\0';
+    }
+    return n;
+}
+
+void chomp(char* line) {
+    line[std::strcspn(line, "\r\n")] = '\0';
+}
+
+}  // namespace
+
+bool read_trace(const char* path, std::vector<AccelSample>& out) {
+    constexpr unsigned kMaxFields = 16;
+    FILE* f = std::fopen(path, "r");
+    if (f == nullptr) {
+        std::fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    char line[256];
+    char* fields[kMaxFields];
+    int col[3] = {-1, -1, -1};
+    if (std::fgets(line, sizeof(line), f) != nullptr) {
+        chomp(line);
+        const unsigned n = split(line, fields, kMaxFields);
+        for (unsigned i = 0; i < n; ++i) {
+            for (int axis = 0; axis < 3; ++axis) {
+                if (fields[i][0] == "xyz"[axis] && fields[i][1] == '\0') {
+                    col[axis] = static_cast<int>(i);
+                }
+            }
+        }
+    }
+    if (col[0] < 0 || col[1] < 0 || col[2] < 0) {
+        std::fprintf(stderr, "%s: header needs x, y and z columns\n", path);
+        std::fclose(f);
+        return false;
+    }
+    unsigned row = 1;
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+        ++row;
+        chomp(line);
+        if (line[0] == '\0') {
+            continue;
+        }
+        const unsigned n = split(line, fields, kMaxFields);
+        int16_t v[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            char* end = nullptr;
+            const long value = static_cast<unsigned>(col[axis]) < n
+                                   ? std::strtol(fields[col[axis]], &end, 10)
+                                   : 0;
+            if (end == nullptr || *end != '\0' || value < INT16_MIN || value > INT16_MAX) {
+                std::fprintf(stderr, "%s:%u: bad sample\n", path, row);
+                std::fclose(f);
+                return false;
+            }
+            v[axis] = static_cast<int16_t>(value);
+        }
+        out.push_back(AccelSample{v[0], v[1], v[2]});
+    }
+    std::fclose(f);
+    return true;
+}
+
+}  // namespace tilt::sim
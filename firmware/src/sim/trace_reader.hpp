@@ -0,0 +1,18 @@
+// Loads accelerometer traces captured with tools/accel_capture.py.
+#pragma once
+
+#include <vector>
+
+#include "drivers/accel_sample.hpp"
+
+namespace tilt::sim {
+
+/// Reads a CSV with a header row naming at least x, y and z columns (the
+/// capture tool's `frame,sample,x,y,z,low_power,overrun` qualifies) and
+/// appends every row as a raw sample. Samples are assumed to be evenly
+/// spaced at the ODR they were captured at; the capture carries no
+/// timestamps. Prints the reason to stderr and returns false on a malformed
+/// file.
+bool read_trace(const char* path, std::vector<AccelSample>& out);
+
+}  // namespace tilt::sim
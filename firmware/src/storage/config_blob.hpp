@@ -0,0 +1,205 @@
+// Versioned config blob: face presets, buzzer patterns and display themes.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "app/face_presets.hpp"
+#include "audio/melodies.hpp"
+#include "orientation/face.hpp"
+#include "orientation/mount.hpp"
+#include "util/crc32.hpp"
+
+namespace tilt {
+
+/// Buzzer patterns a preset can refer to.
+enum class PatternId : uint8_t {
+    kStart = 0,
+    kCancel = 1,
+    kAlarm = 2,
+    kChime = 3,
+};
+inline constexpr unsigned kPatternCount = 4;
+
+inline constexpr unsigned kThemeCount = 4;
+
+/// Timer preset for one resting face.
+struct FacePreset {
+    uint32_t duration_ms;  // 0 = idle face
+    uint8_t theme;         // index into ConfigBlob::themes
+    uint8_t alarm;         // PatternId played on expiry
+    uint16_t reserved;
+};
+
+/// How the panel and D1 present a countdown.
+struct Theme {
+    uint8_t contrast;  // SSD1306 0x81 argument
+    uint8_t inverted;  // 1 = light background
+    uint16_t hurry_below_s;
+    uint16_t breathe_ms;
+    uint16_t hurry_ms;
+    uint16_t alarm_blink_ms;
+    uint16_t reserved;
+};
+
+/// A span of ConfigBlob::words holding one compiled melody.
+struct PatternRef {
+    uint16_t offset;
+    uint16_t word_count;
+};
+
+/// Per-unit measurements, as opposed to the designed values above. All
+/// zero means nothing was measured.
+struct Calibration {
+    int32_t timer_ppb;     // system timer rate error, see power/timebase.hpp
+    uint8_t timer_source;  // timebase::Source that produced it; 0 = none
+    uint8_t mount_set;     // 1 = `mount` was measured (factory/face_cal.cpp)
+    uint16_t reserved;
+    std::array<int16_t, 9> mount;  // Mount::m, orientation/mount.hpp
+    uint16_t reserved2;
+};
+
+/// The unit's measured mount, or the identity if it has none.
+constexpr Mount calibrated_mount(const Calibration& calibration) {
+    return calibration.mount_set != 0 ? Mount{calibration.mount} : kIdentityMount;
+}
+
+struct ConfigHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;  // sizeof(ConfigBlob) for this version
+    uint32_t crc;   // over everything after the header
+    uint32_t reserved;
+};
+
+/// The blob is read in place through XIP, so every field is naturally
+/// aligned, there is no padding, and the whole thing programs as a whole
+/// number of flash pages. Bump kVersion whenever the layout changes; a
+/// mismatched blob is ignored in favour of the built-in defaults.
+struct ConfigBlob {
+    static constexpr uint32_t kMagic = 0x4746'4354;  // "TCFG"
+    static constexpr uint16_t kVersion = 3;
+    static constexpr unsigned kPatternWords = 217;
+
+    ConfigHeader header;
+    std::array<FacePreset, kFaceCount> presets;
+    std::array<Theme, kThemeCount> themes;
+    std::array<PatternRef, kPatternCount> patterns;
+    Calibration calibration;
+    std::array<uint32_t, kPatternWords> words;
+};
+
+static_assert(sizeof(FacePreset) == 8 && sizeof(Theme) == 12 && sizeof(PatternRef) == 4 &&
+              sizeof(Calibration) == 28);
+static_assert(sizeof(ConfigBlob) == 1024, "layout must stay page-aligned and padding-free");
+
+/// Checksum of the payload, walked field by field (see Crc32).
+constexpr uint32_t config_crc(const ConfigBlob& blob) {
+    Crc32 crc;
+    for (const FacePreset& p : blob.presets) {
+        crc.add_u32(p.duration_ms);
+        crc.add_u8(p.theme);
+        crc.add_u8(p.alarm);
+        crc.add_u16(p.reserved);
+    }
+    for (const Theme& t : blob.themes) {
+        crc.add_u8(t.contrast);
+        crc.add_u8(t.inverted);
+        crc.add_u16(t.hurry_below_s);
+        crc.add_u16(t.breathe_ms);
+        crc.add_u16(t.hurry_ms);
+        crc.add_u16(t.alarm_blink_ms);
+        crc.add_u16(t.reserved);
+    }
+    for (const PatternRef& r : blob.patterns) {
+        crc.add_u16(r.offset);
+        crc.add_u16(r.word_count);
+    }
+    crc.add_u32(static_cast<uint32_t>(blob.calibration.timer_ppb));
+    crc.add_u8(blob.calibration.timer_source);
+    crc.add_u8(blob.calibration.mount_set);
+    crc.add_u16(blob.calibration.reserved);
+    for (int16_t m : blob.calibration.mount) {
+        crc.add_u16(static_cast<uint16_t>(m));
+    }
+    crc.add_u16(blob.calibration.reserved2);
+    for (uint32_t w : blob.words) {
+        crc.add_u32(w);
+    }
+    return crc.value();
+}
+
+/// Structural checks that make the blob safe to dereference.
+constexpr bool config_valid(const ConfigBlob& blob) {
+    const ConfigHeader& h = blob.header;
+    if (h.magic != ConfigBlob::kMagic || h.version != ConfigBlob::kVersion ||
+        h.size != sizeof(ConfigBlob)) {
+        return false;
+    }
+    for (const FacePreset& p : blob.presets) {
+        if (p.theme >= kThemeCount || p.alarm >= kPatternCount) {
+            return false;
+        }
+    }
+    for (const PatternRef& r : blob.patterns) {
+        if (r.offset + r.word_count > ConfigBlob::kPatternWords) {
+            return false;
+        }
+    }
+    // Mount::apply() relies on unit-scale entries.
+    for (int16_t m : blob.calibration.mount) {
+        if (blob.calibration.mount_set != 0 && (m > Mount::kOne || m < -Mount::kOne)) {
+            return false;
+        }
+    }
+    return h.crc == config_crc(blob);
+}
+
+namespace detail {
+
+inline constexpr Note kChimeNotes[] = {{2093, 90}, {2637, 90}, {3136, 180}};
+inline constexpr auto kChimeWords = compile_melody(kChimeNotes);
+
+template <size_t N>
+constexpr uint16_t put_pattern(ConfigBlob& blob, uint16_t at, PatternId id,
+                               const std::array<uint32_t, N>& words) {
+    static_assert(N <= ConfigBlob::kPatternWords);
+    for (size_t i = 0; i < N; ++i) {
+        blob.words[at + i] = words[i];
+    }
+    blob.patterns[static_cast<unsigned>(id)] = PatternRef{at, static_cast<uint16_t>(N)};
+    return static_cast<uint16_t>(at + N);
+}
+
+constexpr ConfigBlob make_default_config() {
+    ConfigBlob blob{};
+    blob.header = ConfigHeader{ConfigBlob::kMagic, ConfigBlob::kVersion, sizeof(ConfigBlob), 0, 0};
+    // Theme 0 is the everyday look; theme 1 dims and inverts for the long
+    // focus preset so it is easy to tell apart from across a desk.
+    blob.themes[0] = Theme{0x7F, 0, 60, 2500, 800, 500, 0};
+    blob.themes[1] = Theme{0x40, 1, 300, 4000, 1200, 500, 0};
+    blob.themes[2] = blob.themes[0];
+    blob.themes[3] = blob.themes[0];
+    for (unsigned i = 0; i < kFaceCount; ++i) {
+        blob.presets[i] = FacePreset{kFaceDurationsMs[i], 0,
+                                     static_cast<uint8_t>(PatternId::kAlarm), 0};
+    }
+    blob.presets[face_index(Face::kZNeg)].theme = 1;
+    blob.presets[face_index(Face::kXPos)].alarm = static_cast<uint8_t>(PatternId::kChime);
+    uint16_t at = 0;
+    at = put_pattern(blob, at, PatternId::kStart, melodies::detail::kStartWords);
+    at = put_pattern(blob, at, PatternId::kCancel, melodies::detail::kCancelWords);
+    at = put_pattern(blob, at, PatternId::kAlarm, melodies::detail::kAlarmWords);
+    at = put_pattern(blob, at, PatternId::kChime, kChimeWords);
+    blob.header.crc = config_crc(blob);
+    return blob;
+}
+
+}  // namespace detail
+
+/// Built-in config, used when the reserved sector holds nothing valid. It
+/// lives in .rodata, so it is just as zero-copy as the flash sector.
+inline constexpr ConfigBlob kDefaultConfig = detail::make_default_config();
+static_assert(config_valid(kDefaultConfig));
+
+}  // namespace tilt
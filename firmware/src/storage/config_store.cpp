@@ -0,0 +1,39 @@
+#include "storage/config_store.hpp"
+
+#include "hardware/flash.h"
+#include "storage/flash_layout.hpp"
+#include "storage/flash_ops.hpp"
+
+namespace tilt {
+
+static_assert(sizeof(ConfigBlob) % FLASH_PAGE_SIZE == 0);
+static_assert(sizeof(ConfigBlob) <= FLASH_SECTOR_SIZE);
+
+const ConfigBlob* ConfigStore::flash_blob() {
+    return flash_layout::xip<ConfigBlob>(flash_layout::kConfigOffset);
+}
+
+bool ConfigStore::init() {
+    // A too-large image would place code in the reserved sector, and code
+    // never parses as a valid blob, but check so that is never relied on.
+    const ConfigBlob* blob = flash_blob();
+    active_ = flash_layout::reserved_region_free() && config_valid(*blob) ? blob : &kDefaultConfig;
+    return from_flash();
+}
+
+bool ConfigStore::program(const ConfigBlob& blob) {
+    if (!config_valid(blob) || !flash_layout::reserved_region_free()) {
+        return false;
+    }
+    // The source must not be the sector being erased.
+    if (&blob == flash_blob()) {
+        return true;
+    }
+    active_ = &kDefaultConfig;
+    const bool ok = flash_ops::erase_sector(flash_layout::kConfigOffset) &&
+                    flash_ops::program(flash_layout::kConfigOffset, &blob, sizeof(ConfigBlob));
+    init();
+    return ok && from_flash();
+}
+
+}  // namespace tilt
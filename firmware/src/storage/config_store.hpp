@@ -0,0 +1,45 @@
+// Read-in-place access to the config blob in its reserved flash sector.
+#pragma once
+
+#include "audio/melody.hpp"
+#include "orientation/face.hpp"
+#include "storage/config_blob.hpp"
+
+namespace tilt {
+
+/// Validates the reserved sector once at boot and from then on hands out
+/// pointers straight into XIP flash: a preset lookup is a pointer cast and
+/// an index, and melodies stream to the PIO from the blob itself. Nothing
+/// is copied into SRAM.
+///
+/// Read-only after init(), so both cores may use it without locking.
+class ConfigStore {
+public:
+    /// Selects the flash blob if it is valid, else kDefaultConfig. Returns
+    /// true if the flash blob was taken.
+    bool init();
+
+    const ConfigBlob& active() const { return *active_; }
+    bool from_flash() const { return active_ != &kDefaultConfig; }
+
+    /// `face` must be a real face, not Face::kUnknown.
+    const FacePreset& preset(Face face) const { return active_->presets[face_index(face)]; }
+    const Theme& theme(Face face) const { return active_->themes[preset(face).theme]; }
+    Melody pattern(PatternId id) const {
+        const PatternRef& ref = active_->patterns[static_cast<unsigned>(id)];
+        return Melody{&active_->words[ref.offset], ref.word_count};
+    }
+
+    /// Erases the config sector and programs `blob` into it, then
+    /// re-selects. Blocks for the sector erase with core 1 locked out; only
+    /// for factory and calibration paths, never the timer loop.
+    [[nodiscard]] bool program(const ConfigBlob& blob);
+
+    /// The sector's memory-mapped image, whether valid or not.
+    static const ConfigBlob* flash_blob();
+
+private:
+    const ConfigBlob* active_ = &kDefaultConfig;
+};
+
+}  // namespace tilt
@@ -0,0 +1,12 @@
+#include "storage/flash_layout.hpp"
+
+extern "C" char __flash_binary_end;
+
+namespace tilt::flash_layout {
+
+bool reserved_region_free() {
+    const auto end = reinterpret_cast<uintptr_t>(&__flash_binary_end);
+    return end <= XIP_BASE + kReservedOffset;
+}
+
+}  // namespace tilt::flash_layout
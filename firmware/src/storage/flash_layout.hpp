@@ -0,0 +1,41 @@
+// Reserved regions at the top of U1's QSPI flash.
+#pragma once
+
+#include <cstdint>
+
+#include "hardware/flash.h"
+
+namespace tilt::flash_layout {
+
+// Offsets are from the start of flash (as the flash_range_* calls take
+// them); add XIP_BASE for the memory-mapped address. The image is linked
+// from the bottom and must end below kReservedOffset, which
+// reserved_region_free() checks against the linker's end symbol.
+
+/// Config blob: one sector at the very top.
+inline constexpr uint32_t kConfigOffset = PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE;
+
+/// Session log: a ring of sectors directly below the config sector.
+inline constexpr uint32_t kLogSectors = 16;
+inline constexpr uint32_t kLogOffset = kConfigOffset - kLogSectors * FLASH_SECTOR_SIZE;
+
+/// Boot frame cache: one sector below the log.
+inline constexpr uint32_t kFrameOffset = kLogOffset - FLASH_SECTOR_SIZE;
+
+/// Start of everything the image must not overlap.
+inline constexpr uint32_t kReservedOffset = kFrameOffset;
+
+static_assert(kConfigOffset % FLASH_SECTOR_SIZE == 0);
+static_assert(kLogOffset % FLASH_SECTOR_SIZE == 0);
+static_assert(kFrameOffset % FLASH_SECTOR_SIZE == 0);
+
+template <typename T>
+inline const T* xip(uint32_t offset) {
+    return reinterpret_cast<const T*>(XIP_BASE + offset);
+}
+
+/// False if the linked image reaches into the reserved sectors, in which
+/// case nothing may be erased there.
+bool reserved_region_free();
+
+}  // namespace tilt::flash_layout
@@ -0,0 +1,55 @@
+#include "storage/flash_ops.hpp"
+
+#include "hardware/flash.h"
+#include "pico/flash.h"
+
+namespace tilt::flash_ops {
+
+namespace {
+
+// Long enough for core 1 to finish a flush chunk and park.
+constexpr uint32_t kLockoutTimeoutMs = 100;
+
+struct Job {
+    uint32_t offset;
+    const uint8_t* src;  // null = erase
+    size_t len;
+};
+
+// Runs with core 1 parked and interrupts off. The flash_range_* calls drop
+// XIP only while they run, so a source in flash is still readable between
+// them and is staged to the stack page by page.
+void run_job(void* param) {
+    const auto* job = static_cast<const Job*>(param);
+    if (job->src == nullptr) {
+        flash_range_erase(job->offset, FLASH_SECTOR_SIZE);
+        return;
+    }
+    for (size_t at = 0; at < job->len; at += FLASH_PAGE_SIZE) {
+        uint8_t page[FLASH_PAGE_SIZE];
+        for (uint32_t i = 0; i < FLASH_PAGE_SIZE; ++i) {
+            page[i] = job->src[at + i];
+        }
+        flash_range_program(job->offset + at, page, FLASH_PAGE_SIZE);
+    }
+}
+
+}  // namespace
+
+bool erase_sector(uint32_t offset) {
+    if (offset % FLASH_SECTOR_SIZE != 0) {
+        return false;
+    }
+    Job job{offset, nullptr, 0};
+    return flash_safe_execute(&run_job, &job, kLockoutTimeoutMs) == PICO_OK;
+}
+
+bool program(uint32_t offset, const void* src, size_t len) {
+    if (offset % FLASH_PAGE_SIZE != 0 || len % FLASH_PAGE_SIZE != 0) {
+        return false;
+    }
+    Job job{offset, static_cast<const uint8_t*>(src), len};
+    return flash_safe_execute(&run_job, &job, kLockoutTimeoutMs) == PICO_OK;
+}
+
+}  // namespace tilt::flash_ops
@@ -0,0 +1,20 @@
+// Sector erase and page program behind the SDK's multicore-safe wrapper.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tilt::flash_ops {
+
+// Both calls park core 1 and mask interrupts for their whole duration, so
+// they stall everything running from flash: ~1 ms per page, ~45 ms per
+// sector erase (typical). Callers schedule them for moments when nobody is
+// watching. Offsets are from the start of flash and must be page (program)
+// or sector (erase) aligned; `len` is a whole number of pages.
+
+[[nodiscard]] bool erase_sector(uint32_t offset);
+
+/// `src` may point into XIP flash; it is staged one page at a time.
+[[nodiscard]] bool program(uint32_t offset, const void* src, size_t len);
+
+}  // namespace tilt::flash_ops
@@ -0,0 +1,82 @@
+#include "storage/frame_cache.hpp"
+
+#include <cstring>
+
+#include "hardware/flash.h"
+#include "storage/flash_layout.hpp"
+#include "storage/flash_ops.hpp"
+#include "util/crc32.hpp"
+
+namespace tilt::frame_cache {
+
+namespace {
+
+struct Header {
+    static constexpr uint32_t kMagic = 0x4D52'4654;  // "TFRM"
+    static constexpr uint16_t kVersion = 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t bytes;
+    uint32_t pixel_crc;
+    uint32_t crc;  // over the fields above
+};
+
+static_assert(Framebuffer::kBytes % FLASH_PAGE_SIZE == 0);
+constexpr uint32_t kHeaderOffset = flash_layout::kFrameOffset + Framebuffer::kBytes;
+
+uint32_t header_crc(const Header& h) {
+    Crc32 crc;
+    crc.add_u32(h.magic);
+    crc.add_u16(h.version);
+    crc.add_u16(h.bytes);
+    crc.add_u32(h.pixel_crc);
+    return crc.value();
+}
+
+uint32_t pixel_crc(const uint8_t* pixels) {
+    Crc32 crc;
+    crc.add(pixels, Framebuffer::kBytes);
+    return crc.value();
+}
+
+const uint8_t* pixels() {
+    return flash_layout::xip<uint8_t>(flash_layout::kFrameOffset);
+}
+
+}  // namespace
+
+const uint8_t* load() {
+    // An image that grew into the sector would have code there instead.
+    if (!flash_layout::reserved_region_free()) {
+        return nullptr;
+    }
+    const auto* h = flash_layout::xip<Header>(kHeaderOffset);
+    if (h->magic != Header::kMagic || h->version != Header::kVersion ||
+        h->bytes != Framebuffer::kBytes || h->crc != header_crc(*h) ||
+        h->pixel_crc != pixel_crc(pixels())) {
+        return nullptr;
+    }
+    return pixels();
+}
+
+bool matches(const Framebuffer& fb) {
+    const uint8_t* cached = load();
+    return cached != nullptr && std::memcmp(cached, fb.page_data(0), Framebuffer::kBytes) == 0;
+}
+
+bool store(const Framebuffer& fb) {
+    if (!flash_layout::reserved_region_free()) {
+        return false;
+    }
+    alignas(4) uint8_t page[FLASH_PAGE_SIZE];
+    std::memset(page, 0xFF, sizeof(page));
+    Header h{Header::kMagic, Header::kVersion, Framebuffer::kBytes, pixel_crc(fb.page_data(0)), 0};
+    h.crc = header_crc(h);
+    std::memcpy(page, &h, sizeof(h));
+    return flash_ops::erase_sector(flash_layout::kFrameOffset) &&
+           flash_ops::program(flash_layout::kFrameOffset, fb.page_data(0), Framebuffer::kBytes) &&
+           flash_ops::program(kHeaderOffset, page, sizeof(page));
+}
+
+}  // namespace tilt::frame_cache
@@ -0,0 +1,26 @@
+// DS1 boot frame cached in flash.
+#pragma once
+
+#include <cstdint>
+
+#include "display/framebuffer.hpp"
+
+namespace tilt::frame_cache {
+
+// The last idle frame, so boot can light DS1 with it before config, the
+// log or U2 are up. Pixels fill the first four pages of the sector; a
+// header with their CRC follows in the fifth and is programmed last, so a
+// torn write reads as no cache.
+
+/// The cached pixels in Framebuffer page layout, straight from XIP, or
+/// nullptr if there is no intact cache. Costs a CRC over 1 KB.
+const uint8_t* load();
+
+/// True if the cache holds exactly `fb`'s pixels.
+bool matches(const Framebuffer& fb);
+
+/// Replaces the cache with `fb`'s pixels: one sector erase and five page
+/// programs, with flash_ops' stalls. Callers check matches() first.
+[[nodiscard]] bool store(const Framebuffer& fb);
+
+}  // namespace tilt::frame_cache
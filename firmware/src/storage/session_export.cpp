@@ -0,0 +1,154 @@
+#include "storage/session_export.hpp"
+
+#include <cstring>
+
+#include "util/varint.hpp"
+
+namespace tilt {
+
+namespace {
+
+// Payload builder for one item; sized for the largest (kPower).
+class Payload {
+public:
+    void u8(uint8_t v) { bytes_[len_++] = v; }
+    void varint(uint64_t v) { len_ += put_varint(bytes_ + len_, v); }
+    void signed_delta(int64_t now, int64_t before) { varint(zigzag(now - before)); }
+    void raw(const uint8_t* data, size_t len) {
+        std::memcpy(bytes_ + len_, data, len);
+        len_ += len;
+    }
+
+    const uint8_t* data() const { return bytes_; }
+    size_t size() const { return len_; }
+
+private:
+    uint8_t bytes_[kPowerStateCount * 3 * kMaxVarintBytes] = {};
+    size_t len_ = 0;
+};
+
+}  // namespace
+
+void SessionExport::begin(const ExportInfo& info) {
+    info_ = info;
+    cursor_ = SessionLog::Cursor{};
+    end_sequence_ = log_.next_sequence();
+    sessions_ = 0;
+    prev_ = SessionRecord{};
+    crc_ = Crc32{};
+    bytes_ = 0;
+    stage_len_ = 0;
+    stage_pos_ = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        stage_[stage_len_++] = static_cast<uint8_t>(kMagic >> (8 * i));
+    }
+    stage_[stage_len_++] = kVersion;
+    crc_.add(stage_, stage_len_);
+    phase_ = Phase::kUnit;
+}
+
+size_t SessionExport::read(uint8_t* out, size_t len) {
+    size_t copied = 0;
+    while (copied < len && active()) {
+        if (stage_pos_ == stage_len_ && !refill()) {
+            break;
+        }
+        size_t n = stage_len_ - stage_pos_;
+        n = n < len - copied ? n : len - copied;
+        std::memcpy(out + copied, stage_ + stage_pos_, n);
+        stage_pos_ += n;
+        copied += n;
+    }
+    bytes_ += copied;
+    return copied;
+}
+
+void SessionExport::commit(Tag tag, const uint8_t* payload, size_t len, size_t trailer) {
+    stage_len_ = put_varint(stage_, static_cast<uint8_t>(tag));
+    stage_len_ += put_varint(stage_ + stage_len_, len + trailer);
+    std::memcpy(stage_ + stage_len_, payload, len);
+    stage_len_ += len;
+    stage_pos_ = 0;
+    crc_.add(stage_, stage_len_);
+}
+
+void SessionExport::on_record(const SessionRecord& record, void* ctx) {
+    static_cast<SessionExport*>(ctx)->encode(record);
+}
+
+void SessionExport::encode(const SessionRecord& r) {
+    if (r.sequence >= end_sequence_) {
+        phase_ = Phase::kEnd;
+        return;
+    }
+    Payload p;
+    p.varint(r.sequence - prev_.sequence);
+    p.signed_delta(r.start_s, prev_.start_s);
+    p.signed_delta(r.planned_ms, prev_.planned_ms);
+    p.varint(r.actual_ms);
+    p.signed_delta(r.battery_mv, prev_.battery_mv);
+    p.u8(static_cast<uint8_t>((r.face & 0x0F) | static_cast<uint8_t>(r.outcome) << 4));
+    p.varint(r.interruptions);
+    commit(Tag::kSession, p.data(), p.size());
+    prev_ = r;
+    ++sessions_;
+}
+
+bool SessionExport::refill() {
+    // Each pass stages exactly one item, or moves on to the next phase.
+    while (true) {
+        Payload p;
+        switch (phase_) {
+            case Phase::kIdle:
+                return false;
+            case Phase::kUnit:
+                p.raw(info_.board_id, sizeof(info_.board_id));
+                p.varint(info_.awake_s);
+                p.varint(info_.battery_mv);
+                p.varint(info_.power_level);
+                p.varint(end_sequence_);
+                p.varint(log_.dropped());
+                commit(Tag::kUnit, p.data(), p.size());
+                phase_ = Phase::kPower;
+                return true;
+            case Phase::kPower:
+                for (unsigned s = 0; s < kPowerStateCount; ++s) {
+                    p.varint(info_.power.residency_us[s] / 1000);
+                    p.varint(info_.power.entries[s]);
+                    p.varint(info_.power.charge_nah[s]);
+                }
+                commit(Tag::kPower, p.data(), p.size());
+                phase_ = Phase::kSessions;
+                return true;
+            case Phase::kSessions: {
+                stage_len_ = 0;
+                stage_pos_ = 0;
+                const bool done = log_.visit_from(cursor_, 1, &SessionExport::on_record, this);
+                if (stage_len_ != 0) {
+                    return true;
+                }
+                if (done) {
+                    phase_ = Phase::kEnd;
+                }
+                break;
+            }
+            case Phase::kEnd: {
+                p.varint(sessions_);
+                // The CRC covers everything before its own field, this
+                // item's tag, length and count included.
+                commit(Tag::kEnd, p.data(), p.size(), sizeof(uint32_t));
+                const uint32_t crc = crc_.value();
+                for (unsigned i = 0; i < 4; ++i) {
+                    stage_[stage_len_++] = static_cast<uint8_t>(crc >> (8 * i));
+                }
+                phase_ = Phase::kDone;
+                return true;
+            }
+            case Phase::kDone:
+                phase_ = Phase::kIdle;
+                return false;
+        }
+    }
+}
+
+}  // namespace tilt
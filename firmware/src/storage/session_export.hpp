@@ -0,0 +1,99 @@
+// Compact, versioned binary export of the session log and power stats.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "power/power_manager.hpp"
+#include "storage/session_log.hpp"
+#include "util/crc32.hpp"
+
+namespace tilt {
+
+/// Everything in an export besides the sessions, captured when it starts.
+struct ExportInfo {
+    uint8_t board_id[8];  // flash unique ID, names the unit
+    uint32_t awake_s;     // same clock as SessionRecord::start_s
+    uint16_t battery_mv;  // last reading; 0 = not measured
+    uint8_t power_level;  // PowerLevel
+    PowerManager::Stats power;
+};
+
+/// Encodes the log as one byte stream that can be read out in any chunk
+/// size, so a whole unit drains in a single streaming bulk read.
+///
+/// Format version 1, all multi-byte integers varints unless noted:
+///
+///   "TLEX" (u32 LE 0x58454C54), version (u8)
+///   items: tag, payload length, payload
+///     kUnit     board_id (8 raw bytes), awake_s, battery_mv, power_level,
+///               next_sequence, dropped
+///     kPower    per PowerState: residency_ms, entries, charge_nah
+///     kSession  sequence delta, zigzag start_s delta, zigzag planned_ms
+///               delta, actual_ms, zigzag battery_mv delta,
+///               face | outcome << 4 (u8), interruptions
+///     kEnd      session count, then CRC-32 (u32 LE) of every byte before it
+///
+/// Session deltas are against the previous session item (zero for the
+/// first), so a typical session is 10-12 bytes against its 32-byte slot. A
+/// reader skips tags it does not know and payload bytes past the fields it
+/// knows, so new items and trailing fields do not need a version bump.
+///
+/// Sessions are those logged before begin(); later ones go in the next
+/// export.
+class SessionExport {
+public:
+    static constexpr uint32_t kMagic = 0x5845'4C54;  // "TLEX"
+    static constexpr uint8_t kVersion = 1;
+
+    enum class Tag : uint8_t {
+        kEnd = 0,
+        kUnit = 1,
+        kPower = 2,
+        kSession = 3,
+    };
+
+    explicit SessionExport(const SessionLog& log) : log_(log) {}
+
+    /// Starts a new export, dropping any unfinished one.
+    void begin(const ExportInfo& info);
+
+    /// Abandons an unfinished export.
+    void cancel() { phase_ = Phase::kIdle; }
+
+    bool active() const { return phase_ != Phase::kIdle; }
+
+    /// Copies up to `len` next bytes of the export into `out`. Returns the
+    /// count; 0 means the export is complete (or none was begun).
+    size_t read(uint8_t* out, size_t len);
+
+    uint32_t bytes_sent() const { return bytes_; }
+
+private:
+    enum class Phase : uint8_t { kIdle, kUnit, kPower, kSessions, kEnd, kDone };
+
+    static constexpr size_t kStageBytes = 96;
+
+    static void on_record(const SessionRecord& record, void* ctx);
+
+    bool refill();
+    // Stages one item. `trailer` bytes are counted in its length but
+    // appended, outside the CRC, by the caller.
+    void commit(Tag tag, const uint8_t* payload, size_t len, size_t trailer = 0);
+    void encode(const SessionRecord& record);
+
+    const SessionLog& log_;
+    ExportInfo info_{};
+    Phase phase_ = Phase::kIdle;
+    SessionLog::Cursor cursor_;
+    uint32_t end_sequence_ = 0;
+    uint32_t sessions_ = 0;
+    SessionRecord prev_{};
+    Crc32 crc_;
+    uint32_t bytes_ = 0;
+    uint8_t stage_[kStageBytes] = {};
+    size_t stage_len_ = 0;
+    size_t stage_pos_ = 0;
+};
+
+}  // namespace tilt
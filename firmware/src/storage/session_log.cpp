@@ -0,0 +1,224 @@
+#include "storage/session_log.hpp"
+
+#include <cstring>
+
+#include "storage/flash_ops.hpp"
+
+namespace tilt {
+
+static_assert(FLASH_PAGE_SIZE % sizeof(SessionRecord) == 0);
+
+const SessionLog::SectorHeader* SessionLog::header_at(uint32_t sector) {
+    const auto* h = reinterpret_cast<const SectorHeader*>(slot_ptr(sector, 0));
+    if (h->magic != SectorHeader::kMagic || h->version != SectorHeader::kVersion ||
+        h->slot_bytes != kSlotBytes || h->crc != header_crc(*h)) {
+        return nullptr;
+    }
+    return h;
+}
+
+bool SessionLog::slot_erased(uint32_t sector, uint32_t slot) {
+    const uint8_t* p = slot_ptr(sector, slot);
+    for (uint32_t i = 0; i < kSlotBytes; ++i) {
+        if (p[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t SessionLog::header_crc(const SectorHeader& header) {
+    Crc32 crc;
+    crc.add_u32(header.magic);
+    crc.add_u16(header.version);
+    crc.add_u16(header.slot_bytes);
+    crc.add_u32(header.sector_seq);
+    crc.add(header.reserved, sizeof(header.reserved));
+    return crc.value();
+}
+
+void SessionLog::init() {
+    usable_ = flash_layout::reserved_region_free();
+    sector_open_ = false;
+    sector_ = 0;
+    sector_seq_ = 0;
+    slot_ = 0;
+    next_seq_ = 0;
+    if (!usable_) {
+        return;
+    }
+
+    for (uint32_t s = 0; s < flash_layout::kLogSectors; ++s) {
+        const SectorHeader* h = header_at(s);
+        if (h != nullptr && (!sector_open_ || h->sector_seq > sector_seq_)) {
+            sector_open_ = true;
+            sector_ = s;
+            sector_seq_ = h->sector_seq;
+        }
+    }
+    if (!sector_open_) {
+        return;
+    }
+
+    slot_ = 1;
+    while (slot_ < kSlotsPerSector && !slot_erased(sector_, slot_)) {
+        ++slot_;
+    }
+    // Continue numbering from the newest intact record. A torn write at the
+    // end is skipped; the header goes in with the first record, so a valid
+    // newest sector almost always has one.
+    for (uint32_t slot = slot_; slot-- > 1;) {
+        const auto* r = reinterpret_cast<const SessionRecord*>(slot_ptr(sector_, slot));
+        if (r->crc == session_crc(*r)) {
+            next_seq_ = r->sequence + 1;
+            break;
+        }
+    }
+}
+
+bool SessionLog::append(const SessionRecord& record) {
+    if (pending_count_ == kSlotsPerPage) {
+        ++dropped_;
+        return false;
+    }
+    SessionRecord& r = pending_[pending_count_++];
+    r = record;
+    r.sequence = next_seq_++;
+    r.crc = session_crc(r);
+    return true;
+}
+
+bool SessionLog::service(bool quiet) {
+    if (!usable_ || !quiet) {
+        return false;
+    }
+    if (pending_count_ != 0) {
+        return flush_page();
+    }
+    // Erase ahead once the open sector is down to its last page, so the
+    // next flush costs a page program rather than a sector erase.
+    const uint32_t next = sector_open_ ? (sector_ + 1) % flash_layout::kLogSectors : 0;
+    const bool nearly_full = !sector_open_ || kSlotsPerSector - slot_ <= kSlotsPerPage;
+    if (nearly_full && prepared_ != next) {
+        if (!flash_ops::erase_sector(sector_offset(next))) {
+            return false;
+        }
+        prepared_ = next;
+        return true;
+    }
+    return false;
+}
+
+bool SessionLog::open_next_sector() {
+    const uint32_t next = sector_open_ ? (sector_ + 1) % flash_layout::kLogSectors : 0;
+    if (prepared_ != next && !flash_ops::erase_sector(sector_offset(next))) {
+        return false;
+    }
+    prepared_ = kNoSector;
+    sector_ = next;
+    sector_seq_ = sector_open_ ? sector_seq_ + 1 : 0;
+    sector_open_ = true;
+    slot_ = 0;
+    return true;
+}
+
+bool SessionLog::flush_page() {
+    if ((!sector_open_ || slot_ == kSlotsPerSector) && !open_next_sector()) {
+        return false;
+    }
+    alignas(4) uint8_t page[FLASH_PAGE_SIZE];
+    std::memset(page, 0xFF, sizeof(page));
+    const uint32_t page_first = slot_ / kSlotsPerPage * kSlotsPerPage;
+    uint32_t slot = slot_;
+    if (slot == 0) {
+        SectorHeader h{};
+        h.magic = SectorHeader::kMagic;
+        h.version = SectorHeader::kVersion;
+        h.slot_bytes = kSlotBytes;
+        h.sector_seq = sector_seq_;
+        std::memset(h.reserved, 0xFF, sizeof(h.reserved));
+        h.crc = header_crc(h);
+        std::memcpy(page, &h, sizeof(h));
+        slot = 1;
+    }
+    uint32_t taken = 0;
+    while (taken < pending_count_ && slot < page_first + kSlotsPerPage) {
+        std::memcpy(page + (slot - page_first) * kSlotBytes, &pending_[taken], kSlotBytes);
+        ++taken;
+        ++slot;
+    }
+    const uint32_t offset = sector_offset(sector_) + page_first * kSlotBytes;
+    if (!flash_ops::program(offset, page, sizeof(page))) {
+        return false;
+    }
+    slot_ = slot;
+    pending_count_ -= taken;
+    std::memmove(pending_, pending_ + taken, pending_count_ * sizeof(SessionRecord));
+    return true;
+}
+
+void SessionLog::for_each(Visitor visit, void* ctx) const {
+    if (usable_ && sector_open_) {
+        // Sequence numbers rise along the ring, so starting just after the
+        // newest sector visits them oldest first.
+        for (uint32_t i = 1; i <= flash_layout::kLogSectors; ++i) {
+            const uint32_t s = (sector_ + i) % flash_layout::kLogSectors;
+            if (header_at(s) == nullptr) {
+                continue;
+            }
+            for (uint32_t slot = 1; slot < kSlotsPerSector; ++slot) {
+                const auto* r = reinterpret_cast<const SessionRecord*>(slot_ptr(s, slot));
+                if (r->crc == session_crc(*r)) {
+                    visit(*r, ctx);
+                }
+            }
+        }
+    }
+    for (uint32_t i = 0; i < pending_count_; ++i) {
+        visit(pending_[i], ctx);
+    }
+}
+
+bool SessionLog::visit_from(Cursor& cursor, uint32_t limit, Visitor visit, void* ctx) const {
+    uint32_t visited = 0;
+    const auto take = [&](const SessionRecord& r) {
+        if (r.sequence >= cursor.next_sequence) {
+            visit(r, ctx);
+            cursor.next_sequence = r.sequence + 1;
+            ++visited;
+        }
+    };
+    if (usable_ && sector_open_) {
+        if (cursor.sector == kNoSector) {
+            cursor.sector = (sector_ + 1) % flash_layout::kLogSectors;
+            cursor.slot = 1;
+        }
+        while (visited < limit) {
+            // The open sector ends at the write position: that is where
+            // pending records will land, so it must not be passed early.
+            const bool newest = cursor.sector == sector_;
+            const uint32_t end = newest ? slot_ : kSlotsPerSector;
+            if (cursor.slot == 1 && cursor.slot < end && header_at(cursor.sector) == nullptr) {
+                cursor.slot = end;
+            }
+            for (; cursor.slot < end && visited < limit; ++cursor.slot) {
+                const auto* r =
+                    reinterpret_cast<const SessionRecord*>(slot_ptr(cursor.sector, cursor.slot));
+                if (r->crc == session_crc(*r)) {
+                    take(*r);
+                }
+            }
+            if (cursor.slot < end || newest) {
+                break;
+            }
+            cursor.sector = (cursor.sector + 1) % flash_layout::kLogSectors;
+            cursor.slot = 1;
+        }
+    }
+    for (uint32_t i = 0; i < pending_count_ && visited < limit; ++i) {
+        take(pending_[i]);
+    }
+    return visited < limit;
+}
+
+}  // namespace tilt
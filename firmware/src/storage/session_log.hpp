@@ -0,0 +1,113 @@
+// Append-only, wear-leveled session history in a ring of flash sectors.
+#pragma once
+
+#include <cstdint>
+
+#include "hardware/flash.h"
+#include "storage/flash_layout.hpp"
+#include "storage/session_record.hpp"
+
+namespace tilt {
+
+/// Log-structured store over flash_layout's log sectors.
+///
+/// Each sector starts with a header slot carrying a monotonic sector
+/// sequence number, followed by 127 record slots. Sectors are used in ring
+/// order and each is erased exactly once per pass, so wear is spread evenly
+/// and the newest sector is simply the one with the highest sequence.
+///
+/// append() only copies into a RAM batch of one flash page; it never
+/// touches flash. service() writes the batch out, and pre-erases the next
+/// sector, only when told the system is quiet. A page is programmed as a
+/// whole: slots already written are left at 0xFF in the staging page,
+/// which programs as a no-op, so a partly used page can be topped up later
+/// without an erase.
+class SessionLog {
+public:
+    static constexpr uint32_t kSlotBytes = sizeof(SessionRecord);
+    static constexpr uint32_t kSlotsPerPage = FLASH_PAGE_SIZE / kSlotBytes;
+    static constexpr uint32_t kSlotsPerSector = FLASH_SECTOR_SIZE / kSlotBytes;
+    static constexpr uint32_t kRecordsPerSector = kSlotsPerSector - 1;
+    static constexpr uint32_t kCapacity = kRecordsPerSector * flash_layout::kLogSectors;
+
+    using Visitor = void (*)(const SessionRecord& record, void* ctx);
+
+    /// Where visit_from() stopped. Default-constructed, it starts at the
+    /// oldest record.
+    struct Cursor {
+        uint32_t sector = kNoSector;
+        uint32_t slot = 1;
+        uint32_t next_sequence = 0;  // records below this were already visited
+    };
+
+    /// Scans the sector headers to find the write position. Takes one XIP
+    /// read per header plus a scan of the newest sector; no flash writes.
+    void init();
+
+    /// Stamps `record` with the next sequence number and CRC and queues it.
+    /// Returns false, dropping it, if the RAM batch is full.
+    bool append(const SessionRecord& record);
+
+    /// Does deferred flash work. `quiet` means stalling both cores for a
+    /// sector erase is acceptable now and no DMA is streaming from XIP
+    /// (melodies, LED curves), since XIP is offline while flash is written.
+    /// Returns true if flash was written.
+    bool service(bool quiet);
+
+    bool pending() const { return pending_count_ != 0; }
+
+    /// Visits every valid record, oldest first, including ones still in RAM.
+    void for_each(Visitor visit, void* ctx) const;
+
+    /// for_each() in pieces: visits up to `limit` records after `cursor`
+    /// and advances it. Returns true once every record present now has been
+    /// visited. Safe across appends and flushes between calls: records move
+    /// from RAM to slots the cursor has not reached yet, and the sequence
+    /// check skips any it has already seen.
+    bool visit_from(Cursor& cursor, uint32_t limit, Visitor visit, void* ctx) const;
+
+    uint32_t next_sequence() const { return next_seq_; }
+    uint32_t dropped() const { return dropped_; }
+
+private:
+    struct SectorHeader {
+        static constexpr uint32_t kMagic = 0x474F'4C54;  // "TLOG"
+        static constexpr uint16_t kVersion = 1;
+
+        uint32_t magic;
+        uint16_t version;
+        uint16_t slot_bytes;
+        uint32_t sector_seq;
+        uint8_t reserved[16];
+        uint32_t crc;
+    };
+    static_assert(sizeof(SectorHeader) == kSlotBytes);
+
+    static constexpr uint32_t kNoSector = 0xFFFF'FFFF;
+
+    static uint32_t sector_offset(uint32_t sector) {
+        return flash_layout::kLogOffset + sector * FLASH_SECTOR_SIZE;
+    }
+    static const uint8_t* slot_ptr(uint32_t sector, uint32_t slot) {
+        return flash_layout::xip<uint8_t>(sector_offset(sector) + slot * kSlotBytes);
+    }
+    static const SectorHeader* header_at(uint32_t sector);
+    static bool slot_erased(uint32_t sector, uint32_t slot);
+    static uint32_t header_crc(const SectorHeader& header);
+
+    bool open_next_sector();
+    bool flush_page();
+
+    bool usable_ = false;
+    bool sector_open_ = false;
+    uint32_t sector_ = 0;
+    uint32_t sector_seq_ = 0;
+    uint32_t slot_ = 0;  // next free slot in sector_
+    uint32_t prepared_ = kNoSector;
+    uint32_t next_seq_ = 0;
+    uint32_t dropped_ = 0;
+    uint32_t pending_count_ = 0;
+    SessionRecord pending_[kSlotsPerPage] = {};
+};
+
+}  // namespace tilt
@@ -0,0 +1,50 @@
+// One timer session as stored in the flash log.
+#pragma once
+
+#include <cstdint>
+
+#include "orientation/face.hpp"
+#include "util/crc32.hpp"
+
+namespace tilt {
+
+enum class SessionOutcome : uint8_t {
+    kCompleted = 0,   // ran to the alarm
+    kCancelled = 1,   // turned to the idle face
+    kSuperseded = 2,  // turned to another preset face
+};
+
+/// Fixed 32-byte slot, eight per flash page. An erased slot reads all 0xFF
+/// and never carries a valid CRC, so the log needs no separate index.
+struct SessionRecord {
+    uint32_t sequence;    // monotonic across the whole log
+    uint32_t start_s;     // awake seconds since boot (the timer stops in dormant)
+    uint32_t planned_ms;
+    uint32_t actual_ms;
+    uint16_t battery_mv;  // at start; 0 = not measured
+    uint8_t face;         // Face
+    uint8_t interruptions;  // pick-ups that did not change face
+    SessionOutcome outcome;
+    uint8_t reserved[7];
+    uint32_t crc;  // over everything above
+};
+
+static_assert(sizeof(SessionRecord) == 32);
+
+constexpr uint32_t session_crc(const SessionRecord& r) {
+    Crc32 crc;
+    crc.add_u32(r.sequence);
+    crc.add_u32(r.start_s);
+    crc.add_u32(r.planned_ms);
+    crc.add_u32(r.actual_ms);
+    crc.add_u16(r.battery_mv);
+    crc.add_u8(r.face);
+    crc.add_u8(r.interruptions);
+    crc.add_u8(static_cast<uint8_t>(r.outcome));
+    for (uint8_t b : r.reserved) {
+        crc.add_u8(b);
+    }
+    return crc.value();
+}
+
+}  // namespace tilt
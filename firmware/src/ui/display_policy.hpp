@@ -0,0 +1,53 @@
+// When DS1 is lit, dimmed or blanked, and how often a countdown redraws.
+#pragma once
+
+#include <cstdint>
+
+#include "orientation/face.hpp"
+
+namespace tilt::display_policy {
+
+/// DS1 sits on +Z, so on -Z it faces the table and nobody can see it.
+/// The panel sleeps there (charge pump off, GDDRAM kept) and wakes with
+/// the next event from any other face.
+inline constexpr Face kHiddenFace = Face::kZNeg;
+
+inline constexpr bool panel_visible(Face face) {
+    return face != kHiddenFace;
+}
+
+/// Full contrast for this long after a state change, then the theme
+/// contrast is shifted down by kDimShift more until the next change or the
+/// hurry stretch. Segment current, and so most of the panel's draw, scales
+/// with contrast.
+inline constexpr uint32_t kBrightMs = 10'000;
+inline constexpr uint8_t kDimShift = 2;
+
+/// Above this a countdown shows whole minutes, rounded up, so the digits
+/// and the bus change once a minute instead of every second.
+inline constexpr uint32_t kMinutesAboveS = 10 * 60;
+
+/// The value the countdown shows for `remaining_s`. Never below the real
+/// remaining time, and exact again in the last kMinutesAboveS seconds.
+inline constexpr uint32_t shown_s(uint32_t remaining_s) {
+    return remaining_s > kMinutesAboveS ? (remaining_s + 59) / 60 * 60 : remaining_s;
+}
+
+/// Whether core 0 should post a tick at `remaining_s`: on multiples of the
+/// power profile's `redraw_s`, only when shown_s() changes, and every
+/// second from `hurry_below_s` down.
+inline constexpr bool redraw_due(uint32_t remaining_s, uint32_t redraw_s,
+                                 uint32_t hurry_below_s) {
+    if (remaining_s <= hurry_below_s) {
+        return true;
+    }
+    if (remaining_s > kMinutesAboveS) {
+        return remaining_s % 60 == 0;
+    }
+    return remaining_s % redraw_s == 0;
+}
+
+static_assert(shown_s(601) == 660 && shown_s(660) == 660 && shown_s(600) == 600);
+static_assert(redraw_due(660, 1, 30) && !redraw_due(659, 1, 30) && redraw_due(599, 1, 30));
+
+}  // namespace tilt::display_policy
@@ -0,0 +1,284 @@
+#include "ui/ui_pipeline.hpp"
+
+#include <cstring>
+
+#include "diag/trace.hpp"
+#include "display/fonts.hpp"
+#include "ui/display_policy.hpp"
+
+#if !TILT_HOST
+#include "hardware/sync.h"
+#include "pico/flash.h"
+#include "pico/multicore.h"
+#endif
+
+namespace tilt {
+
+namespace {
+constexpr uint8_t kCmdContrast = 0x81;
+constexpr uint8_t kCmdNormal = 0xA6;
+constexpr uint8_t kCmdInverse = 0xA7;
+constexpr uint8_t kCmdChargePump = 0x8D;
+constexpr uint8_t kChargePumpOn = 0x14;
+constexpr uint8_t kChargePumpOff = 0x10;
+constexpr uint8_t kCmdDisplayOff = 0xAE;
+constexpr uint8_t kCmdDisplayOn = 0xAF;
+
+// Display off before the pump, so the panel never runs on a sagging rail.
+// The SSD1306 keeps GDDRAM through sleep; waking needs no redraw.
+constexpr uint8_t kSleepCmds[] = {kCmdDisplayOff, kCmdChargePump, kChargePumpOff};
+
+// wake_cmds_ from this offset skips the pump, for a lit panel.
+constexpr size_t kThemeCmdsOffset = 2;
+}  // namespace
+
+UiPipeline* UiPipeline::instance_ = nullptr;
+
+#if !TILT_HOST
+void UiPipeline::launch() {
+    instance_ = this;
+    multicore_launch_core1(&UiPipeline::core1_entry);
+}
+
+void UiPipeline::core1_entry() {
+    instance_->run();
+}
+
+void UiPipeline::run() {
+    // Lets core 0 park this core while it programs the config sector. The
+    // lockout handler shares the SIO FIFO with UiLink's doorbell and may eat
+    // one, which is harmless: the interrupt itself ends the WFE.
+    flash_safe_execute_core_init();
+    init();
+
+    while (true) {
+        if (!step()) {
+            if (!oled_.flushing()) {
+                link_.mark_settled();
+            }
+            link_.wait();
+        }
+    }
+}
+
+void UiPipeline::boot(const uint8_t* cached) {
+    if (!oled_.init_dark()) {
+        return;
+    }
+    display_ok_ = true;
+    if (cached != nullptr) {
+        frame_.load(cached);
+    } else {
+        countdown_.render(frame_, 0);
+        countdown_.set_status_icon(frame_, &fonts::kPause);
+    }
+    trace::record(trace::Event::kFlushStart);
+    if (oled_.flush(frame_, &UiPipeline::on_flush_done, this)) {
+        while (oled_.flushing()) {
+            tight_loop_contents();
+        }
+    }
+    // Lit even if the push failed: the first step() after init() then
+    // marks the frame dirty again and resends it.
+    (void)oled_.display_on();
+}
+#endif
+
+void UiPipeline::init() {
+    if (!display_ok_) {
+        display_ok_ = oled_.init();
+    }
+    // Claimed here so the melody-boundary IRQ runs on core 1.
+    buzzer_ok_ = buzzer_.init();
+    // The cache only ever holds this same screen, so after boot() this
+    // just syncs the view's state and dirties nothing.
+    countdown_.render(frame_, 0);
+    countdown_.set_status_icon(frame_, &fonts::kPause);
+}
+
+bool UiPipeline::step() {
+    bool busy = false;
+    UiEvent event;
+    while (link_.receive(event)) {
+        apply(event);
+        busy = true;
+    }
+    if (dim_fired_ != 0 && dim_fired_ == dim_alarm_) {
+        dim_fired_ = 0;
+        dim_alarm_ = 0;
+        dimmed_ = true;
+        sync_panel();
+        // After the contrast write is queued, so core 0 sees the bus busy
+        // before it sees the alarm gone.
+        dim_pending_.store(false, std::memory_order_release);
+        busy = true;
+    }
+    if (oled_.take_failed()) {
+        // DS1 may hold any mix of old and new; resend the whole frame.
+        frame_.mark_all_dirty();
+        busy = true;
+    }
+    if (display_ok_ && panel_on_ && !oled_.flushing() && frame_.any_dirty()) {
+        trace::record(trace::Event::kFlushStart);
+        busy |= oled_.flush(frame_, &UiPipeline::on_flush_done, this);
+    }
+    return busy;
+}
+
+void UiPipeline::apply(const UiEvent& event) {
+    trace::record(trace::Event::kRenderStart, static_cast<uint16_t>(event.kind));
+    render(event);
+    trace::record(trace::Event::kRenderEnd, static_cast<uint16_t>(event.kind));
+}
+
+void UiPipeline::render(const UiEvent& event) {
+    if (event.kind == UiEvent::Kind::kPower) {
+        set_power(event.power);
+        return;
+    }
+    const Theme& theme = config_.theme(event.face);
+    set_theme(theme);
+    const FacePreset& preset = config_.preset(event.face);
+    const uint32_t shown_s = display_policy::shown_s(event.remaining_s);
+    panel_on_ = display_policy::panel_visible(event.face);
+    if (event.kind != UiEvent::Kind::kRunning) {
+        set_bright(false);
+    } else if (event.remaining_s <= theme.hurry_below_s) {
+        set_bright(true);
+    }
+    Melody sound{};
+    switch (event.kind) {
+        case UiEvent::Kind::kIdle:
+            countdown_.render(frame_, 0);
+            countdown_.set_status_icon(frame_, &fonts::kPause);
+            if (last_kind_ == UiEvent::Kind::kStarted || last_kind_ == UiEvent::Kind::kRunning ||
+                last_kind_ == UiEvent::Kind::kPaused) {
+                sound = config_.pattern(PatternId::kCancel);
+            }
+            set_led(LedEffect::kOff, 0);
+            break;
+        case UiEvent::Kind::kStarted:
+            sound = config_.pattern(PatternId::kStart);
+            [[fallthrough]];
+        case UiEvent::Kind::kRunning:
+            countdown_.render(frame_, shown_s);
+            countdown_.set_status_icon(frame_, nullptr);
+            if (event.remaining_s <= theme.hurry_below_s) {
+                set_led(LedEffect::kPulse, theme.hurry_ms);
+            } else {
+                set_led(LedEffect::kBreathe, theme.breathe_ms);
+            }
+            break;
+        case UiEvent::Kind::kPaused:
+            countdown_.render(frame_, shown_s);
+            countdown_.set_status_icon(frame_, &fonts::kPause);
+            set_led(LedEffect::kOff, 0);
+            break;
+        case UiEvent::Kind::kExpired:
+            countdown_.render(frame_, 0);
+            countdown_.set_status_icon(frame_, &fonts::kBell);
+            sound = config_.pattern(static_cast<PatternId>(preset.alarm));
+            set_led(LedEffect::kBlink, theme.alarm_blink_ms);
+            break;
+        case UiEvent::Kind::kPower:
+            // Handled above; never reaches the theme or sounds.
+            break;
+    }
+    if (sound.word_count != 0 && buzzer_ok_) {
+        // A new state supersedes whatever was still sounding.
+        buzzer_.stop();
+        buzzer_.play(sound);
+    }
+    last_kind_ = event.kind;
+    sync_panel();
+}
+
+void UiPipeline::set_led(LedEffect effect, uint32_t period_ms) {
+    // Restarting the DMA every tick would visibly reset the curve.
+    if (effect == led_.effect() && period_ms == led_period_ms_) {
+        return;
+    }
+    led_period_ms_ = period_ms;
+    if (effect == LedEffect::kOff) {
+        led_.off();
+    } else {
+        led_.play(effect, period_ms);
+    }
+}
+
+void UiPipeline::set_theme(const Theme& theme) {
+    theme_ = &theme;
+}
+
+void UiPipeline::set_power(PowerLevel level) {
+    power_ = &power_profile(level);
+    if (buzzer_ok_) {
+        buzzer_.set_volume(power_->buzzer_volume);
+    }
+    sync_panel();
+}
+
+void UiPipeline::set_bright(bool hold) {
+    // Any undimming restarts the bright period; holding it (the hurry
+    // stretch) keeps no timer at all.
+    if (dim_alarm_ > 0) {
+        cancel_alarm(dim_alarm_);
+        dim_alarm_ = 0;
+    }
+    dimmed_ = false;
+    if (!hold) {
+        dim_alarm_ = add_alarm_in_ms(display_policy::kBrightMs, &UiPipeline::on_dim_alarm, this,
+                                     true);
+    }
+    dim_pending_.store(dim_alarm_ > 0, std::memory_order_release);
+}
+
+void UiPipeline::sync_panel() {
+    if (!display_ok_ || theme_ == nullptr) {
+        return;
+    }
+    if (!panel_on_) {
+        if (sent_on_ && oled_.send_commands(kSleepCmds, sizeof(kSleepCmds))) {
+            sent_on_ = false;
+        }
+        return;
+    }
+    const uint8_t shift = power_->contrast_shift + (dimmed_ ? display_policy::kDimShift : 0);
+    uint8_t contrast = static_cast<uint8_t>(theme_->contrast >> shift);
+    contrast = contrast == 0 ? 1 : contrast;  // 0 is still lit, but barely legible
+    const bool inverted = theme_->inverted;
+    if (contrast != sent_contrast_ || inverted != sent_inverted_) {
+        const uint8_t cmds[] = {kCmdChargePump, kChargePumpOn, kCmdContrast, contrast,
+                                inverted ? kCmdInverse : kCmdNormal, kCmdDisplayOn};
+        static_assert(sizeof(cmds) == sizeof(wake_cmds_));
+        memcpy(wake_cmds_, cmds, sizeof(cmds));
+    } else if (sent_on_) {
+        return;
+    }
+    const size_t offset = sent_on_ ? kThemeCmdsOffset : 0;
+    if (oled_.send_commands(wake_cmds_ + offset, sizeof(wake_cmds_) - offset)) {
+        sent_on_ = true;
+        sent_contrast_ = contrast;
+        sent_inverted_ = inverted;
+    }
+}
+
+int64_t UiPipeline::on_dim_alarm(alarm_id_t id, void* ctx) {
+    static_cast<UiPipeline*>(ctx)->dim_fired_ = id;
+#if !TILT_HOST
+    // Runs in the timer IRQ on core 0, like on_flush_done.
+    __sev();
+#endif
+    return 0;
+}
+
+void UiPipeline::on_flush_done(bool ok, void*) {
+    trace::record(trace::Event::kFlushDone, ok);
+#if !TILT_HOST
+    // Runs in the bus IRQ on core 0; wake core 1 to push anything drawn
+    // while this flush was in flight.
+    __sev();
+#endif
+}
+
+}  // namespace tilt
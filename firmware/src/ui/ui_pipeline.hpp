@@ -0,0 +1,108 @@
+// Core 1 UI pipeline: owns DS1, BZ1 and D1.
+#pragma once
+
+#include <atomic>
+
+#include "app/ui_link.hpp"
+#include "display/countdown_view.hpp"
+#include "display/framebuffer.hpp"
+#include "features.hpp"
+#include "hal/devices.hpp"
+#include "pico/time.h"
+#include "storage/config_store.hpp"
+
+namespace tilt {
+
+/// Consumes UiEvents from core 0 and keeps the panel in sync. Nothing here
+/// can stall core 0: events arrive through a non-blocking ring, and panel
+/// pushes go through the shared bus at bulk priority. Nor does core 1 wait
+/// for the panel: the DS1 driver double-buffers, so events are drawn into
+/// frame_ at once, even mid-flush, and go out whole with the next flush.
+///
+/// The panel follows display_policy: dimmed once a state has been on screen
+/// for a while, asleep while it faces down, and woken by one cached command
+/// burst. Frames drawn while it sleeps are flushed when it wakes.
+class UiPipeline {
+public:
+    UiPipeline(UiLink& link, const ConfigStore& config, hal::Display& oled, hal::Tone& buzzer,
+               hal::Led& led)
+        : link_(link), config_(config), oled_(oled), buzzer_(buzzer), led_(led) {}
+
+#if !TILT_HOST
+    /// Launches run() on core 1. Only one pipeline may exist.
+    void launch();
+
+    /// Core 1 main loop; does not return.
+    [[noreturn]] void run();
+
+    /// First boot stage, on core 0 with only the bus up: initialises DS1
+    /// dark, pushes `cached` (a frame_cache image; nullptr draws the idle
+    /// screen) and only then lights the panel, so the first thing shown is
+    /// a whole frame. Blocks for the push, about 25 ms. init() then keeps
+    /// the panel as it is.
+    void boot(const uint8_t* cached);
+#endif
+
+    /// Brings up DS1 (unless boot() did) and BZ1 on the calling core and
+    /// draws the idle screen. run() starts with this.
+    void init();
+
+    /// The frame as last drawn. Core 0 may read it while the link is
+    /// settled, e.g. to cache the idle screen with frame_cache::store().
+    const Framebuffer& frame() const { return frame_; }
+
+    /// Core 0: true while the dim alarm is armed or has fired without core 1
+    /// applying it yet. The alarm needs the system timer, so the power
+    /// policy must not go dormant under it.
+    bool dim_pending() const { return dim_pending_.load(std::memory_order_acquire); }
+
+    /// Applies every queued event, then starts a flush if the frame changed
+    /// and none is in flight. Returns false if there was nothing to do.
+    /// run() loops on this; the host simulation calls it after each post.
+    bool step();
+
+private:
+#if !TILT_HOST
+    static void core1_entry();
+#endif
+    static void on_flush_done(bool ok, void* ctx);
+    static int64_t on_dim_alarm(alarm_id_t id, void* ctx);
+
+    void apply(const UiEvent& event);
+    void render(const UiEvent& event);
+    void set_led(LedEffect effect, uint32_t period_ms);
+    void set_theme(const Theme& theme);
+    void set_power(PowerLevel level);
+    void set_bright(bool hold);
+    void sync_panel();
+
+    UiLink& link_;
+    const ConfigStore& config_;
+    hal::Display& oled_;
+    hal::Tone& buzzer_;
+    hal::Led& led_;
+    Framebuffer frame_;
+    CountdownView countdown_;
+    bool display_ok_ = false;
+    bool buzzer_ok_ = false;
+    UiEvent::Kind last_kind_ = UiEvent::Kind::kIdle;
+    uint32_t led_period_ms_ = 0;
+    const Theme* theme_ = nullptr;
+    const PowerProfile* power_ = &power_profile(PowerLevel::kFull);
+    bool panel_on_ = true;
+    bool dimmed_ = false;
+    alarm_id_t dim_alarm_ = 0;
+    volatile alarm_id_t dim_fired_ = 0;  // set from the alarm IRQ on core 0
+    std::atomic<bool> dim_pending_{false};
+    // The last state sent to DS1. The panel comes up lit and undimmed.
+    bool sent_on_ = true;
+    uint8_t sent_contrast_ = 0;
+    bool sent_inverted_ = false;
+    // Charge pump on, contrast, normal/inverse, display on. Rebuilt when
+    // either value changes so a wake is one burst with nothing to compute.
+    uint8_t wake_cmds_[6] = {};
+
+    static UiPipeline* instance_;
+};
+
+}  // namespace tilt
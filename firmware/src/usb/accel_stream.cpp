@@ -0,0 +1,117 @@
+#include "usb/accel_stream.hpp"
+
+#include "power/clock_tree.hpp"
+#include "tusb.h"
+
+extern "C" void tud_event_hook_cb(uint8_t, uint32_t, bool) {
+    tilt::AccelStream::on_usb_event();
+}
+
+namespace tilt {
+
+AccelStream* AccelStream::instance_ = nullptr;
+
+void AccelStream::on_usb_event() {
+    AccelStream* self = instance_;
+    if (self != nullptr && self->notify_fn_ != nullptr) {
+        self->notify_fn_(self->notify_ctx_);
+    }
+}
+
+bool AccelStream::init() {
+    if (!clock_tree::start_usb_clock()) {
+        return false;
+    }
+    instance_ = this;
+    ready_ = tusb_init();
+    return ready_;
+}
+
+bool AccelStream::connected() const {
+    return ready_ && tud_mounted();
+}
+
+void AccelStream::note_lost(unsigned samples) {
+    samples_lost_ += samples;
+    const uint32_t total = lost_pending_ + samples;
+    lost_pending_ = total > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(total);
+}
+
+bool AccelStream::push(const AccelBatch& batch, bool low_power) {
+    // Nobody listening is not a loss.
+    if (batch.count == 0 || !connected()) {
+        return true;
+    }
+    const uint8_t flags = static_cast<uint8_t>((low_power ? kStreamFlagLowPower : 0) |
+                                               (batch.overrun ? kStreamFlagSensorOverrun : 0));
+    Frame* frame = &frames_[fill_];
+    // A frame covers one ODR, so a rate change closes it; an overrun is
+    // flagged on the frame whose batch followed it.
+    const bool mode_change = frame->header.count != 0 &&
+                             ((frame->header.flags ^ flags) & kStreamFlagLowPower) != 0;
+    if (!frame->ready && (mode_change || frame->header.count + batch.count > kFrameSamples)) {
+        frame->ready = true;
+        fill_ ^= 1;
+        frame = &frames_[fill_];
+    }
+    if (frame->ready) {
+        note_lost(batch.count);
+        return false;
+    }
+    int16_t* out = &frame->samples[frame->header.count * 3];
+    for (unsigned i = 0; i < batch.count; ++i) {
+        *out++ = batch.samples[i].x;
+        *out++ = batch.samples[i].y;
+        *out++ = batch.samples[i].z;
+    }
+    frame->header.count = static_cast<uint8_t>(frame->header.count + batch.count);
+    frame->header.flags = static_cast<uint8_t>(frame->header.flags | flags);
+    on_usb_event();
+    return true;
+}
+
+bool AccelStream::send(Frame& frame) {
+    const uint32_t bytes = sizeof(StreamFrameHeader) + frame.header.count * 3 * sizeof(int16_t);
+    if (tud_vendor_write_available() < bytes) {
+        return false;
+    }
+    frame.header.magic = StreamFrameHeader::kMagic;
+    frame.header.sequence = sequence_++;
+    frame.header.lost = lost_pending_;
+    lost_pending_ = 0;
+    tud_vendor_write(&frame.header, sizeof(StreamFrameHeader));
+    tud_vendor_write(frame.samples, bytes - sizeof(StreamFrameHeader));
+    tud_vendor_write_flush();
+    frame.header = StreamFrameHeader{};
+    frame.ready = false;
+    ++frames_sent_;
+    return true;
+}
+
+bool AccelStream::service() {
+    if (!ready_) {
+        return false;
+    }
+    tud_task();
+    if (!tud_mounted() || held_) {
+        return false;
+    }
+    // The other frame, if closed, is older than the one being filled.
+    Frame& older = frames_[fill_ ^ 1];
+    if (older.ready) {
+        return send(older);
+    }
+    // Nothing queued behind it: ship the partial frame now for latency.
+    Frame& current = frames_[fill_];
+    if (current.header.count != 0) {
+        current.ready = true;
+        if (send(current)) {
+            return true;
+        }
+        // Keep filling it until the endpoint drains.
+        current.ready = false;
+    }
+    return false;
+}
+
+}  // namespace tilt
@@ -0,0 +1,103 @@
+// Raw LIS3DH frames over a USB vendor bulk endpoint, for classifier tuning.
+#pragma once
+
+#include <cstdint>
+
+#include "drivers/lis3dh_fifo.hpp"
+
+namespace tilt {
+
+/// Wire format, little-endian, one USB transfer per frame.
+struct StreamFrameHeader {
+    static constexpr uint16_t kMagic = 0x5441;  // "AT"
+
+    uint16_t magic;
+    uint16_t sequence;  // +1 per frame sent; gaps mean lost frames
+    uint8_t count;      // samples that follow, x/y/z int16 each, raw counts
+    uint8_t flags;
+    uint16_t lost;      // samples dropped here since the previous frame
+};
+static_assert(sizeof(StreamFrameHeader) == 8);
+
+inline constexpr uint8_t kStreamFlagSensorOverrun = 1u << 0;  // FIFO overran at U2
+inline constexpr uint8_t kStreamFlagLowPower = 1u << 1;       // U2 in 10 Hz sleep
+
+/// Ping-pong frame buffer between the FIFO drain path and TinyUSB.
+///
+/// Batches accumulate in the fill frame; the other frame is the one being
+/// handed to the USB stack. When both are occupied the batch is counted in
+/// `lost` instead, and the next frame reports it, so the host can tell a
+/// gap from a quiet cube. Sensor-side overruns are flagged per frame. At
+/// 200 Hz the stream is ~1.3 KB/s, far below full speed, so losses mean
+/// the host stopped reading.
+///
+/// Core 0 thread context only: push() from the orientation batch tap and
+/// service() from the main loop.
+class AccelStream {
+public:
+    static constexpr unsigned kFrameSamples = AccelBatch::kCapacity;
+
+    /// Called whenever service() has work: from the USB IRQ when TinyUSB
+    /// queues an event, and from push().
+    using Notify = void (*)(void* ctx);
+
+    /// Brings up clk_usb and TinyUSB. False if the crystal is missing.
+    /// Only one stream may exist.
+    [[nodiscard]] bool init();
+
+    void set_notify(Notify fn, void* ctx) {
+        notify_ctx_ = ctx;
+        notify_fn_ = fn;
+    }
+
+    /// Queues a drained batch. Returns false if any of it was dropped.
+    bool push(const AccelBatch& batch, bool low_power);
+
+    /// Runs the USB stack and sends the oldest complete frame. Returns true
+    /// if anything was sent.
+    bool service();
+
+    /// While held, service() still runs the USB stack but sends nothing, so
+    /// another user of the endpoint has it to itself. Batches keep filling
+    /// the frames and are counted lost once both are full.
+    void hold(bool held) { held_ = held; }
+
+    /// True once a host has configured the device.
+    bool connected() const;
+
+    uint32_t frames_sent() const { return frames_sent_; }
+    uint32_t samples_lost() const { return samples_lost_; }
+
+    /// Adapts push() to OrientationEngine's batch tap signature.
+    static void tap(const AccelBatch& batch, bool low_power, void* ctx) {
+        static_cast<AccelStream*>(ctx)->push(batch, low_power);
+    }
+
+    /// TinyUSB's event hook lands here; fires the notify hook.
+    static void on_usb_event();
+
+private:
+    struct Frame {
+        StreamFrameHeader header;
+        int16_t samples[kFrameSamples * 3];
+        bool ready;
+    };
+
+    bool send(Frame& frame);
+    void note_lost(unsigned samples);
+
+    Frame frames_[2] = {};
+    unsigned fill_ = 0;
+    uint16_t sequence_ = 0;
+    uint16_t lost_pending_ = 0;
+    uint32_t frames_sent_ = 0;
+    uint32_t samples_lost_ = 0;
+    bool ready_ = false;
+    bool held_ = false;
+    Notify notify_fn_ = nullptr;
+    void* notify_ctx_ = nullptr;
+
+    static AccelStream* instance_;
+};
+
+}  // namespace tilt
@@ -0,0 +1,46 @@
+#include "usb/log_export.hpp"
+
+#include "tusb.h"
+
+namespace tilt {
+
+bool UsbLogExport::service() {
+    if (!tud_mounted()) {
+        // A half-read export is useless to the next host; drop it.
+        export_.cancel();
+        return false;
+    }
+    while (tud_vendor_available() != 0) {
+        uint8_t request = 0;
+        if (tud_vendor_read(&request, 1) == 1 && request == kRequestExport && !active()) {
+            ExportInfo info{};
+            if (info_fn_ != nullptr) {
+                info_fn_(info, info_ctx_);
+            }
+            export_.begin(info);
+        }
+    }
+    if (!active()) {
+        return false;
+    }
+    uint8_t chunk[64];
+    bool moved = false;
+    for (uint32_t room = tud_vendor_write_available(); room != 0;) {
+        const size_t n = export_.read(chunk, room < sizeof(chunk) ? room : sizeof(chunk));
+        if (n == 0) {
+            break;
+        }
+        tud_vendor_write(chunk, n);
+        room -= n;
+        moved = true;
+    }
+    tud_vendor_write_flush();
+    if (!active()) {
+        ++exports_sent_;
+        return false;
+    }
+    // With the FIFO full, the transfer-complete event brings us back.
+    return moved;
+}
+
+}  // namespace tilt
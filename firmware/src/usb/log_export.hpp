@@ -0,0 +1,49 @@
+// Session log export over the service-unit USB vendor interface.
+#pragma once
+
+#include <cstdint>
+
+#include "storage/session_export.hpp"
+
+namespace tilt {
+
+/// Answers an export request from the host with a SessionExport stream on
+/// the same bulk IN endpoint as the accelerometer stream.
+///
+/// The host writes kRequestExport to the bulk OUT endpoint and keeps
+/// reading until the kEnd item. The accelerometer stream must be held
+/// meanwhile (AccelStream::hold()), so the export goes out uninterrupted;
+/// anything the stream had already queued arrives before the magic. A
+/// few kilobytes per unit at full speed take well under a second.
+///
+/// Core 0 thread context: service() from the USB task, after
+/// AccelStream::service() has run the stack.
+class UsbLogExport {
+public:
+    static constexpr uint8_t kRequestExport = 'E';
+
+    /// Fills in the unit data when a request arrives.
+    using InfoSource = void (*)(ExportInfo& info, void* ctx);
+
+    explicit UsbLogExport(const SessionLog& log) : export_(log) {}
+
+    void set_info_source(InfoSource fn, void* ctx) {
+        info_ctx_ = ctx;
+        info_fn_ = fn;
+    }
+
+    /// Takes host requests and moves as much of a running export into the
+    /// endpoint FIFO as fits. Returns true if it should run again now.
+    bool service();
+
+    bool active() const { return export_.active(); }
+    uint32_t exports_sent() const { return exports_sent_; }
+
+private:
+    SessionExport export_;
+    uint32_t exports_sent_ = 0;
+    InfoSource info_fn_ = nullptr;
+    void* info_ctx_ = nullptr;
+};
+
+}  // namespace tilt
@@ -0,0 +1,53 @@
+#include "usb/sof_calibrator.hpp"
+
+#include "hardware/structs/usb.h"
+#include "hardware/timer.h"
+
+namespace tilt {
+
+namespace {
+
+constexpr uint32_t kFrameMask = USB_SOF_RD_BITS;
+// A little over one frame: no SOF in that time means a suspended bus.
+constexpr uint64_t kEdgeTimeoutUs = 1'500;
+// Under one frame-number wrap, with margin for a timer several percent fast.
+constexpr uint64_t kMaxGapUs = 1'900'000;
+
+}  // namespace
+
+bool SofCalibrator::sample() {
+    const uint32_t before = usb_hw->sof_rd & kFrameMask;
+    const uint64_t limit = time_us_64() + kEdgeTimeoutUs;
+    uint32_t frame = before;
+    uint64_t now = 0;
+    do {
+        frame = usb_hw->sof_rd & kFrameMask;
+        now = time_us_64();
+    } while (frame == before && now < limit);
+    if (frame == before) {
+        reset();
+        return false;
+    }
+    if (!started_ || now - last_us_ > kMaxGapUs) {
+        started_ = true;
+        first_us_ = now;
+        last_us_ = now;
+        last_frame_ = static_cast<uint16_t>(frame);
+        frames_ = 0;
+        return false;
+    }
+    frames_ += (frame - last_frame_) & kFrameMask;
+    last_frame_ = static_cast<uint16_t>(frame);
+    last_us_ = now;
+    if (frames_ < kWindowFrames) {
+        return false;
+    }
+    // Once per window, so the 64-bit division is affordable.
+    const int64_t real_us = int64_t{frames_} * 1000;
+    const int64_t ticks = static_cast<int64_t>(now - first_us_);
+    error_ppb_ = static_cast<int32_t>((ticks - real_us) * 1'000'000'000 / real_us);
+    started_ = false;
+    return true;
+}
+
+}  // namespace tilt
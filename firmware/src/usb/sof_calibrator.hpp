@@ -0,0 +1,45 @@
+// Measures the system timer against a USB host's start-of-frame clock.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt {
+
+/// A configured USB host sends a start of frame every millisecond from its
+/// crystal, which holds tens of ppm where the ROSC drifts by percent. The
+/// device latches the 11-bit frame number, so counting frames against timer
+/// ticks over a long window gives the timer's rate error.
+///
+/// Each sample busy-waits for the next frame edge (under 1 ms) so its
+/// timestamp is good to a few microseconds rather than a whole frame; over
+/// kWindowFrames that resolves well under 1 ppm. Samples must come less
+/// than one frame-number wrap (2.048 s) apart, or the window restarts.
+///
+/// Core 0 thread context, only while a host is connected.
+class SofCalibrator {
+public:
+    /// How often sample() should run.
+    static constexpr uint32_t kSamplePeriodMs = 1000;
+    /// One minute of frames.
+    static constexpr uint32_t kWindowFrames = 60'000;
+
+    /// Takes one sample. Returns true when it completes a window; the
+    /// result is then in error_ppb() and the next call starts a new one.
+    bool sample();
+
+    /// Drops a partial window, e.g. on disconnect.
+    void reset() { started_ = false; }
+
+    /// Timer rate error of the last complete window, fast when positive.
+    int32_t error_ppb() const { return error_ppb_; }
+
+private:
+    uint64_t first_us_ = 0;
+    uint64_t last_us_ = 0;
+    uint32_t frames_ = 0;
+    uint16_t last_frame_ = 0;
+    bool started_ = false;
+    int32_t error_ppb_ = 0;
+};
+
+}  // namespace tilt
@@ -0,0 +1,84 @@
+// USB descriptors: one vendor interface with a bulk IN/OUT pair.
+
+#include "pico/unique_id.h"
+#include "tusb.h"
+
+namespace {
+
+// TinyUSB's development VID/PID; service units are never sold, so they do
+// not get an allocated ID.
+constexpr uint16_t kVid = 0xCAFE;
+constexpr uint16_t kPid = 0x4011;
+
+constexpr uint8_t kEpOut = 0x01;
+constexpr uint8_t kEpIn = 0x81;
+constexpr uint16_t kEpSize = 64;
+
+enum : uint8_t { kStrLangId, kStrManufacturer, kStrProduct, kStrSerial, kStrInterface };
+
+const tusb_desc_device_t kDevice = {
+    .bLength = sizeof(tusb_desc_device_t),
+    .bDescriptorType = TUSB_DESC_DEVICE,
+    .bcdUSB = 0x0200,
+    .bDeviceClass = TUSB_CLASS_VENDOR_SPECIFIC,
+    .bDeviceSubClass = 0x00,
+    .bDeviceProtocol = 0x00,
+    .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
+    .idVendor = kVid,
+    .idProduct = kPid,
+    .bcdDevice = 0x0100,
+    .iManufacturer = kStrManufacturer,
+    .iProduct = kStrProduct,
+    .iSerialNumber = kStrSerial,
+    .bNumConfigurations = 1,
+};
+
+constexpr uint16_t kConfigLen = TUD_CONFIG_DESC_LEN + TUD_VENDOR_DESC_LEN;
+
+const uint8_t kConfiguration[] = {
+    TUD_CONFIG_DESCRIPTOR(1, 1, 0, kConfigLen, 0, 100),
+    TUD_VENDOR_DESCRIPTOR(0, kStrInterface, kEpOut, kEpIn, kEpSize),
+};
+
+const char* const kStrings[] = {
+    nullptr,
+    "ECE411 Team 13",
+    "Tilt-Timer Cube",
+    nullptr,  // the flash unique ID, so a fleet host can tell units apart
+    "Accel stream",
+};
+
+}  // namespace
+
+extern "C" const uint8_t* tud_descriptor_device_cb() {
+    return reinterpret_cast<const uint8_t*>(&kDevice);
+}
+
+extern "C" const uint8_t* tud_descriptor_configuration_cb(uint8_t) {
+    return kConfiguration;
+}
+
+extern "C" const uint16_t* tud_descriptor_string_cb(uint8_t index, uint16_t) {
+    static uint16_t desc[32];
+    uint8_t len = 0;
+    if (index == kStrLangId) {
+        desc[1] = 0x0409;
+        len = 1;
+    } else {
+        if (index >= sizeof(kStrings) / sizeof(kStrings[0])) {
+            return nullptr;
+        }
+        static char serial[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+        const char* str = kStrings[index];
+        if (index == kStrSerial) {
+            pico_get_unique_board_id_string(serial, sizeof(serial));
+            str = serial;
+        }
+        // ASCII to UTF-16LE, truncated to the descriptor buffer.
+        for (const char* c = str; *c != '\0' && len < 31; ++c) {
+            desc[1 + len++] = static_cast<uint8_t>(*c);
+        }
+    }
+    desc[0] = static_cast<uint16_t>((TUSB_DESC_STRING << 8) | (2 * len + 2));
+    return desc;
+}
@@ -0,0 +1,67 @@
+// Series approximations of libm functions usable in constant expressions.
+#pragma once
+
+namespace tilt::cmath {
+
+inline constexpr double kPi = 3.14159265358979323846;
+inline constexpr double kLn2 = 0.69314718055994530942;
+
+constexpr double exp(double x) {
+    // exp(x) = exp(x / 2^k)^(2^k) keeps the series argument small.
+    int k = 0;
+    while (x > 0.5 || x < -0.5) {
+        x /= 2;
+        ++k;
+    }
+    double term = 1;
+    double sum = 1;
+    for (int n = 1; n < 20; ++n) {
+        term *= x / n;
+        sum += term;
+    }
+    while (k-- > 0) {
+        sum *= sum;
+    }
+    return sum;
+}
+
+constexpr double log(double x) {
+    // ln(x) = 2 atanh((x - 1) / (x + 1)) after scaling x into [0.5, 2].
+    int k = 0;
+    while (x > 2) {
+        x /= 2;
+        ++k;
+    }
+    while (x < 0.5) {
+        x *= 2;
+        --k;
+    }
+    const double y = (x - 1) / (x + 1);
+    double term = y;
+    double sum = 0;
+    for (int n = 1; n < 40; n += 2) {
+        sum += term / n;
+        term *= y * y;
+    }
+    return 2 * sum + k * kLn2;
+}
+
+constexpr double pow(double base, double exponent) {
+    return base <= 0 ? 0.0 : exp(exponent * log(base));
+}
+
+constexpr double cos(double x) {
+    while (x > kPi) x -= 2 * kPi;
+    while (x < -kPi) x += 2 * kPi;
+    double term = 1;
+    double sum = 1;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double radians(double degrees) { return degrees * kPi / 180; }
+
+}  // namespace tilt::cmath
@@ -0,0 +1,55 @@
+// CRC-32 (IEEE 802.3, reflected), usable at compile time and on target.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tilt {
+
+namespace detail {
+
+constexpr std::array<uint32_t, 256> make_crc32_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            c = (c & 1) ? 0xEDB8'8320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+inline constexpr std::array<uint32_t, 256> kCrc32Table = make_crc32_table();
+
+}  // namespace detail
+
+/// Streaming CRC fed field by field in little-endian order, so a constexpr
+/// struct and its image in flash checksum identically without a byte cast.
+class Crc32 {
+public:
+    constexpr void add_u8(uint8_t v) {
+        state_ = detail::kCrc32Table[(state_ ^ v) & 0xFF] ^ (state_ >> 8);
+    }
+    constexpr void add_u16(uint16_t v) {
+        add_u8(static_cast<uint8_t>(v));
+        add_u8(static_cast<uint8_t>(v >> 8));
+    }
+    constexpr void add_u32(uint32_t v) {
+        add_u16(static_cast<uint16_t>(v));
+        add_u16(static_cast<uint16_t>(v >> 16));
+    }
+    constexpr void add(const uint8_t* data, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            add_u8(data[i]);
+        }
+    }
+
+    constexpr uint32_t value() const { return ~state_; }
+
+private:
+    uint32_t state_ = 0xFFFF'FFFFu;
+};
+
+}  // namespace tilt
@@ -0,0 +1,23 @@
+// Q15 helpers that stay within the Cortex-M0+'s 32x32->32 multiplier.
+#pragma once
+
+#include <cstdint>
+
+namespace tilt {
+
+/// Unsigned Q15 in [0, 1]; 1.0 is 32768.
+using uq15_t = uint16_t;
+
+inline constexpr uint32_t kQ15One = 1u << 15;
+
+constexpr uq15_t to_uq15(double v) {
+    return static_cast<uq15_t>(v <= 0 ? 0 : v >= 1 ? kQ15One : v * kQ15One + 0.5);
+}
+
+/// a * q without a 64-bit product: split `a` at bit 15 so both partial
+/// products fit in 32 bits for any a < 2^32 / 2^15.
+constexpr uint32_t mul_q15(uint32_t a, uq15_t q) {
+    return (a >> 15) * q + (((a & 0x7FFFu) * q) >> 15);
+}
+
+}  // namespace tilt
@@ -0,0 +1,73 @@
+// Allocation functions for TILT_NO_HEAP builds: any live use fails to link.
+//
+// These replace newlib's malloc family (pico_malloc's wrappers forward to
+// them) and the replaceable global operator new/delete. An allocation
+// function calls a symbol that is deliberately never defined; with
+// -ffunction-sections and --gc-sections only a reachable one keeps that
+// reference, so the link fails exactly when something can allocate. The
+// release functions stay harmless because they are reachable from code that
+// never runs, e.g. the deleting destructors the compiler emits.
+
+#include "features.hpp"
+
+#if TILT_NO_HEAP
+
+#include <cstddef>
+#include <new>
+
+extern "C" {
+
+/// Intentionally undefined. "undefined reference to" this means an
+/// allocation is reachable; tools/mem_report.py shows which one.
+[[noreturn]] void tilt_heap_disabled_by_TILT_NO_HEAP();
+
+void* malloc(size_t) {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void* calloc(size_t, size_t) {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void* realloc(void*, size_t) {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void free(void*) {}
+
+}  // extern "C"
+
+void* operator new(std::size_t) {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void* operator new[](std::size_t) {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void* operator new(std::size_t, const std::nothrow_t&) noexcept {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void* operator new[](std::size_t, const std::nothrow_t&) noexcept {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void* operator new(std::size_t, std::align_val_t) {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void* operator new[](std::size_t, std::align_val_t) {
+    tilt_heap_disabled_by_TILT_NO_HEAP();
+}
+
+void operator delete(void*) noexcept {}
+void operator delete[](void*) noexcept {}
+void operator delete(void*, std::size_t) noexcept {}
+void operator delete[](void*, std::size_t) noexcept {}
+void operator delete(void*, std::align_val_t) noexcept {}
+void operator delete[](void*, std::align_val_t) noexcept {}
+void operator delete(void*, std::size_t, std::align_val_t) noexcept {}
+void operator delete[](void*, std::size_t, std::align_val_t) noexcept {}
+
+#endif  // TILT_NO_HEAP
@@ -0,0 +1,61 @@
+// Lock-free single-producer/single-consumer ring for cross-core messaging.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tilt {
+
+/// Fixed-capacity ring; one core pushes, the other pops. Only plain atomic
+/// loads and stores are used (no RMW), which the Cortex-M0+ supports
+/// natively, so neither side ever spins or takes a lock.
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    /// Producer side. Returns false (and drops `item`) when full.
+    bool push(const T& item) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        slots_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side. Returns false when empty.
+    bool pop(T& item) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return false;
+        }
+        item = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /// Running totals; their difference is size(). Wrap at 2^32.
+    uint32_t produced() const { return head_.load(std::memory_order_acquire); }
+    uint32_t consumed() const { return tail_.load(std::memory_order_acquire); }
+
+    static constexpr size_t capacity() { return N; }
+
+private:
+    std::array<T, N> slots_{};
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+};
+
+}  // namespace tilt
@@ -0,0 +1,37 @@
+// LEB128 varints and zigzag signed mapping, usable at compile time.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tilt {
+
+/// Longest encoding of a 64-bit value.
+inline constexpr size_t kMaxVarintBytes = 10;
+
+/// Writes `value` seven bits per byte, low group first, bit 7 set on every
+/// byte but the last. Returns the bytes written (1..kMaxVarintBytes).
+constexpr size_t put_varint(uint8_t* out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+/// Maps small magnitudes of either sign to small unsigned values
+/// (0, -1, 1, -2 -> 0, 1, 2, 3) so deltas stay one byte.
+constexpr uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static_assert(zigzag(0) == 0 && zigzag(-1) == 1 && zigzag(1) == 2 && zigzag(-2) == 3);
+static_assert([] {
+    uint8_t out[kMaxVarintBytes] = {};
+    return put_varint(out, 300) == 2 && out[0] == 0xAC && out[1] == 0x02 &&
+           put_varint(out, UINT64_MAX) == kMaxVarintBytes;
+}());
+
+}  // namespace tilt
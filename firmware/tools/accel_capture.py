@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Capture the service-unit accelerometer stream to CSV.
+
+Reads StreamFrameHeader frames (see src/usb/accel_stream.hpp) from the
+vendor bulk IN endpoint and writes one row per sample:
+
+    frame,sample,x,y,z,low_power,overrun
+
+Lost frames (sequence gaps) and samples the firmware dropped are reported
+on stderr. Needs pyusb.
+"""
+
+import argparse
+import struct
+import sys
+
+import usb.core
+
+VID, PID = 0xCAFE, 0x4011
+EP_IN = 0x81
+MAGIC = 0x5441
+HEADER = struct.Struct("<HHBBH")
+FLAG_OVERRUN, FLAG_LOW_POWER = 0x01, 0x02
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("output", type=argparse.FileType("w"))
+    parser.add_argument("--frames", type=int, default=0, help="stop after N frames")
+    args = parser.parse_args()
+
+    dev = usb.core.find(idVendor=VID, idProduct=PID)
+    if dev is None:
+        sys.exit("no Tilt-Timer service unit found")
+    dev.set_configuration()
+
+    out = args.output
+    out.write("frame,sample,x,y,z,low_power,overrun\n")
+    expected = None
+    frames = 0
+    pending = b""
+    while not args.frames or frames < args.frames:
+        pending += bytes(dev.read(EP_IN, 512, timeout=0))
+        while len(pending) >= HEADER.size:
+            magic, seq, count, flags, lost = HEADER.unpack_from(pending)
+            if magic != MAGIC:
+                # Resynchronise on the next byte.
+                pending = pending[1:]
+                continue
+            size = HEADER.size + 6 * count
+            if len(pending) < size:
+                break
+            if expected is not None and seq != expected:
+                print(f"frames lost: {(seq - expected) & 0xFFFF}", file=sys.stderr)
+            if lost:
+                print(f"samples dropped by firmware: {lost}", file=sys.stderr)
+            expected = (seq + 1) & 0xFFFF
+            low_power = int(bool(flags & FLAG_LOW_POWER))
+            overrun = int(bool(flags & FLAG_OVERRUN))
+            for i in range(count):
+                x, y, z = struct.unpack_from("<hhh", pending, HEADER.size + 6 * i)
+                out.write(f"{frames},{i},{x},{y},{z},{low_power},{overrun}\n")
+            pending = pending[size:]
+            frames += 1
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Compare a tilt_bench capture against a stored baseline.
+
+Reads the suite's stdio (a file, or - for stdin, e.g. piped from a serial
+terminal) and checks every `bench=` line's mean cycles per unit against
+the baseline JSON. A mean more than --tolerance percent above its baseline
+is a regression; so is a benchmark that was measured in the baseline but is
+missing or skipped now, unless --allow-skipped. Exits 1 on any regression,
+2 if the capture has no complete suite.
+
+--write-baseline stores the capture as the new baseline instead. Captures
+from different clk_sys settings are not comparable in wall time but are in
+cycles, so clk_sys_hz is reported and not checked.
+"""
+
+import argparse
+import json
+import sys
+
+SUITE = "tilt_bench"
+
+
+def parse_line(line):
+    fields = {}
+    for token in line.split():
+        key, sep, value = token.partition("=")
+        if sep:
+            fields[key] = value
+    return fields
+
+
+def parse(text):
+    """Returns (header, {bench: fields}) for the last complete suite run."""
+    header, results, done = None, {}, None
+    for line in text.splitlines():
+        fields = parse_line(line.strip())
+        if fields.get("suite") == SUITE:
+            header, results = fields, {}
+        elif fields.get("suite") == "end" and header is not None:
+            done = (header, results)
+        elif "bench" in fields and header is not None:
+            results[fields["bench"]] = fields
+    return done
+
+
+def to_baseline(header, results):
+    benches = {}
+    for name, fields in results.items():
+        if fields.get("status") == "skipped":
+            continue
+        benches[name] = {
+            "unit": fields["unit"],
+            "mean": float(fields["mean"]),
+            "max": int(fields["max"]),
+        }
+    return {"suite": SUITE, "version": int(header["version"]), "benches": benches}
+
+
+def compare(baseline, header, results, tolerance, allow_skipped):
+    rows, failures = [], 0
+    if int(header["version"]) != baseline.get("version"):
+        print(f"suite version {header['version']} != baseline {baseline.get('version')}",
+              file=sys.stderr)
+        return rows, 1
+    for name, base in sorted(baseline["benches"].items()):
+        fields = results.get(name)
+        if fields is None or fields.get("status") == "skipped":
+            status = "skipped" if fields is not None else "missing"
+            bad = not (allow_skipped and fields is not None)
+            failures += bad
+            rows.append((name, base["mean"], None, None, "FAIL " + status if bad else status))
+            continue
+        mean = float(fields["mean"])
+        change = (mean - base["mean"]) * 100.0 / base["mean"] if base["mean"] else 0.0
+        bad = change > tolerance
+        failures += bad
+        rows.append((name, base["mean"], mean, change, "FAIL" if bad else "ok"))
+    for name in sorted(set(results) - set(baseline["benches"])):
+        skipped = results[name].get("status") == "skipped"
+        rows.append((name, None, None, None, "skipped" if skipped else "new"))
+    return rows, failures
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("capture", help="tilt_bench stdio capture, or - for stdin")
+    ap.add_argument("baseline", help="baseline JSON")
+    ap.add_argument("--tolerance", type=float, default=5.0,
+                    help="allowed mean increase in percent (default 5)")
+    ap.add_argument("--allow-skipped", action="store_true",
+                    help="do not fail on benchmarks skipped for missing hardware")
+    ap.add_argument("--write-baseline", action="store_true",
+                    help="store the capture as the baseline and exit")
+    args = ap.parse_args()
+
+    text = sys.stdin.read() if args.capture == "-" else open(args.capture).read()
+    run = parse(text)
+    if run is None:
+        print("no complete suite in capture", file=sys.stderr)
+        return 2
+    header, results = run
+
+    if args.write_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(to_baseline(header, results), f, indent=2, sort_keys=True)
+            f.write("\n")
+        return 0
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    rows, failures = compare(baseline, header, results, args.tolerance, args.allow_skipped)
+    print(f"clk_sys_hz={header.get('clk_sys_hz')} tolerance={args.tolerance}%")
+    for name, base, mean, change, status in rows:
+        base_s = f"{base:.2f}" if base is not None else "-"
+        mean_s = f"{mean:.2f}" if mean is not None else "-"
+        change_s = f"{change:+.1f}%" if change is not None else ""
+        print(f"{name:<18} {base_s:>12} {mean_s:>12} {change_s:>8}  {status}")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+"""Generate a board revision header from the KiCad schematic netlist.
+
+Reads a KiCad s-expression netlist, as `kicad-cli sch export netlist`
+writes, and, for each U1 GPIO, follows its net (and any series resistor)
+to the part it drives:
+
+    U2 (LIS3DH) SDI/SPC     i2c_sda_pin / i2c_scl_pin, INT1/INT2 the
+                            accel_int*_pin; SDO on GND or +3.3V picks the
+                            address
+    DS1 (OLED) D1/D0        i2c_sda_pin / i2c_scl_pin (I2C mode)
+    BZ*, LED D*             buzzer_pin, led_pin
+    ADC pin + divider       battery.* from the resistors to +BATT and GND
+
+Pins nothing drives come out as kNoPin, so their code compiles out. Rework
+not yet in the schematic is added with --set key=value (for example
+--set accel_int1_pin=6); the header names the netlist and the tool that
+wrote it, and records the command that made it. Writes
+src/board/rev<rev>.hpp, or --output.
+"""
+
+import argparse
+import re
+import sys
+
+FIELDS = [
+    "i2c_sda_pin", "i2c_scl_pin", "i2c_baud_hz", "accel_address", "oled_address",
+    "accel_int1_pin", "accel_int2_pin", "buzzer_pin", "led_pin", "profile_marker_pin",
+]
+BATTERY_FIELDS = ["pin", "adc_input", "divider_top_ohms", "divider_bottom_ohms",
+                  "reference_mv"]
+DEFAULTS = {"i2c_baud_hz": 400_000, "oled_address": 0x3C}
+HEX_FIELDS = {"accel_address", "oled_address"}
+ACCEL_ROLES = {"SDI": "i2c_sda_pin", "SDA": "i2c_sda_pin", "SPC": "i2c_scl_pin",
+               "SCL": "i2c_scl_pin", "INT1": "accel_int1_pin", "INT2": "accel_int2_pin"}
+OLED_ROLES = {"D1": "i2c_sda_pin", "D0": "i2c_scl_pin"}
+GROUND_NETS = {"GND"}
+SUPPLY_NETS = {"+3.3V", "+3V3"}
+BATTERY_NETS = {"+BATT"}
+
+
+class NetlistError(ValueError):
+    pass
+
+
+def sexpr(text):
+    """Parses one s-expression into nested lists of strings."""
+    tokens = re.findall(r'"(?:[^"\\]|\\.)*"|[()]|[^\s()"]+', text)
+    stack = [[]]
+    for token in tokens:
+        if token == "(":
+            stack.append([])
+        elif token == ")":
+            done = stack.pop()
+            stack[-1].append(done)
+        else:
+            stack[-1].append(token[1:-1] if token.startswith('"') else token)
+    return stack[0][0]
+
+
+def children(node, key):
+    return [c for c in node[1:] if isinstance(c, list) and c and c[0] == key]
+
+
+def field(node, key, default=None):
+    found = children(node, key)
+    return found[0][1] if found and len(found[0]) > 1 else default
+
+
+def ohms(value):
+    m = re.fullmatch(r"([\d.]+)\s*([kKMR]?)(\d*)", value.strip())
+    if not m:
+        raise NetlistError(f"cannot read resistor value {value!r}")
+    scale = {"": 1, "R": 1, "k": 1e3, "K": 1e3, "M": 1e6}[m.group(2)]
+    number = m.group(1) + ("." + m.group(3) if m.group(3) else "")
+    return round(float(number) * scale)
+
+
+class Netlist:
+    def __init__(self, text):
+        root = sexpr(text)
+        if root[0] != "export":
+            raise NetlistError("not a KiCad s-expression netlist")
+        self.values = {}
+        for comp in children(children(root, "components")[0], "comp"):
+            self.values[field(comp, "ref")] = field(comp, "value", "")
+        self.nets = []
+        self.net_of = {}
+        for net in children(children(root, "nets")[0], "net"):
+            name = field(net, "name", "").lstrip("/")
+            nodes = [(field(n, "ref"), field(n, "pin"), field(n, "pinfunction", ""))
+                     for n in children(net, "node")]
+            for ref, pin, _ in nodes:
+                self.net_of[(ref, pin)] = len(self.nets)
+            self.nets.append((name, nodes))
+        design = children(root, "design")
+        self.tool = field(design[0], "tool") if design else None
+        self.rev = None
+        for sheet in children(design[0], "sheet") if design else []:
+            for block in children(sheet, "title_block"):
+                self.rev = self.rev or field(block, "rev")
+
+    def pins_of(self, ref):
+        return [pin for (r, pin) in self.net_of if r == ref]
+
+    def reach(self, index):
+        """Nodes on net `index` and, through each two-pin resistor on it,
+        the net beyond. Yields (ref, pinfunction, net name, resistor ref)."""
+        name, nodes = self.nets[index]
+        for ref, pin, function in nodes:
+            if re.fullmatch(r"R\d+", ref) and len(self.pins_of(ref)) == 2:
+                other = next(p for p in self.pins_of(ref) if p != pin)
+                far_name, far_nodes = self.nets[self.net_of[(ref, other)]]
+                if not far_nodes or len(far_nodes) == 1:
+                    yield None, "", far_name, ref
+                for far_ref, _, far_function in far_nodes:
+                    if far_ref != ref:
+                        yield far_ref, far_function, far_name, ref
+            else:
+                yield ref, function, name, None
+
+
+def generate(netlist, mcu):
+    config = dict(DEFAULTS)
+    battery = {}
+
+    def assign(key, gpio, target):
+        if target.get(key, gpio) != gpio:
+            raise NetlistError(f"{key} is on GPIO{target[key]} and GPIO{gpio}")
+        target[key] = gpio
+
+    for index, (_, nodes) in enumerate(netlist.nets):
+        gpio = adc = None
+        for ref, _, function in nodes:
+            m = re.fullmatch(r"GPIO0*(\d+)(?:_ADC(\d+))?", function) if ref == mcu else None
+            if m:
+                gpio = int(m.group(1))
+                adc = int(m.group(2)) if m.group(2) is not None else None
+        if gpio is None:
+            continue
+        for ref, function, net, resistor in netlist.reach(index):
+            value = netlist.values.get(ref, "")
+            if ref == mcu:
+                continue
+            if "LIS3DH" in value and function in ACCEL_ROLES:
+                assign(ACCEL_ROLES[function], gpio, config)
+            elif re.fullmatch(r"DS\d+", ref or "") and function in OLED_ROLES:
+                assign(OLED_ROLES[function], gpio, config)
+            elif re.fullmatch(r"BZ\d+", ref or ""):
+                assign("buzzer_pin", gpio, config)
+            elif re.fullmatch(r"D\d+", ref or "") and "LED" in value.upper():
+                assign("led_pin", gpio, config)
+            elif adc is not None and resistor and net in BATTERY_NETS | GROUND_NETS:
+                assign("pin", gpio, battery)
+                battery["adc_input"] = adc
+                key = "divider_top_ohms" if net in BATTERY_NETS else "divider_bottom_ohms"
+                battery[key] = ohms(netlist.values[resistor])
+
+    for ref, value in netlist.values.items():
+        if "LIS3DH" not in value:
+            continue
+        for pin in netlist.pins_of(ref):
+            name, nodes = netlist.nets[netlist.net_of[(ref, pin)]]
+            functions = [f for r, p, f in nodes if r == ref and p == pin]
+            if "SDO" in functions and name in GROUND_NETS | SUPPLY_NETS:
+                config["accel_address"] = 0x18 if name in GROUND_NETS else 0x19
+
+    if "pin" in battery and not {"divider_top_ohms", "divider_bottom_ohms"} <= battery.keys():
+        raise NetlistError(f"GPIO{battery['pin']} has no divider to +BATT and GND")
+    return config, battery
+
+
+def apply_sets(config, battery, sets):
+    for item in sets:
+        key, sep, value = item.partition("=")
+        if not sep:
+            raise NetlistError(f"--set wants key=value, got {item!r}")
+        target, key = (battery, key[8:]) if key.startswith("battery.") else (config, key)
+        if key not in (BATTERY_FIELDS if target is battery else FIELDS):
+            raise NetlistError(f"unknown field {item.partition('=')[0]!r}")
+        target[key] = int(value, 0)
+
+
+def wrap_command(args, width=96):
+    """The command as `//` lines no wider than `width`. A trailing
+    backslash would continue the comment, so wrapped lines just indent."""
+    lines, line = [], "//   tools/board_gen.py"
+    for arg in args:
+        if len(line) + len(arg) + 1 > width:
+            lines.append(line)
+            line = "//       "
+        else:
+            line += " "
+        line += arg
+    return lines + [line]
+
+
+def render(config, battery, rev, source, tool, args):
+    ident = "kRev" + re.sub(r"\W", "_", rev)
+
+    def value(key, target):
+        if key not in target:
+            return "kNoPin" if key.endswith("pin") else None
+        return f"0x{target[key]:02X}" if key in HEX_FIELDS else f"{target[key]:_}".replace(
+            "_", "'")
+
+    missing = [k for k in ("i2c_sda_pin", "i2c_scl_pin") if k not in config]
+    if missing:
+        raise NetlistError(f"no GPIO found for {', '.join(missing)}")
+    if "accel_address" not in config:
+        raise NetlistError("U2 SDO is not tied to GND or +3.3V; --set accel_address=")
+    lines = [
+        f"// Board config for rev {rev}, generated from {source}. Do not edit; rerun",
+        *wrap_command(args),
+        *([f"// Netlist tool: {tool}"] if tool else []),
+        "#pragma once",
+        "",
+        '#include "board/board_config.hpp"',
+        "",
+        "namespace tilt::board {",
+        "",
+        f"inline constexpr BoardConfig {ident} = {{",
+        f'    .name = "rev {rev}",',
+    ]
+    lines += [f"    .{k} = {value(k, config)}," for k in FIELDS]
+    lines.append("    .battery = {")
+    lines += [f"        .{k} = {value(k, battery)}," for k in BATTERY_FIELDS
+              if value(k, battery) is not None]
+    lines += ["    },", "};", "", "}  // namespace tilt::board", ""]
+    return ident, "\n".join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("netlist", help="KiCad netlist (.net)")
+    ap.add_argument("--rev", help="revision (default: the title block's)")
+    ap.add_argument("--mcu", default="U1", help="RP2040 reference")
+    ap.add_argument("--set", action="append", default=[], metavar="KEY=VALUE",
+                    help="override or add a field, e.g. battery.pin=26 (repeatable)")
+    ap.add_argument("--output", help="header to write (default src/board/rev<rev>.hpp)")
+    args = ap.parse_args()
+
+    try:
+        with open(args.netlist) as f:
+            netlist = Netlist(f.read())
+        rev = args.rev or netlist.rev
+        if not rev:
+            raise NetlistError("the title block has no revision; pass --rev")
+        config, battery = generate(netlist, args.mcu)
+        apply_sets(config, battery, args.set)
+        ident, text = render(config, battery, rev, args.netlist, netlist.tool,
+                             sys.argv[1:])
+    except (OSError, NetlistError) as e:
+        sys.exit(f"board_gen: {e}")
+    output = args.output or "src/board/rev" + re.sub(r"\W", "_", rev) + ".hpp"
+    with open(output, "w") as f:
+        f.write(text)
+    print(f"{output}: {ident}", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""Pull session logs and power stats from Tilt-Timer service units.
+
+Sends the export request to every connected unit (or the ones named by
+--serial), reads each SessionExport stream (see
+src/storage/session_export.hpp) and writes one CSV row per session:
+
+    unit,sequence,start_s,face,outcome,planned_ms,actual_ms,battery_mv,interruptions
+
+--units writes each unit's totals and power stats as CSV; stderr gets a
+one-line summary per unit. parse() and read_export() can be imported on
+their own. Needs pyusb for USB.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import zlib
+
+VID, PID = 0xCAFE, 0x4011
+EP_OUT, EP_IN = 0x01, 0x81
+REQUEST_EXPORT = b"E"
+MAGIC = struct.pack("<I", 0x58454C54)
+VERSION = 1
+TAG_END, TAG_UNIT, TAG_POWER, TAG_SESSION = 0, 1, 2, 3
+OUTCOMES = ("completed", "cancelled", "superseded")
+POWER_STATES = ("run", "sleep", "dormant")
+
+
+class ExportError(ValueError):
+    pass
+
+
+class Incomplete(ExportError):
+    """The stream ends early; more bytes may complete it."""
+
+
+def varint(data, pos):
+    value, shift = 0, 0
+    while True:
+        if pos >= len(data):
+            raise Incomplete("truncated varint")
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return value, pos
+        shift += 7
+
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def items(data, pos):
+    """Yields (tag, payload, offset) for each item up to and including the
+    end item, offset being where the payload starts in `data`."""
+    while True:
+        tag, pos = varint(data, pos)
+        length, pos = varint(data, pos)
+        if pos + length > len(data):
+            raise Incomplete("truncated item")
+        yield tag, data[pos:pos + length], pos
+        pos += length
+        if tag == TAG_END:
+            return
+
+
+def parse(data):
+    """Decodes one export. Bytes before the magic (accelerometer frames
+    still in flight) are skipped. Returns a dict with 'unit', 'power' and
+    'sessions'; raises ExportError on a bad or incomplete stream."""
+    base = data.find(MAGIC)
+    if base < 0:
+        raise Incomplete("export magic not found")
+    if len(data) <= base + 4:
+        raise Incomplete("truncated header")
+    version = data[base + 4]
+    if version != VERSION:
+        raise ExportError(f"unsupported export version {version}")
+    out = {"unit": {}, "power": {}, "sessions": []}
+    prev = {"sequence": 0, "start_s": 0, "planned_ms": 0, "battery_mv": 0}
+    for tag, p, offset in items(data, base + 5):
+        if tag == TAG_UNIT:
+            unit = {"board_id": p[:8].hex()}
+            pos = 8
+            for name in ("awake_s", "battery_mv", "power_level", "next_sequence", "dropped"):
+                unit[name], pos = varint(p, pos)
+            out["unit"] = unit
+        elif tag == TAG_POWER:
+            pos = 0
+            for state in POWER_STATES:
+                stats = {}
+                for name in ("residency_ms", "entries", "charge_nah"):
+                    stats[name], pos = varint(p, pos)
+                out["power"][state] = stats
+        elif tag == TAG_SESSION:
+            delta, pos = varint(p, 0)
+            s = {"sequence": prev["sequence"] + delta}
+            for name in ("start_s", "planned_ms"):
+                value, pos = varint(p, pos)
+                s[name] = prev[name] + unzigzag(value)
+            s["actual_ms"], pos = varint(p, pos)
+            value, pos = varint(p, pos)
+            s["battery_mv"] = prev["battery_mv"] + unzigzag(value)
+            packed = p[pos]
+            s["face"] = packed & 0x0F
+            s["outcome"] = OUTCOMES[packed >> 4] if packed >> 4 < len(OUTCOMES) else packed >> 4
+            s["interruptions"], _ = varint(p, pos + 1)
+            out["sessions"].append(s)
+            prev = s
+        elif tag == TAG_END:
+            count, pos = varint(p, 0)
+            (crc,) = struct.unpack_from("<I", p, pos)
+            if zlib.crc32(data[base:offset + pos]) != crc:
+                raise ExportError("export CRC mismatch")
+            if count != len(out["sessions"]):
+                raise ExportError(f"expected {count} sessions, got {len(out['sessions'])}")
+        # Unknown tags are newer items; skip them.
+    return out
+
+
+def read_export(dev, timeout_ms=2000):
+    """Requests and reads one export from a pyusb device."""
+    dev.write(EP_OUT, REQUEST_EXPORT, timeout=timeout_ms)
+    data = b""
+    while True:
+        # One packet per read, so a stream that ends on a full packet does
+        # not leave the read waiting for a short one.
+        data += bytes(dev.read(EP_IN, 64, timeout=timeout_ms))
+        try:
+            return parse(data)
+        except Incomplete:
+            pass
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("output", type=argparse.FileType("w"), help="sessions CSV")
+    ap.add_argument("--units", type=argparse.FileType("w"), help="unit and power CSV")
+    ap.add_argument("--serial", action="append", help="only this USB serial (repeatable)")
+    args = ap.parse_args()
+
+    import usb.core
+    import usb.util
+
+    devices = list(usb.core.find(find_all=True, idVendor=VID, idProduct=PID))
+    if args.serial:
+        devices = [d for d in devices if usb.util.get_string(d, d.iSerialNumber) in args.serial]
+    if not devices:
+        sys.exit("no Tilt-Timer service unit found")
+
+    sessions = csv.writer(args.output)
+    sessions.writerow(["unit", "sequence", "start_s", "face", "outcome", "planned_ms",
+                       "actual_ms", "battery_mv", "interruptions"])
+    units = csv.writer(args.units) if args.units else None
+    unit_fields = ["awake_s", "battery_mv", "power_level", "next_sequence", "dropped"]
+    power_fields = [f"{s}_{n}" for s in POWER_STATES
+                    for n in ("residency_ms", "entries", "charge_nah")]
+    if units:
+        units.writerow(["unit"] + unit_fields + power_fields)
+    failed = 0
+    for dev in devices:
+        dev.set_configuration()
+        try:
+            export = read_export(dev)
+        except (ExportError, usb.core.USBError) as e:
+            print(f"{dev.bus}-{dev.address}: {e}", file=sys.stderr)
+            failed += 1
+            continue
+        unit = export["unit"]
+        for s in export["sessions"]:
+            sessions.writerow([unit["board_id"], s["sequence"], s["start_s"], s["face"],
+                               s["outcome"], s["planned_ms"], s["actual_ms"], s["battery_mv"],
+                               s["interruptions"]])
+        power = [export["power"][s][n] for s in POWER_STATES
+                 for n in ("residency_ms", "entries", "charge_nah")]
+        if units:
+            units.writerow([unit["board_id"]] + [unit[f] for f in unit_fields] + power)
+        print(f"{unit['board_id']}: {len(export['sessions'])} sessions, "
+              f"{unit['dropped']} dropped", file=sys.stderr)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
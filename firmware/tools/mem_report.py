@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""Worst-case RAM report from a GNU ld map file.
+
+Reads the map the link writes (pico_add_extra_outputs produces
+<target>.elf.map) and prints per-region usage, RAM by subsystem (the
+directory under src/ an object came from) and the largest objects. Every
+buffer in the firmware is static, so data + bss + the reserved stacks is
+the worst case; the heap reservation is listed separately.
+
+Allocation functions that survived --gc-sections are listed with the
+objects that reference them (link with -Wl,--cref for that table; without
+it only archive pulls are known). With --no-heap that is an error, as are
+totals over --ram-budget. Needs c++filt on PATH for readable symbol names.
+"""
+
+import argparse
+import json
+import re
+import shutil
+import subprocess
+import sys
+
+# Live sections with these names mean the heap is reachable.
+HEAP_FUNCTIONS = re.compile(
+    r"^(?:__wrap_)?(?:_?malloc(?:_r)?|_?calloc(?:_r)?|_?realloc(?:_r)?|_sbrk(?:_r)?|"
+    r"_Zn[wa][jm].*)$"
+)
+
+SUBSYSTEM = re.compile(r"(?:^|/)src/(?:(\w+)/)?(\w+)\.c(?:pp)?\.o(?:bj)?$")
+ARCHIVE = re.compile(r"lib(\w+)\.a\(")
+HEX = r"0x[0-9a-fA-F]+"
+INPUT_LINE = re.compile(rf"^ (\S+)?\s+({HEX})\s+({HEX})\s+(\S.*)$")
+OUTPUT_LINE = re.compile(rf"^(\.\S+|\S+)?\s+({HEX})\s+({HEX})(?:\s+load address ({HEX}))?\s*$")
+
+
+def parse(text):
+    lines = text.splitlines()
+    regions, pulled, outputs, inputs, refs = [], {}, [], [], {}
+    mode = None
+    symbol = None
+    definer = False
+    column = None
+    carry = None
+    member = None
+    for line in lines:
+        if line.startswith("Archive member included"):
+            mode = "archive"
+            continue
+        if line.startswith("Discarded input sections"):
+            mode = "discarded"
+            continue
+        if line.startswith("Memory Configuration"):
+            mode = "memory"
+            continue
+        if line.startswith("Linker script and memory map"):
+            mode = "map"
+            continue
+        if line.startswith("Cross Reference Table"):
+            mode = "cref"
+            continue
+        if mode == "cref":
+            # "symbol  defining-file", then one line per referrer. Symbols
+            # are demangled and may contain spaces, so split on the column.
+            if line.startswith("Symbol"):
+                column = line.index("File")
+                continue
+            if not line.strip() or column is None:
+                continue
+            name, path = line[:column].strip(), line[column:].strip()
+            if name:
+                symbol = name
+                refs[symbol] = []
+                # A long name pushes the defining file onto the next line.
+                definer = bool(path)
+            elif symbol is not None:
+                if definer:
+                    refs[symbol].append(path)
+                definer = True
+        elif mode == "archive":
+            if line and not line[0].isspace():
+                member = line.strip()
+            elif member and line.strip():
+                pulled.setdefault(member, []).append(line.strip())
+        elif mode == "memory":
+            fields = line.split()
+            if len(fields) >= 3 and fields[1].startswith("0x") and fields[0] != "*default*":
+                attrs = fields[3] if len(fields) > 3 else ""
+                regions.append(
+                    {"name": fields[0], "origin": int(fields[1], 16),
+                     "length": int(fields[2], 16), "writable": "w" in attrs}
+                )
+        elif mode == "map":
+            # Long section names put the address on the following line.
+            if carry is not None and line.startswith("  "):
+                line = carry + line
+            carry = None
+            if re.fullmatch(r"\S+", line) or re.fullmatch(r" \S+", line):
+                carry = line
+                continue
+            if line.startswith(" *") or line.startswith(" LOAD"):
+                continue
+            m = OUTPUT_LINE.match(line)
+            if m and m.group(1) and not line.startswith(" "):
+                outputs.append(
+                    {"name": m.group(1), "addr": int(m.group(2), 16),
+                     "size": int(m.group(3), 16), "load": m.group(4)}
+                )
+                continue
+            m = INPUT_LINE.match(line)
+            if m and m.group(1) and outputs and not m.group(4).startswith("0x"):
+                inputs.append(
+                    {"output": outputs[-1]["name"], "name": m.group(1),
+                     "addr": int(m.group(2), 16), "size": int(m.group(3), 16),
+                     "file": m.group(4).strip()}
+                )
+    return regions, pulled, outputs, inputs, refs
+
+
+def region_of(addr, regions):
+    for r in regions:
+        if r["origin"] <= addr < r["origin"] + r["length"]:
+            return r
+    return None
+
+
+def kind_of(output_name):
+    if output_name.startswith(".heap"):
+        return "heap"
+    if output_name.startswith(".stack"):
+        return "stack"
+    return "static"
+
+
+def subsystem_of(path):
+    m = SUBSYSTEM.search(path)
+    if m:
+        return m.group(1) or m.group(2)
+    m = ARCHIVE.search(path)
+    if m:
+        return "lib" + m.group(1)
+    if "pico-sdk" in path or "pico_" in path:
+        return "sdk"
+    return "other"
+
+
+def demangle(names):
+    tool = shutil.which("c++filt") or shutil.which("arm-none-eabi-c++filt")
+    if not tool or not names:
+        return {n: n for n in names}
+    out = subprocess.run([tool], input="\n".join(names), capture_output=True, text=True).stdout
+    return dict(zip(names, out.splitlines()))
+
+
+def symbol_of(section_name, path):
+    # -fdata-sections names each object's section after its symbol.
+    for prefix in (".bss.", ".data.", ".sbss.", ".sdata.", ".uninitialized_data.",
+                   ".time_critical."):
+        if section_name.startswith(prefix):
+            return section_name[len(prefix):]
+    return path.rsplit("/", 1)[-1] + ":" + section_name
+
+
+def heap_users(inputs, pulled, refs):
+    found = []
+    for s in inputs:
+        if not s["name"].startswith(".text."):
+            continue
+        fn = s["name"][len(".text."):]
+        if not HEAP_FUNCTIONS.match(fn):
+            continue
+        found.append({"function": fn, "file": s["file"]})
+    # The cross-reference table uses demangled names.
+    names = demangle([h["function"] for h in found])
+    for h in found:
+        h["function"] = names.get(h["function"], h["function"])
+        h["referenced_by"] = refs.get(h["function"]) or pulled.get(h["file"], [])
+    return found
+
+
+def report(text, top):
+    regions, pulled, outputs, inputs, refs = parse(text)
+    ram = [r for r in regions if r["writable"]]
+
+    usage = {r["name"]: 0 for r in regions}
+    totals = {"static": 0, "stack": 0, "heap": 0}
+    for o in outputs:
+        r = region_of(o["addr"], regions)
+        if r is None or o["size"] == 0:
+            continue
+        usage[r["name"]] += o["size"]
+        if r["writable"]:
+            totals[kind_of(o["name"])] += o["size"]
+        # Initialised data occupies FLASH too, as its load image.
+        load = None
+        if o["load"] and kind_of(o["name"]) == "static" and not o["name"].startswith(".bss"):
+            load = region_of(int(o["load"], 16), regions)
+        if load is not None and load is not r:
+            usage[load["name"]] += o["size"]
+
+    objects = []
+    subsystems = {}
+    for s in inputs:
+        r = region_of(s["addr"], ram)
+        if r is None or s["size"] == 0 or kind_of(s["output"]) != "static":
+            continue
+        sub = subsystem_of(s["file"])
+        subsystems[sub] = subsystems.get(sub, 0) + s["size"]
+        objects.append({"symbol": symbol_of(s["name"], s["file"]), "size": s["size"],
+                        "addr": s["addr"], "subsystem": sub, "region": r["name"]})
+    objects.sort(key=lambda o: -o["size"])
+    objects = objects[:top]
+    names = demangle([o["symbol"] for o in objects])
+    for o in objects:
+        o["symbol"] = names.get(o["symbol"], o["symbol"])
+
+    return {
+        "regions": [
+            {"name": r["name"], "used": usage[r["name"]], "size": r["length"]} for r in regions
+        ],
+        "static_bytes": totals["static"],
+        "stack_bytes": totals["stack"],
+        "heap_bytes": totals["heap"],
+        "subsystems": dict(sorted(subsystems.items(), key=lambda kv: -kv[1])),
+        "objects": objects,
+        "heap_functions": heap_users(inputs, pulled, refs),
+    }
+
+
+def print_text(rep):
+    print(f"{'region':<12}{'used':>10}{'size':>10}{'%':>7}")
+    for r in rep["regions"]:
+        pct = 100.0 * r["used"] / r["size"] if r["size"] else 0.0
+        print(f"{r['name']:<12}{r['used']:>10}{r['size']:>10}{pct:>6.1f}%")
+    worst = rep["static_bytes"] + rep["stack_bytes"]
+    print()
+    print(f"data+bss {rep['static_bytes']}  stacks {rep['stack_bytes']}  "
+          f"worst case {worst}  heap reserve {rep['heap_bytes']}")
+    print()
+    print("by subsystem:")
+    for name, size in rep["subsystems"].items():
+        print(f"  {name:<14}{size:>8}")
+    print()
+    print("largest objects:")
+    for o in rep["objects"]:
+        print(f"  {o['size']:>8}  {o['subsystem']:<12} {o['symbol']}")
+    print()
+    if rep["heap_functions"]:
+        print("heap reachable:")
+        for h in rep["heap_functions"]:
+            why = "; ".join(h["referenced_by"]) or h["file"]
+            print(f"  {h['function']}  ({why})")
+    else:
+        print("heap: unreachable")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", type=argparse.FileType("r"))
+    parser.add_argument("--json", action="store_true", help="machine-readable output")
+    parser.add_argument("--top", type=int, default=15, help="largest objects to list")
+    parser.add_argument("--no-heap", action="store_true",
+                        help="fail if any allocation function is linked in")
+    parser.add_argument("--ram-budget", type=int, default=0,
+                        help="fail if data+bss+stacks exceed this many bytes")
+    args = parser.parse_args()
+
+    rep = report(args.map.read(), args.top)
+    if args.json:
+        json.dump(rep, sys.stdout, indent=2)
+        print()
+    else:
+        print_text(rep)
+
+    failed = False
+    if args.no_heap and rep["heap_functions"]:
+        print("error: allocation functions linked into a no-heap build", file=sys.stderr)
+        failed = True
+    worst = rep["static_bytes"] + rep["stack_bytes"]
+    if args.ram_budget and worst > args.ram_budget:
+        print(f"error: worst-case RAM {worst} exceeds budget {args.ram_budget}", file=sys.stderr)
+        failed = True
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
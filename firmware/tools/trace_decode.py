@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Decode a TILT_TRACE ring dump into a merged two-core timeline.
+
+Input is either a raw binary memory dump that contains the trace buffer
+(e.g. `dump_image` over SWD; the image is located by its magic, so any
+range around `tilt::trace::buffer` works) or a stdio capture with the hex
+lines between `trace=begin` and `trace=end` (the last complete one is
+used). Event names come from the Event enum in src/diag/trace.hpp, so new
+ids decode without touching this script.
+
+Prints one line per record, oldest first, with the time relative to the
+first record and the core. *Start/*End, *Start/*Done and *Enter/*Exit
+pairs become spans; --summary prints per-span counts and durations,
+--chrome writes a Chrome/Perfetto trace JSON file.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+MAGIC = 0x43525454
+VERSION = 1
+HEADER = struct.Struct("<IHBBI")
+RECORD = struct.Struct("<II")
+HERE = os.path.dirname(os.path.abspath(__file__))
+ENUM_HEADER = os.path.join(HERE, "..", "src", "diag", "trace.hpp")
+PAIRS = (("Start", "End"), ("Start", "Done"), ("Enter", "Exit"))
+
+
+def load_events(path):
+    text = open(path).read()
+    body = re.search(r"enum class Event[^{]*\{(.*?)\};", text, re.S).group(1)
+    return {int(v, 0): name for name, v in re.findall(r"k(\w+)\s*=\s*(\w+)", body)}
+
+
+def extract_image(data):
+    """Returns the bytes from the magic on, from either input format."""
+    if data.lstrip().startswith(b"trace=") or b"trace=begin" in data[:4096]:
+        lines, image = None, None
+        for line in data.decode(errors="replace").splitlines():
+            line = line.strip()
+            if line.startswith("trace=begin"):
+                lines = []
+            elif line.startswith("trace=end") and lines is not None:
+                image, lines = bytes.fromhex("".join(lines)), None
+            elif lines is not None and line:
+                lines.append(line)
+        if image is None:
+            raise ValueError("no complete trace=begin/trace=end block")
+        data = image
+    offset = data.find(struct.pack("<I", MAGIC))
+    if offset < 0:
+        raise ValueError("trace magic not found")
+    return data[offset:]
+
+
+def parse(image):
+    magic, version, record_bytes, cores, depth = HEADER.unpack_from(image, 0)
+    if version != VERSION or record_bytes != RECORD.size:
+        raise ValueError(f"unsupported trace version {version} record {record_bytes}")
+    heads = struct.unpack_from(f"<{cores}I", image, HEADER.size)
+    base = HEADER.size + 4 * cores
+    if len(image) < base + cores * depth * RECORD.size:
+        raise ValueError("dump is shorter than the trace buffer")
+    records, latest = [], []
+    for core in range(cores):
+        head = heads[core]
+        count = min(head, depth)
+        ring = base + core * depth * RECORD.size
+        for seq in range(head - count, head):
+            time_us, info = RECORD.unpack_from(image, ring + (seq % depth) * RECORD.size)
+            if (info >> 24) != core:
+                continue  # overwritten while the dump was taken
+            records.append([time_us, core, (info >> 16) & 0xFF, info & 0xFFFF])
+        if count:
+            latest.append(records[-1][0])
+    return unwrap(records, latest)
+
+
+def signed(delta):
+    delta &= 0xFFFFFFFF
+    return delta - (1 << 32) if delta & 0x80000000 else delta
+
+
+def unwrap(records, latest):
+    """Orders by the 32-bit timer, which wraps every 71 minutes; each
+    core's last record is its newest, so the later of those is the end."""
+    if not records:
+        return records
+    newest = latest[0] + max(signed(t - latest[0]) for t in latest)
+    for r in records:
+        r[0] = newest - ((newest - r[0]) & 0xFFFFFFFF)
+    records.sort(key=lambda r: r[0])
+    return records
+
+
+def pair_table(events):
+    """Maps each end event to (start event, span name)."""
+    by_name = {name: value for value, name in events.items()}
+    table = {}
+    for value, name in events.items():
+        for start, end in PAIRS:
+            if name.endswith(end) and name[: -len(end)] + start in by_name:
+                stem = name[: -len(end)]
+                table[value] = (by_name[stem + start], stem)
+    return table
+
+
+def spans(records, events):
+    """Pairs begin/end records into (name, core, start, dur, arg). A pair
+    normally shares a core; a flush starts on core 1 and completes in the
+    bus IRQ on core 0, so an unmatched end takes the other core's begin."""
+    table = pair_table(events)
+    starts = {start for start, _ in table.values()}
+    opens, out = {}, []
+    for time_us, core, event, arg in records:
+        if event in starts:
+            opens[(core, event)] = (time_us, core, arg)
+        elif event in table:
+            start, name = table[event]
+            begin = opens.pop((core, start), None)
+            if begin is None:
+                other = [k for k in opens if k[1] == start]
+                begin = opens.pop(other[0]) if other else None
+            if begin is not None:
+                out.append((name, begin[1], begin[0], time_us - begin[0], begin[2]))
+    return out
+
+
+def summarize(span_list):
+    groups = {}
+    for name, core, _, dur, _ in span_list:
+        groups.setdefault((name, core), []).append(dur)
+    print(f"{'span':<14} {'core':>4} {'n':>6} {'mean_us':>9} {'min_us':>7} {'max_us':>7}")
+    for (name, core), durs in sorted(groups.items()):
+        print(f"{name:<14} {core:>4} {len(durs):>6} {sum(durs) / len(durs):>9.1f} "
+              f"{min(durs):>7} {max(durs):>7}")
+
+
+def chrome(records, span_list, events, path, t0):
+    out = []
+    for name, core, start, dur, arg in span_list:
+        out.append({"name": name, "ph": "X", "pid": 0, "tid": core, "ts": start - t0,
+                    "dur": dur, "args": {"arg": arg}})
+    table = pair_table(events)
+    paired = set(table) | {start for start, _ in table.values()}
+    for time_us, core, event, arg in records:
+        if event not in paired:
+            out.append({"name": events.get(event, f"event{event}"), "ph": "i", "s": "t",
+                        "pid": 0, "tid": core, "ts": time_us - t0, "args": {"arg": arg}})
+    with open(path, "w") as f:
+        json.dump({"traceEvents": out, "displayTimeUnit": "ms"}, f)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("dump", help="raw memory dump or stdio capture, or - for stdin")
+    ap.add_argument("--events", default=ENUM_HEADER,
+                    help="header with the Event enum (default src/diag/trace.hpp)")
+    ap.add_argument("--summary", action="store_true", help="print span statistics only")
+    ap.add_argument("--chrome", metavar="JSON", help="also write a Chrome trace file")
+    args = ap.parse_args()
+
+    data = sys.stdin.buffer.read() if args.dump == "-" else open(args.dump, "rb").read()
+    events = load_events(args.events)
+    try:
+        records = parse(extract_image(data))
+    except (ValueError, struct.error) as e:
+        print(e, file=sys.stderr)
+        return 2
+    if not records:
+        print("trace is empty", file=sys.stderr)
+        return 1
+    t0 = records[0][0]
+    span_list = spans(records, events)
+    if args.summary:
+        summarize(span_list)
+    else:
+        for time_us, core, event, arg in records:
+            name = events.get(event, f"event{event}")
+            print(f"{time_us - t0:>10} us  core{core}  {name:<12} {arg}")
+    if args.chrome:
+        chrome(records, span_list, events, args.chrome, t0)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())